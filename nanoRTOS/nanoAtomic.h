@@ -0,0 +1,96 @@
+/*
+ * nanoAtomic.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ */
+
+#ifndef NANOATOMIC_H_
+#define NANOATOMIC_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+/*
+ * Atomic primitives used by the lock free queues and the ready flags.
+ * By default the GCC/Clang __atomic builtins are used, on Cortex-M3 and above
+ * they compile to LDREX/STREX sequences.
+ * A port without native atomics (e.g. Cortex-M0) can override each macro
+ * before this header is included, typically by wrapping the operation with
+ * nOS_CRITICAL_SECTION.
+ * Interface:
+ * T   nOS_ATOMIC_LOAD(T* ptr);
+ * T   nOS_ATOMIC_LOAD_RELAXED(T* ptr);
+ * void nOS_ATOMIC_STORE(T* ptr, T value);
+ * void nOS_ATOMIC_STORE_RELAXED(T* ptr, T value);
+ * T   nOS_ATOMIC_FETCH_OR(T* ptr, T value);
+ * T   nOS_ATOMIC_FETCH_AND(T* ptr, T value);
+ * T   nOS_ATOMIC_FETCH_ADD(T* ptr, T value);
+ * T   nOS_ATOMIC_FETCH_SUB(T* ptr, T value);
+ * int nOS_ATOMIC_CAS(T* ptr, T* expected, T desired);
+ * void nOS_ATOMIC_RAISE(T* ptr, T value);
+ * void nOS_SPIN_LOCK(uint32_t* lock);
+ * void nOS_SPIN_UNLOCK(uint32_t* lock);
+ * The spin lock guards the per core task queues of nOS_SMP_CORES, a port may
+ * map it on a hardware spin lock instead.
+ * nOS_ATOMIC_RAISE is built on nOS_ATOMIC_CAS, it raises a high water mark
+ * that writers of any context race on and never lowers it.
+ */
+
+#ifndef nOS_ATOMIC_LOAD
+#define nOS_ATOMIC_LOAD(ptr)                __atomic_load_n ((ptr), __ATOMIC_ACQUIRE)
+#endif
+#ifndef nOS_ATOMIC_LOAD_RELAXED
+#define nOS_ATOMIC_LOAD_RELAXED(ptr)        __atomic_load_n ((ptr), __ATOMIC_RELAXED)
+#endif
+#ifndef nOS_ATOMIC_STORE
+#define nOS_ATOMIC_STORE(ptr, value)        __atomic_store_n ((ptr), (value), __ATOMIC_RELEASE)
+#endif
+#ifndef nOS_ATOMIC_STORE_RELAXED
+#define nOS_ATOMIC_STORE_RELAXED(ptr, value) __atomic_store_n ((ptr), (value), __ATOMIC_RELAXED)
+#endif
+#ifndef nOS_ATOMIC_FETCH_OR
+#define nOS_ATOMIC_FETCH_OR(ptr, value)     __atomic_fetch_or ((ptr), (value), __ATOMIC_ACQ_REL)
+#endif
+#ifndef nOS_ATOMIC_FETCH_AND
+#define nOS_ATOMIC_FETCH_AND(ptr, value)    __atomic_fetch_and ((ptr), (value), __ATOMIC_ACQ_REL)
+#endif
+#ifndef nOS_ATOMIC_FETCH_ADD
+#define nOS_ATOMIC_FETCH_ADD(ptr, value)    __atomic_fetch_add ((ptr), (value), __ATOMIC_ACQ_REL)
+#endif
+#ifndef nOS_ATOMIC_FETCH_SUB
+#define nOS_ATOMIC_FETCH_SUB(ptr, value)    __atomic_fetch_sub ((ptr), (value), __ATOMIC_ACQ_REL)
+#endif
+/* Returns non zero on success, on failure *expected is updated with the current value */
+#ifndef nOS_ATOMIC_CAS
+#define nOS_ATOMIC_CAS(ptr, expected, desired)\
+    __atomic_compare_exchange_n ((ptr), (expected), (desired), 0,\
+                                 __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#endif
+#ifndef nOS_SPIN_LOCK
+#define nOS_SPIN_LOCK(lock)\
+    while (__atomic_exchange_n ((lock), 1, __ATOMIC_ACQUIRE))\
+    {\
+        while (__atomic_load_n ((lock), __ATOMIC_RELAXED))\
+        {\
+        }\
+    }
+#endif
+#ifndef nOS_SPIN_UNLOCK
+#define nOS_SPIN_UNLOCK(lock)               __atomic_store_n ((lock), 0, __ATOMIC_RELEASE)
+#endif
+#ifndef nOS_ATOMIC_RAISE
+#define nOS_ATOMIC_RAISE(ptr, value)\
+    do\
+    {\
+        __typeof__(*(ptr)) raise_mark_ = nOS_ATOMIC_LOAD_RELAXED(ptr);\
+        while (((value) > raise_mark_)\
+                && !nOS_ATOMIC_CAS((ptr), &raise_mark_, (value)))\
+        {\
+        }\
+    } while (0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* NANOATOMIC_H_ */
@@ -0,0 +1,256 @@
+/**
+ * @file nanoBudget.c
+ * @author Ehud Frank
+ * Description Optional execution budgets of the callbacks, see nanoBudget.h.
+ * @date 17 Oct 2026
+ */
+
+#include "nanoBudget.h"
+#include "string.h"
+
+#if nOS_BUDGET
+
+/**
+ * The measurements of a callback
+ */
+typedef struct
+{
+    nOS_task_callback_t callback_; // NULL while the slot is free
+    uint32_t budget_;
+    uint32_t max_;
+    uint64_t total_; // The sum of the runs
+    uint32_t count_;
+    uint32_t overruns_;
+    nOS_prio_t prio_;
+} budget_slot_t;
+
+static budget_slot_t budget_slots_[nOS_BUDGET_SLOTS];
+static uint32_t budget_untracked_;
+// The cycles of all the runs so far, a run leaves out the ones nested in it
+static uint32_t budget_runs_;
+
+/**
+ * @brief A function to find the slot of a callback, called with the
+ * interrupts locked. The slots are never freed but by nOS_budget_init, the
+ * probing stops at the first free slot.
+ * @param claim- 1 to take a free slot for a callback not measured yet
+ * @return The slot, NULL if the callback has none
+ */
+static budget_slot_t *budget_find (nOS_task_callback_t callback, int claim);
+/**
+ * @brief A function to copy the measurements of a slot out
+ */
+static void budget_copy (const budget_slot_t *slot, nOS_budget_stats_t *stats);
+/**
+ * @brief A function to compare two callbacks for the report
+ * @return 1 if a is a worse offender than b
+ */
+static int budget_worse (const nOS_budget_stats_t *a,
+                         const nOS_budget_stats_t *b);
+
+nOS_err_t nOS_budget_set (nOS_task_callback_t callback, uint32_t cycles)
+{
+    budget_slot_t *slot;
+
+    if (NULL == callback)
+    {
+        return nOS_TASK_ERR;
+    }
+    nOS_INTERRUPTS_LOCK();
+    slot = budget_find (callback, 1);
+    if (NULL != slot)
+    {
+        slot->budget_ = cycles;
+    }
+    nOS_INTERRUPTS_UNLOCK();
+
+    return (NULL != slot) ? nOS_OK : nOS_BUDGET_ERR;
+}
+
+nOS_err_t nOS_budget_get (nOS_task_callback_t callback,
+                          nOS_budget_stats_t *stats)
+{
+    budget_slot_t *slot;
+
+    nOS_INTERRUPTS_LOCK();
+    slot = budget_find (callback, 0);
+    if (NULL != slot)
+    {
+        budget_copy (slot, stats);
+    }
+    nOS_INTERRUPTS_UNLOCK();
+
+    return (NULL != slot) ? nOS_OK : nOS_BUDGET_ERR;
+}
+
+uint16_t nOS_budget_report (nOS_budget_stats_t *worst, uint16_t n)
+{
+    nOS_budget_stats_t stats;
+    uint16_t count = 0;
+    uint16_t i;
+    uint16_t j;
+
+    for (i = 0; i < nOS_BUDGET_SLOTS; i++)
+    {
+        // One slot at a time, the interrupts are not locked for the sort
+        nOS_INTERRUPTS_LOCK();
+        stats.callback_ = budget_slots_[i].callback_;
+        if (NULL != stats.callback_)
+        {
+            budget_copy (&budget_slots_[i], &stats);
+        }
+        nOS_INTERRUPTS_UNLOCK();
+        if (NULL == stats.callback_)
+        {
+            continue;
+        }
+        // Insert it in order, the last one falls off a full list
+        for (j = count; (j > 0) && budget_worse (&stats, &worst[j - 1]); j--)
+        {
+            if (j < n)
+            {
+                worst[j] = worst[j - 1];
+            }
+        }
+        if (j < n)
+        {
+            worst[j] = stats;
+            if (count < n)
+            {
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+uint32_t nOS_budget_untracked (void)
+{
+    return budget_untracked_;
+}
+
+void nOS_budget_reset (void)
+{
+    uint16_t i;
+
+    nOS_INTERRUPTS_LOCK();
+    for (i = 0; i < nOS_BUDGET_SLOTS; i++)
+    {
+        budget_slots_[i].max_ = 0;
+        budget_slots_[i].total_ = 0;
+        budget_slots_[i].count_ = 0;
+        budget_slots_[i].overruns_ = 0;
+        budget_slots_[i].prio_ = 0;
+    }
+    budget_untracked_ = 0;
+    nOS_INTERRUPTS_UNLOCK();
+}
+
+void nOS_budget_init (void)
+{
+    memset (budget_slots_, 0, sizeof(budget_slots_));
+    budget_untracked_ = 0;
+    budget_runs_ = 0;
+}
+
+uint32_t nOS_budget_mark (void)
+{
+    return budget_runs_;
+}
+
+void nOS_budget_dispatched (nOS_task_callback_t callback, nOS_prio_t prio,
+                            uint32_t cycles, uint32_t mark)
+{
+    budget_slot_t *slot;
+    uint32_t budget = 0;
+    uint32_t run;
+
+    // A preemption may dispatch meanwhile
+    nOS_INTERRUPTS_LOCK();
+    // Leave out the runs that ended since the mark, they were nested
+    run = cycles - (budget_runs_ - mark);
+    budget_runs_ += run;
+    slot = budget_find (callback, 1);
+    if (NULL == slot)
+    {
+        budget_untracked_++;
+    }
+    else
+    {
+        if (run > slot->max_)
+        {
+            slot->max_ = run;
+            slot->prio_ = prio;
+        }
+        slot->total_ += run;
+        slot->count_++;
+        if ((0 != slot->budget_) && (run > slot->budget_))
+        {
+            slot->overruns_++;
+            budget = slot->budget_;
+        }
+    }
+    nOS_INTERRUPTS_UNLOCK();
+
+    if (0 != budget)
+    {
+        nOS_budget_overrun (callback, prio, run, budget);
+    }
+}
+
+/* ------------------------------------------------------------- */
+/* Private function */
+/* ------------------------------------------------------------- */
+static budget_slot_t *budget_find (nOS_task_callback_t callback, int claim)
+{
+    uint32_t hash = (uint32_t) ((uintptr_t) callback >> 2) * 0x9E3779B1u;
+    budget_slot_t *slot;
+    uint16_t probe;
+
+    // Fold the well mixed high bits into the low bits the mask keeps
+    hash ^= hash >> 16;
+    for (probe = 0; probe < nOS_BUDGET_SLOTS; probe++)
+    {
+        slot = &budget_slots_[(hash + probe) & (nOS_BUDGET_SLOTS - 1)];
+        if (callback == slot->callback_)
+        {
+            return slot;
+        }
+        if (NULL == slot->callback_)
+        {
+            if (!claim)
+            {
+                return NULL;
+            }
+            slot->callback_ = callback;
+            return slot;
+        }
+    }
+
+    return NULL;
+}
+
+static void budget_copy (const budget_slot_t *slot, nOS_budget_stats_t *stats)
+{
+    stats->callback_ = slot->callback_;
+    stats->budget_ = slot->budget_;
+    stats->max_ = slot->max_;
+    stats->avg_ = slot->count_ ? (uint32_t) (slot->total_ / slot->count_) : 0;
+    stats->count_ = slot->count_;
+    stats->overruns_ = slot->overruns_;
+    stats->prio_ = slot->prio_;
+}
+
+static int budget_worse (const nOS_budget_stats_t *a,
+                         const nOS_budget_stats_t *b)
+{
+    if (a->overruns_ != b->overruns_)
+    {
+        return a->overruns_ > b->overruns_;
+    }
+
+    return a->max_ > b->max_;
+}
+
+#endif /* nOS_BUDGET */
@@ -0,0 +1,106 @@
+/**
+ * @file nanoBudget.h
+ * @author Ehud Frank
+ * @date 17 Oct 2026
+ * @brief Optional execution budgets of the callbacks, enabled by nOS_BUDGET.
+ * A run to completion callback that runs long stalls every other priority.
+ * The scheduler measures each callback with nOS_GET_CYCLES, keeps its longest
+ * and average run and calls nOS_budget_overrun when a run exceeded the budget
+ * of the callback. nOS_budget_report lists the worst offenders, the
+ * candidates to split into shorter tasks.
+ * A run does not count the tasks that ran nested in it (nOS_schedule from a
+ * task, the preemptions of nOS_PREEMPTIVE), it counts the ISRs. The coalesced
+ * and the message tasks are measured as their kernel dispatcher.
+ */
+
+#ifndef NANOBUDGET_H_
+#define NANOBUDGET_H_
+
+#include "nanoRTOS.h"
+
+#if nOS_BUDGET
+/**
+ * @brief The measurements of one callback
+ */
+typedef struct
+{
+    nOS_task_callback_t callback_;
+    uint32_t budget_;   // The budget in cycles, 0 without a budget
+    uint32_t max_;      // The longest run in cycles
+    uint32_t avg_;      // The average run in cycles
+    uint32_t count_;    // The number of runs
+    uint32_t overruns_; // The number of runs longer than the budget
+    nOS_prio_t prio_;   // The priority of the longest run
+} nOS_budget_stats_t;
+
+/**
+ * @brief A function to set the budget of a callback
+ * @param callback- The callback, also with nOS_TASK_TABLE
+ * @param cycles- The longest run allowed, 0 to only measure it
+ * @return nOS_OK, nOS_TASK_ERR for a NULL callback or nOS_BUDGET_ERR when all
+ * the nOS_BUDGET_SLOTS are taken
+ * @note nOS_start clears the budgets, set them after it.
+ */
+nOS_err_t nOS_budget_set (nOS_task_callback_t callback, uint32_t cycles);
+
+/**
+ * @brief A function to read the measurements of a callback
+ * @param stats- Output, the measurements
+ * @return nOS_OK or nOS_BUDGET_ERR if the callback is not measured
+ */
+nOS_err_t nOS_budget_get (nOS_task_callback_t callback,
+                          nOS_budget_stats_t *stats);
+
+/**
+ * @brief A function to list the worst offenders, the most overruns first,
+ * then the longest run
+ * @param worst- Output, the measurements of up to n callbacks
+ * @param n- The size of worst
+ * @return The number of callbacks listed
+ */
+uint16_t nOS_budget_report (nOS_budget_stats_t *worst, uint16_t n);
+
+/**
+ * @brief A function to read the runs that were not measured
+ * @return The runs of the callbacks that found all the slots taken
+ */
+uint32_t nOS_budget_untracked (void);
+
+/**
+ * @brief A function to clear the measurements, the budgets are kept
+ */
+void nOS_budget_reset (void);
+
+/**
+ * @brief The overrun hook, defined by the application, called by the
+ * scheduler after a callback ran longer than its budget
+ * @param callback- The callback
+ * @param prio- The priority it ran at
+ * @param cycles- The length of the run
+ * @param budget- The budget of the callback
+ */
+void nOS_budget_overrun (nOS_task_callback_t callback, nOS_prio_t prio,
+                         uint32_t cycles, uint32_t budget);
+
+/* ------------------------------------------------------------- */
+/* Kernel hooks */
+/* ------------------------------------------------------------- */
+/**
+ * @brief Called by nOS_start, clears the budgets and the measurements
+ */
+void nOS_budget_init (void);
+/**
+ * @brief Called by nOS_schedule before a callback is called
+ * @return The mark to pass to nOS_budget_dispatched
+ */
+uint32_t nOS_budget_mark (void);
+/**
+ * @brief Called by nOS_schedule after a callback returned
+ * @param cycles- The cycles from the call to the return
+ * @param mark- The return of nOS_budget_mark before the call
+ */
+void nOS_budget_dispatched (nOS_task_callback_t callback, nOS_prio_t prio,
+                            uint32_t cycles, uint32_t mark);
+#endif
+
+#endif /* NANOBUDGET_H_ */
@@ -16,9 +16,16 @@
  * Therefore user shall #include the port header as well
  */
 //#include "port_mcu#.h"
+#if defined(nOS_PORT_HOST_SIM)
+#include "port/host_sim/port_host_sim.h"
+#elif defined(nOS_PORT_POSIX)
+#include "port/posix/port_posix.h"
+#endif
 
+#ifndef nOS_INTERRUPTS_LOCK
 #define nOS_INTERRUPTS_LOCK()   //__disable_irq()
 #define nOS_INTERRUPTS_UNLOCK() //__enable_irq()
+#endif
 
 /**
  * @brief A macro to wrap a code section with interrupts disable and enable
@@ -30,6 +37,62 @@
         nOS_INTERRUPTS_UNLOCK();\
     }
 
+/**
+ * @brief Task queue implementation
+ * nOS_TASK_QUEUE_LOCKED - The task queues and the ready flags are guarded by
+ * nOS_INTERRUPTS_LOCK/UNLOCK for a few instructions per enqueue/dequeue.
+ * nOS_TASK_QUEUE_LOCK_FREE - Multi producer lock free task queues and atomic
+ * ready flags, ISRs can post tasks without disabling interrupts.
+ * Requires atomic instructions (see nanoAtomic.h), e.g. Cortex-M3 and above.
+ * nOS_TASK_QUEUE_POW2 - Locked as nOS_TASK_QUEUE_LOCKED, with power of two
+ * queues (nOS_CREATE_POW2_QUEUE) of narrow masked indices and no count.
+ * Every queue length is rounded up to the next power of two.
+ * The default is nOS_TASK_QUEUE_LOCKED. The lock free queues have a single
+ * consumer, so they do not go with nOS_SMP_CORES, nOS_PREEMPTIVE,
+ * nOS_TASK_CANCEL and nOS_OVERFLOW_DROP_OLDEST.
+ */
+#define nOS_TASK_QUEUE_LOCKED               0
+#define nOS_TASK_QUEUE_LOCK_FREE            1
+#define nOS_TASK_QUEUE_POW2                 2
+
+/**
+ * @brief Multi core scheduling
+ * nOS_SMP_CORES - The number of cores that call nOS_schedule, 1 for a single
+ * core kernel. Above 1 every core has its own ready bitmap and priority
+ * queues, guarded by a spin lock (see nanoAtomic.h), and a core with no
+ * higher priority work of its own steals tasks from the other cores.
+ * nOS_CORE_ID - Reads the index of the calling core, from 0, by default the
+ * port hook nOS_port_core_id (see nanoPort.h).
+ * The timers, coalescing and the message pool statistics only lock
+ * interrupts, in SMP mode nOS_INTERRUPTS_LOCK shall also lock the other
+ * cores out to use them from several cores.
+ */
+#ifndef nOS_SMP_CORES
+#define nOS_SMP_CORES                       1
+#endif
+#ifndef nOS_CORE_ID
+#if (nOS_SMP_CORES > 1)
+#define nOS_CORE_ID()                       nOS_port_core_id ()
+#else
+#define nOS_CORE_ID()                       0
+#endif
+#endif
+
+/**
+ * @brief Run to completion preemption (single stack, as SST/QK)
+ * When enabled, an ISR that posted a task of a higher priority than the
+ * running one runs it at its exit (nOS_isr_exit) on the stack of the
+ * preempted task, the preempted task resumes once the higher priorities are
+ * done. The port shall call nOS_isr_exit at the end of every ISR.
+ */
+#ifndef nOS_PREEMPTIVE
+#define nOS_PREEMPTIVE                      0
+#endif
+
+#ifndef nOS_TASK_QUEUE_IMPL
+#define nOS_TASK_QUEUE_IMPL                 nOS_TASK_QUEUE_LOCKED
+#endif
+
 #define nOS_PRIO1_TASK_QUEUE_LENGTH         28
 #define nOS_PRIO2_TASK_QUEUE_LENGTH         24
 #define nOS_PRIO3_TASK_QUEUE_LENGTH         20
@@ -39,6 +102,360 @@
 #define nOS_PRIO7_TASK_QUEUE_LENGTH         4
 #define nOS_PRIO8_TASK_QUEUE_LENGTH         2
 
+/**
+ * @brief A generated table of the task queue lengths, optional
+ * nanoRTOS_tune writes a header that defines nOS_TASK_QUEUE_LENGTHS from the
+ * peaks of a profiling run (nOS_QUEUE_PROFILE), include it in the build with
+ * e.g. -DnOS_QUEUE_LENGTHS_HEADER='"nanoQueueLengths.h"'
+ */
+#ifdef nOS_QUEUE_LENGTHS_HEADER
+#include nOS_QUEUE_LENGTHS_HEADER
+#endif
+
+/**
+ * @brief The table of the task queue lengths, from priority 1 (the lowest) up
+ * to the highest priority. The number of entries sets the number of
+ * priorities, up to 256, e.g. list 32 lengths for 32 priorities:
+ * #define nOS_TASK_QUEUE_LENGTHS(X) X(16) X(16) ... X(4)
+ */
+#ifndef nOS_TASK_QUEUE_LENGTHS
+#define nOS_TASK_QUEUE_LENGTHS(X)\
+    X(nOS_PRIO1_TASK_QUEUE_LENGTH)\
+    X(nOS_PRIO2_TASK_QUEUE_LENGTH)\
+    X(nOS_PRIO3_TASK_QUEUE_LENGTH)\
+    X(nOS_PRIO4_TASK_QUEUE_LENGTH)\
+    X(nOS_PRIO5_TASK_QUEUE_LENGTH)\
+    X(nOS_PRIO6_TASK_QUEUE_LENGTH)\
+    X(nOS_PRIO7_TASK_QUEUE_LENGTH)\
+    X(nOS_PRIO8_TASK_QUEUE_LENGTH)
+#endif
+
+/**
+ * @brief The smallest power of two not below x, for x from 1 to 65536
+ */
+#define nOS_POW2_CEIL(x)\
+    ((((x) - 1) | (((x) - 1) >> 1) | (((x) - 1) >> 2) | (((x) - 1) >> 3)\
+    | (((x) - 1) >> 4) | (((x) - 1) >> 5) | (((x) - 1) >> 6) | (((x) - 1) >> 7)\
+    | (((x) - 1) >> 8) | (((x) - 1) >> 9) | (((x) - 1) >> 10)\
+    | (((x) - 1) >> 11) | (((x) - 1) >> 12) | (((x) - 1) >> 13)\
+    | (((x) - 1) >> 14) | (((x) - 1) >> 15)) + 1)
+
+/**
+ * @brief The number of slots the kernel allocates for a queue length
+ */
+#if (nOS_TASK_QUEUE_IMPL == nOS_TASK_QUEUE_POW2)
+#define nOS_TASK_QUEUE_SLOTS(length)        nOS_POW2_CEIL(length)
+#else
+#define nOS_TASK_QUEUE_SLOTS(length)        (length)
+#endif
+
+#define nOS_COUNT_ENTRY(length)             + 1
+#define nOS_SUM_ENTRY(length)               + nOS_TASK_QUEUE_SLOTS(length)
+#define nOS_OR_ENTRY(length)                | nOS_TASK_QUEUE_SLOTS(length)
+#define nOS_NON_ZERO_ENTRY(length)          && ((length) > 0)
+#define nOS_LENGTH_SUM_ENTRY(length)        + (length)
+#define nOS_LENGTH_OR_ENTRY(length)         | (length)
+/**
+ * @brief The number of priorities and the total number of queued tasks
+ */
+#define nOS_PRIO_COUNT                      (0 nOS_TASK_QUEUE_LENGTHS(nOS_COUNT_ENTRY))
+#define nOS_TASK_QUEUE_TOTAL_LENGTH         (0 nOS_TASK_QUEUE_LENGTHS(nOS_SUM_ENTRY))
+#ifdef nOS_TASK_DEADLINE_LENGTHS
+#define nOS_TASK_DEADLINE_TOTAL_LENGTH      (0 nOS_TASK_DEADLINE_LENGTHS(nOS_LENGTH_SUM_ENTRY))
+#endif
+
+/**
+ * @brief The index type of the power of two queues, 8 bit while no queue is
+ * longer than 128 tasks
+ */
+#if ((0 nOS_TASK_QUEUE_LENGTHS(nOS_OR_ENTRY)) > 128)
+#define nOS_TASK_QUEUE_INDEX_T              uint16_t
+#else
+#define nOS_TASK_QUEUE_INDEX_T              uint8_t
+#endif
+
+/**
+ * @brief The task table, optional
+ * When defined, the tasks are posted by ID instead of callback and a queued
+ * task takes two bytes (ID and event) instead of a callback pointer and an
+ * event. List every task callback once, the IDs are nOS_TASK_ID(callback):
+ * #define nOS_TASK_TABLE(X) X(led_task) X(uart_rx_task) X(adc_task)
+ * nOS_task_enqueue (3, nOS_TASK_ID(uart_rx_task), byte);
+ * The table declares the callbacks, they shall be global functions.
+ */
+//#define nOS_TASK_TABLE(X)
+
+/**
+ * @brief The publish/subscribe topics (nOS_publish), optional
+ * List every topic once with its subscribers, nOS_SUBSCRIBER(prio, callback)
+ * each, a publish posts its event to all the subscribers at once. The IDs are
+ * nOS_TOPIC(topic):
+ * #define nOS_TOPIC_TABLE(X)\
+ *     X(button, nOS_SUBSCRIBER(5, led_task) nOS_SUBSCRIBER(3, log_task))\
+ *     X(rx_frame, nOS_SUBSCRIBER(6, parse_task))
+ * nOS_publish (nOS_TOPIC(button), pressed);
+ * A topic has one subscriber at least. The table declares the callbacks, they
+ * shall be global functions, with nOS_TASK_TABLE also listed there.
+ */
+//#define nOS_TOPIC_TABLE(X)
+
+/**
+ * @brief Batches
+ * nOS_TASK_BATCH_CHUNK - nOS_task_enqueue_batch builds this many tasks on the
+ * stack at a time and copies them into the queue in one bulk operation.
+ * nOS_SCHEDULE_BATCH - The number of tasks nOS_schedule takes out of one
+ * priority queue at once before it looks for the highest ready priority again.
+ * A task posted at a higher priority meanwhile waits for the rest of the
+ * batch, 1 keeps the strict priority order.
+ */
+#ifndef nOS_TASK_BATCH_CHUNK
+#define nOS_TASK_BATCH_CHUNK                8
+#endif
+#ifndef nOS_SCHEDULE_BATCH
+#define nOS_SCHEDULE_BATCH                  1
+#endif
+
+/**
+ * @brief Aging, starvation free scheduling of the low priorities
+ * nOS_AGING_CREDITS - The number of batches the higher priorities may take
+ * while a lower priority waits, then one batch of a waiting priority runs
+ * (the waiting priorities take their turns in round robin), 0 disables it
+ * and keeps the strict priority order. A priority waits at most
+ * (nOS_AGING_CREDITS + 1) x (the number of waiting priorities) batches.
+ */
+#ifndef nOS_AGING_CREDITS
+#define nOS_AGING_CREDITS                   0
+#endif
+
+/**
+ * @brief Earliest deadline first priorities (nOS_task_enqueue_deadline)
+ * The table of the deadline heap lengths, one entry per priority like
+ * nOS_TASK_QUEUE_LENGTHS, 0 for a FIFO only priority, e.g. EDF at priority 3:
+ * #define nOS_TASK_DEADLINE_LENGTHS(X) X(0) X(0) X(8) X(0) X(0) X(0) X(0) X(0)
+ * A post and a dispatch of a deadline task are O(log n) in its heap, both with
+ * the interrupts locked. Undefined, all the priorities are FIFO only.
+ */
+//#define nOS_TASK_DEADLINE_LENGTHS(X)
+#ifdef nOS_TASK_DEADLINE_LENGTHS
+#define nOS_EDF                             1
+#else
+#define nOS_EDF                             0
+#endif
+
+/**
+ * @brief Task cancellation (nOS_task_enqueue_handle, nOS_task_cancel)
+ * nOS_TASK_CANCEL - 1 to keep a generation per task queue slot, 2 bytes each,
+ * so a task posted with a handle can be withdrawn in O(1) until it is taken
+ * by the scheduler, which skips it. Needs nOS_TASK_QUEUE_LOCKED or
+ * nOS_TASK_QUEUE_POW2. A handle is only reused after 32768 posts to its slot.
+ */
+#ifndef nOS_TASK_CANCEL
+#define nOS_TASK_CANCEL                     0
+#endif
+
+/**
+ * @brief Overflow policies, what a post to a full task queue does
+ * nOS_OVERFLOW_REJECT - The post fails with nOS_TASK_QUEUE_ERR (the default).
+ * nOS_OVERFLOW_DROP_OLDEST - The oldest pending task is dropped to make room,
+ * the newest data replaces the stale one. Needs nOS_TASK_QUEUE_LOCKED or
+ * nOS_TASK_QUEUE_POW2.
+ * nOS_OVERFLOW_SPILL - The task is posted to the next lower priority, which
+ * applies its own policy when full in turn. Priority 1 rejects.
+ * nOS_OVERFLOW_BACK_PRESSURE - The post fails and nOS_task_back_pressure is
+ * called first, e.g. to throttle the producer.
+ * The table of the policies, one entry per priority like
+ * nOS_TASK_QUEUE_LENGTHS, e.g. the newest sample wins at priority 3:
+ * #define nOS_TASK_OVERFLOW_POLICIES(X)\
+ *     X(nOS_OVERFLOW_REJECT) X(nOS_OVERFLOW_REJECT) X(nOS_OVERFLOW_DROP_OLDEST)\
+ *     X(nOS_OVERFLOW_REJECT) X(nOS_OVERFLOW_REJECT) X(nOS_OVERFLOW_REJECT)\
+ *     X(nOS_OVERFLOW_REJECT) X(nOS_OVERFLOW_REJECT)
+ * The policies apply to single posts, a batch (nOS_task_enqueue_batch) and a
+ * deadline post always reject. Each priority counts its overflows per
+ * policy (nOS_task_overflows). Undefined, all the priorities reject.
+ */
+#define nOS_OVERFLOW_REJECT                 0
+#define nOS_OVERFLOW_DROP_OLDEST            1
+#define nOS_OVERFLOW_SPILL                  2
+#define nOS_OVERFLOW_BACK_PRESSURE          3
+#define nOS_OVERFLOW_POLICY_COUNT           4
+//#define nOS_TASK_OVERFLOW_POLICIES(X)
+#ifdef nOS_TASK_OVERFLOW_POLICIES
+#define nOS_OVERFLOW_POLICY                 1
+#define nOS_DROP_OLDEST_ENTRY(policy)       || ((policy) == nOS_OVERFLOW_DROP_OLDEST)
+#define nOS_BACK_PRESSURE_ENTRY(policy)     || ((policy) == nOS_OVERFLOW_BACK_PRESSURE)
+#define nOS_BACK_PRESSURE_USED              (0 nOS_TASK_OVERFLOW_POLICIES(nOS_BACK_PRESSURE_ENTRY))
+#else
+#define nOS_OVERFLOW_POLICY                 0
+#define nOS_BACK_PRESSURE_USED              0
+#endif
+
+/**
+ * @brief Event coalescing (nOS_task_enqueue_coalesced)
+ * nOS_TASK_COALESCE - 1 to fold the posts of a task that is already pending
+ * into its pending instance instead of queuing it again.
+ * nOS_TASK_COALESCE_SLOTS - The number of tasks that can be pending coalesced
+ * at the same time, a power of 2 up to 256. When the slots near the hash of a
+ * task are taken the task is queued without coalescing.
+ */
+#ifndef nOS_TASK_COALESCE
+#define nOS_TASK_COALESCE                   0
+#endif
+#ifndef nOS_TASK_COALESCE_SLOTS
+#define nOS_TASK_COALESCE_SLOTS             16
+#endif
+
+/**
+ * @brief Message pool (nanoPool.h, nOS_task_post_msg)
+ * nOS_MSG_POOL - 1 to compile the fixed block memory pool, so tasks can be
+ * posted with a message block instead of copying their payload.
+ * nOS_POOL_CLASSES(X) - The block size classes, X(bytes, blocks) each, listed
+ * from the smallest block size. All the classes together are limited to 256
+ * blocks, a queued message task carries the block number as its event.
+ */
+#ifndef nOS_MSG_POOL
+#define nOS_MSG_POOL                        0
+#endif
+#ifndef nOS_POOL_CLASSES
+#define nOS_POOL_CLASSES(X)\
+    X(16, 16)\
+    X(64, 8)\
+    X(256, 4)
+#endif
+
+#define nOS_POOL_COUNT_ENTRY(bytes, blocks) + 1
+#define nOS_POOL_BLOCKS_ENTRY(bytes, blocks) + (blocks)
+/**
+ * @brief The number of block size classes and of blocks in all the classes
+ */
+#define nOS_POOL_CLASS_COUNT                (0 nOS_POOL_CLASSES(nOS_POOL_COUNT_ENTRY))
+#define nOS_POOL_BLOCK_COUNT                (0 nOS_POOL_CLASSES(nOS_POOL_BLOCKS_ENTRY))
+
+/**
+ * @brief Software timers (nanoTimer.h)
+ * nOS_TIMER_COUNT - The number of timers that can run at the same time
+ * nOS_TIMER_WHEEL_SIZE - The number of slots of the timer wheel, shall be a
+ * power of 2. Each tick only walks the timers hashed to one slot, so about
+ * nOS_TIMER_COUNT / nOS_TIMER_WHEEL_SIZE timers per tick.
+ */
+#ifndef nOS_TIMER_COUNT
+#define nOS_TIMER_COUNT                     16
+#endif
+#ifndef nOS_TIMER_WHEEL_SIZE
+#define nOS_TIMER_WHEEL_SIZE                16
+#endif
+
+/**
+ * @brief Tickless idle
+ * When enabled, nOS_schedule puts the MCU to sleep once all the task queues
+ * are empty by calling nOS_port_sleep_until (see nanoPort.h) with the tick of
+ * the next timer expiry, the tick is stopped for the whole sleep.
+ */
+#ifndef nOS_TICKLESS_IDLE
+#define nOS_TICKLESS_IDLE                   0
+#endif
+
+/**
+ * @brief Scheduler instrumentation (nanoStats.h)
+ * nOS_STATS - 1 to record per priority wait/run time histograms, queue high
+ * water marks and overflow counts, 0 compiles all of it away.
+ * nOS_STATS_HIST_BINS - The number of log2 bins of each histogram.
+ * nOS_GET_CYCLES - Reads a free running 32 bit cycle counter, e.g. DWT->CYCCNT
+ * on Cortex-M, by default the port hook nOS_port_cycles (see nanoPort.h).
+ * The trace (nOS_TRACE) and the budgets (nOS_BUDGET) use it too.
+ */
+#ifndef nOS_STATS
+#define nOS_STATS                           0
+#endif
+#ifndef nOS_STATS_HIST_BINS
+#define nOS_STATS_HIST_BINS                 16
+#endif
+#ifndef nOS_GET_CYCLES
+#define nOS_GET_CYCLES()                    nOS_port_cycles ()
+#endif
+
+/**
+ * @brief Scheduler trace (nanoTrace.h)
+ * nOS_TRACE - 1 to record the enqueues, dispatches, overflows and idle entries
+ * in a ring of 8 byte records, 0 compiles all of it away.
+ * nOS_TRACE_RECORDS - The number of records of the ring, a power of 2, the
+ * newest records overwrite the oldest.
+ * nOS_TRACE_CYCLES_PER_US - The nOS_GET_CYCLES rate, e.g. the core clock in
+ * MHz for DWT->CYCCNT, the dumps carry it to the decoder.
+ * nOS_IN_ISR - Non zero when called from an ISR, e.g. the IPSR on Cortex-M,
+ * the trace flags the records of the ISRs with it (nOS_TRACE_ISR) so a replay
+ * (nanoRTOS_replay) tells the interrupts from the tasks. 0 if the port has
+ * none, then the posts of an ISR that interrupted a task are replayed as
+ * posts of that task.
+ */
+#ifndef nOS_TRACE
+#define nOS_TRACE                           0
+#endif
+#ifndef nOS_TRACE_RECORDS
+#define nOS_TRACE_RECORDS                   256
+#endif
+#ifndef nOS_TRACE_CYCLES_PER_US
+#define nOS_TRACE_CYCLES_PER_US             1
+#endif
+#ifndef nOS_IN_ISR
+#define nOS_IN_ISR()                        0
+#endif
+
+/**
+ * @brief Execution budgets of the callbacks (nanoBudget.h)
+ * nOS_BUDGET - 1 to measure every callback with nOS_GET_CYCLES, its longest
+ * and average run, and to call nOS_budget_overrun when a run exceeds the
+ * budget set with nOS_budget_set, 0 compiles all of it away.
+ * nOS_BUDGET_SLOTS - The number of callbacks measured, a power of 2, the
+ * callbacks dispatched once the slots are taken are only counted.
+ */
+#ifndef nOS_BUDGET
+#define nOS_BUDGET                          0
+#endif
+#ifndef nOS_BUDGET_SLOTS
+#define nOS_BUDGET_SLOTS                    16
+#endif
+
+/**
+ * @brief Queue occupancy profile (nanoProfile.h)
+ * nOS_QUEUE_PROFILE - 1 to record the peak number of tasks queued, the posts
+ * and the overflows of every priority, for nanoRTOS_tune to size the queues
+ * (see nOS_QUEUE_LENGTHS_HEADER), 0 compiles all of it away. It needs no
+ * cycle counter.
+ */
+#ifndef nOS_QUEUE_PROFILE
+#define nOS_QUEUE_PROFILE                   0
+#endif
+
+/**
+ * @brief Stackless coroutines (nanoCoro.h, nanoCoro.hpp)
+ * nOS_CORO - 1 to compile the coroutines, flows that await events, messages
+ * and ticks without a stack of their own, resumed by nOS_coro_dispatch tasks.
+ * A coroutine that awaits ticks holds one of the nOS_TIMER_COUNT timers.
+ * nOS_CORO_SLOTS - The number of coroutines running at the same time, up to
+ * 256, a pointer each.
+ * nOS_CORO_EVENTS - The mailbox of each coroutine, the events posted and not
+ * awaited yet, a power of 2 up to 128.
+ */
+#ifndef nOS_CORO
+#define nOS_CORO                            0
+#endif
+#ifndef nOS_CORO_SLOTS
+#define nOS_CORO_SLOTS                      32
+#endif
+#ifndef nOS_CORO_EVENTS
+#define nOS_CORO_EVENTS                     4
+#endif
+
+/**
+ * @brief Count leading zeros of a non zero 32 bit value, a single CLZ
+ * instruction on Cortex-M3 and above. The scheduler finds the highest ready
+ * priority with it. Ports of compilers without the builtin shall provide
+ * their own.
+ */
+#ifndef nOS_CLZ32
+#define nOS_CLZ32(x)                        ((uint8_t) __builtin_clz (x))
+#endif
+
 /**
  * Compile time check for task queue definitions
  */
@@ -67,4 +484,96 @@
 #error("no task queue for priority 8");
 #endif
 
+#if (nOS_PRIO_COUNT < 1) || (nOS_PRIO_COUNT > 256)
+#error("nOS_TASK_QUEUE_LENGTHS shall list 1 to 256 priorities");
+#endif
+#if !(1 nOS_TASK_QUEUE_LENGTHS(nOS_NON_ZERO_ENTRY))
+#error("no task queue for one of the priorities in nOS_TASK_QUEUE_LENGTHS");
+#endif
+#if (nOS_TASK_QUEUE_IMPL == nOS_TASK_QUEUE_POW2)\
+    && ((0 nOS_TASK_QUEUE_LENGTHS(nOS_OR_ENTRY)) > 32768)
+#error("nOS_TASK_QUEUE_POW2 queues are limited to 32768 tasks");
+#endif
+#if (nOS_TASK_BATCH_CHUNK < 1) || (nOS_SCHEDULE_BATCH < 1)
+#error("nOS_TASK_BATCH_CHUNK and nOS_SCHEDULE_BATCH shall be at least 1");
+#endif
+#if (nOS_TASK_COALESCE_SLOTS & (nOS_TASK_COALESCE_SLOTS - 1)) != 0\
+    || (nOS_TASK_COALESCE_SLOTS > 256)
+#error("nOS_TASK_COALESCE_SLOTS shall be a power of 2 up to 256");
+#endif
+#ifdef nOS_TASK_TABLE
+#if ((0 nOS_TASK_TABLE(nOS_COUNT_ENTRY)) + (nOS_TASK_COALESCE != 0)\
+    + (nOS_MSG_POOL != 0)) > 256
+#error("nOS_TASK_TABLE is limited to 256 tasks, one less with nOS_TASK_COALESCE and with nOS_MSG_POOL");
+#endif
+#endif
+#if nOS_MSG_POOL && ((nOS_POOL_BLOCK_COUNT < 1) || (nOS_POOL_BLOCK_COUNT > 256))
+#error("nOS_POOL_CLASSES shall hold 1 to 256 blocks");
+#endif
+#if (nOS_SMP_CORES < 1) || (nOS_SMP_CORES > 32)
+#error("nOS_SMP_CORES shall be 1 to 32");
+#endif
+#if (nOS_SMP_CORES > 1) && (nOS_TASK_QUEUE_IMPL == nOS_TASK_QUEUE_LOCK_FREE)
+#error("nOS_SMP_CORES needs nOS_TASK_QUEUE_LOCKED or nOS_TASK_QUEUE_POW2");
+#endif
+#if (nOS_SMP_CORES > 1) && (nOS_STATS || nOS_TRACE || nOS_BUDGET || nOS_TICKLESS_IDLE)
+#error("nOS_STATS, nOS_TRACE, nOS_BUDGET and nOS_TICKLESS_IDLE are single core only");
+#endif
+#if nOS_BUDGET && ((nOS_BUDGET_SLOTS < 1)\
+        || ((nOS_BUDGET_SLOTS & (nOS_BUDGET_SLOTS - 1)) != 0))
+#error("nOS_BUDGET_SLOTS shall be a power of 2");
+#endif
+#if nOS_QUEUE_PROFILE && ((0 nOS_TASK_QUEUE_LENGTHS(nOS_OR_ENTRY)) > 65535)
+#error("nOS_QUEUE_PROFILE is limited to queues of up to 65535 tasks");
+#endif
+#if nOS_CORO && ((nOS_CORO_SLOTS < 1) || (nOS_CORO_SLOTS > 256))
+#error("nOS_CORO_SLOTS shall be 1 to 256");
+#endif
+#if nOS_CORO && ((nOS_CORO_EVENTS < 1) || (nOS_CORO_EVENTS > 128)\
+        || ((nOS_CORO_EVENTS & (nOS_CORO_EVENTS - 1)) != 0))
+#error("nOS_CORO_EVENTS shall be a power of 2 up to 128");
+#endif
+#if nOS_CORO && (nOS_SMP_CORES > 1)
+#error("nOS_CORO is single core only");
+#endif
+#if nOS_AGING_CREDITS && (nOS_SMP_CORES > 1)
+#error("nOS_AGING_CREDITS is single core only");
+#endif
+#if nOS_EDF
+#if (0 nOS_TASK_DEADLINE_LENGTHS(nOS_COUNT_ENTRY)) != nOS_PRIO_COUNT
+#error("nOS_TASK_DEADLINE_LENGTHS shall list as many priorities as nOS_TASK_QUEUE_LENGTHS");
+#endif
+#if (nOS_TASK_DEADLINE_TOTAL_LENGTH < 1)\
+    || ((0 nOS_TASK_DEADLINE_LENGTHS(nOS_LENGTH_OR_ENTRY)) > 65535)
+#error("nOS_TASK_DEADLINE_LENGTHS shall have at least one heap, of up to 65535 tasks each");
+#endif
+#if (nOS_SMP_CORES > 1)
+#error("nOS_TASK_DEADLINE_LENGTHS is single core only");
+#endif
+#endif
+#if nOS_TASK_CANCEL && ((nOS_TASK_QUEUE_IMPL == nOS_TASK_QUEUE_LOCK_FREE)\
+        || (nOS_SMP_CORES * nOS_TASK_QUEUE_TOTAL_LENGTH > 65535))
+#error("nOS_TASK_CANCEL needs nOS_TASK_QUEUE_LOCKED or nOS_TASK_QUEUE_POW2 and up to 65535 task slots");
+#endif
+#if nOS_OVERFLOW_POLICY
+#if (0 nOS_TASK_OVERFLOW_POLICIES(nOS_COUNT_ENTRY)) != nOS_PRIO_COUNT
+#error("nOS_TASK_OVERFLOW_POLICIES shall list as many priorities as nOS_TASK_QUEUE_LENGTHS");
+#endif
+#if (0 nOS_TASK_OVERFLOW_POLICIES(nOS_DROP_OLDEST_ENTRY))\
+        && (nOS_TASK_QUEUE_IMPL == nOS_TASK_QUEUE_LOCK_FREE)
+#error("nOS_OVERFLOW_DROP_OLDEST needs nOS_TASK_QUEUE_LOCKED or nOS_TASK_QUEUE_POW2");
+#endif
+#endif
+#if nOS_PREEMPTIVE && ((nOS_SMP_CORES > 1)\
+        || (nOS_TASK_QUEUE_IMPL == nOS_TASK_QUEUE_LOCK_FREE))
+#error("nOS_PREEMPTIVE is single core and needs nOS_TASK_QUEUE_LOCKED or nOS_TASK_QUEUE_POW2");
+#endif
+#if nOS_TRACE && ((nOS_TRACE_RECORDS < 1)\
+        || ((nOS_TRACE_RECORDS & (nOS_TRACE_RECORDS - 1)) != 0))
+#error("nOS_TRACE_RECORDS shall be a power of 2");
+#endif
+#if (nOS_TIMER_WHEEL_SIZE & (nOS_TIMER_WHEEL_SIZE - 1)) != 0
+#error("nOS_TIMER_WHEEL_SIZE shall be a power of 2");
+#endif
+
 #endif // end of NANOCONFIG_H_
@@ -0,0 +1,344 @@
+/**
+ * @file nanoCoro.c
+ * @author Ehud Frank
+ * Description Stackless coroutines, see nanoCoro.h.
+ * A coroutine in a slot is resumed by nOS_coro_dispatch tasks posted at its
+ * priority with the slot as their event. The posts, the timers and a yield
+ * all post such a task, the dispatcher checks what the coroutine waits for
+ * and ignores the tasks it does not wait for any more (a timeout cancelled
+ * too late, a slot taken again).
+ * A timeout does not get lost to a full task queue, the one shot timer posts
+ * again on every tick until its post is queued (see nanoTimer.c).
+ * @date 17 Oct 2026
+ */
+
+#include "nanoCoro.h"
+#include "string.h"
+
+#if nOS_CORO
+
+#ifdef nOS_TASK_TABLE
+#define CORO_TASK           nOS_TASK_ID(nOS_coro_dispatch)
+#else
+#define CORO_TASK           nOS_coro_dispatch
+#endif
+#define CORO_EVENTS_MASK    (nOS_CORO_EVENTS - 1)
+
+/**
+ * @brief The private flags_ of a coroutine
+ */
+#define CORO_RUNNING        0x01 // In its slot
+#define CORO_SCHEDULED      0x02 // A post queued its resume task
+#define CORO_MSG_PENDING    0x04 // msg_ was posted and not received yet
+
+/**
+ * A structure to hold all the private variables of the module
+ */
+typedef struct
+{
+    nOS_coro_t *coros_[nOS_CORO_SLOTS]; // The running coroutines by slot
+    uint16_t next_; // The slot to try first, the slots are taken in turn
+} coro_vars_t;
+
+static coro_vars_t coro_vars;
+
+/**
+ * @brief A function to post the resume task of a coroutine
+ */
+static nOS_err_t coro_resume (nOS_coro_t *coro);
+/**
+ * @brief A function to post an event or a message, common to both
+ * @param wait- The nOS_CORO_WAIT_xxx flag that is resumed by the post
+ */
+static nOS_err_t coro_post (nOS_coro_t *coro, uint8_t wait);
+
+void nOS_coro_init (void)
+{
+    nOS_INTERRUPTS_LOCK();
+    memset (&coro_vars, 0, sizeof(coro_vars));
+    nOS_INTERRUPTS_UNLOCK();
+}
+
+nOS_err_t nOS_coro_start (nOS_coro_t *coro, nOS_prio_t prio, nOS_coro_fn_t fn)
+{
+    uint16_t i, slot = nOS_CORO_SLOTS;
+    nOS_err_t err;
+
+    // Check inputs to function
+    if ((NULL == coro) || (NULL == fn))
+    {
+        return nOS_TASK_ERR;
+    }
+    if ((prio < 1) || (prio > nOS_PRIO_COUNT))
+    {
+        return nOS_PRIORITY_ERR;
+    }
+
+    nOS_INTERRUPTS_LOCK();
+    if (!nOS_coro_running (coro))
+    {
+        // The slots are reused last, so the stale resumes of a slot rarely
+        // find another coroutine there
+        for (i = 0; i < nOS_CORO_SLOTS; i++)
+        {
+            if (NULL == coro_vars.coros_[(coro_vars.next_ + i) % nOS_CORO_SLOTS])
+            {
+                slot = (coro_vars.next_ + i) % nOS_CORO_SLOTS;
+                break;
+            }
+        }
+    }
+    if (slot < nOS_CORO_SLOTS)
+    {
+        memset (coro, 0, sizeof(*coro));
+        coro->fn_ = fn;
+        coro->timer_ = nOS_TIMER_INVALID;
+        coro->prio_ = prio;
+        coro->id_ = (uint8_t) slot;
+        coro->wait_ = nOS_CORO_WAIT_READY;
+        coro->flags_ = CORO_RUNNING;
+        coro_vars.coros_[slot] = coro;
+        coro_vars.next_ = (uint16_t) ((slot + 1) % nOS_CORO_SLOTS);
+    }
+    nOS_INTERRUPTS_UNLOCK();
+    if (slot >= nOS_CORO_SLOTS)
+    {
+        return nOS_CORO_ERR;
+    }
+
+    err = coro_resume (coro);
+    if (nOS_OK != err)
+    {
+        nOS_coro_kill (coro);
+    }
+
+    return err;
+}
+
+nOS_err_t nOS_coro_post (nOS_coro_t *coro, uint8_t event)
+{
+    nOS_INTERRUPTS_LOCK();
+    if (!nOS_coro_running (coro))
+    {
+        nOS_INTERRUPTS_UNLOCK();
+        return nOS_CORO_ERR;
+    }
+    if (nOS_CORO_EVENTS == coro->count_)
+    {
+        nOS_INTERRUPTS_UNLOCK();
+        return nOS_TASK_QUEUE_ERR;
+    }
+    coro->events_[(coro->head_ + coro->count_) & CORO_EVENTS_MASK] = event;
+    coro->count_++;
+
+    return coro_post (coro, nOS_CORO_WAIT_EVENT);
+}
+
+nOS_err_t nOS_coro_post_msg (nOS_coro_t *coro, void *msg)
+{
+    nOS_INTERRUPTS_LOCK();
+    if (!nOS_coro_running (coro))
+    {
+        nOS_INTERRUPTS_UNLOCK();
+        return nOS_CORO_ERR;
+    }
+    if (coro->flags_ & CORO_MSG_PENDING)
+    {
+        nOS_INTERRUPTS_UNLOCK();
+        return nOS_TASK_QUEUE_ERR;
+    }
+    coro->msg_ = msg;
+    coro->flags_ |= CORO_MSG_PENDING;
+
+    return coro_post (coro, nOS_CORO_WAIT_MSG);
+}
+
+nOS_err_t nOS_coro_kill (nOS_coro_t *coro)
+{
+    nOS_timer_t timer;
+
+    nOS_INTERRUPTS_LOCK();
+    if (!nOS_coro_running (coro))
+    {
+        nOS_INTERRUPTS_UNLOCK();
+        return nOS_CORO_ERR;
+    }
+    coro_vars.coros_[coro->id_] = NULL;
+    coro->flags_ = 0;
+    coro->wait_ = 0;
+    timer = coro->timer_;
+    coro->timer_ = nOS_TIMER_INVALID;
+    nOS_INTERRUPTS_UNLOCK();
+
+    if (nOS_TIMER_INVALID != timer)
+    {
+        nOS_timer_cancel (timer);
+    }
+
+    return nOS_OK;
+}
+
+uint8_t nOS_coro_running (const nOS_coro_t *coro)
+{
+    return (NULL != coro) && (coro->flags_ & CORO_RUNNING)
+            && (coro->id_ < nOS_CORO_SLOTS)
+            && (coro_vars.coros_[coro->id_] == coro);
+}
+
+uint8_t nOS_coro_wait (nOS_coro_t *coro, uint8_t wait, nOS_tick_t ticks)
+{
+    uint8_t wake = 0;
+    nOS_timer_t timer;
+
+    nOS_INTERRUPTS_LOCK();
+    if ((wait & nOS_CORO_WAIT_EVENT) && coro->count_)
+    {
+        coro->event_ = coro->events_[coro->head_];
+        coro->head_ = (coro->head_ + 1) & CORO_EVENTS_MASK;
+        coro->count_--;
+        wake = nOS_CORO_WAKE_EVENT;
+    }
+    else if ((wait & nOS_CORO_WAIT_MSG) && (coro->flags_ & CORO_MSG_PENDING))
+    {
+        coro->flags_ &= ~CORO_MSG_PENDING;
+        wake = nOS_CORO_WAKE_MSG;
+    }
+    else
+    {
+        // Armed before the timer and the resume are posted, a post from an
+        // interrupt from now on resumes it
+        coro->wait_ = wait;
+        if (0 == ticks)
+        {
+            ticks = 1;
+        }
+        coro->deadline_ = nOS_timer_now () + ticks;
+    }
+    nOS_INTERRUPTS_UNLOCK();
+    if (wake)
+    {
+        coro->wake_ = wake;
+        return 0;
+    }
+
+    if (wait & nOS_CORO_WAIT_TIMER)
+    {
+        timer = nOS_timer_start (coro->prio_, CORO_TASK, coro->id_, ticks, 0);
+        if (nOS_TIMER_INVALID == timer)
+        {
+            wake = nOS_CORO_WAKE_ERR;
+        }
+        coro->timer_ = timer;
+    }
+    if ((wait & nOS_CORO_WAIT_READY) && (nOS_OK != coro_resume (coro)))
+    {
+        wake = nOS_CORO_WAKE_ERR;
+    }
+    if (wake)
+    {
+        // Go on without waiting, what was posted meanwhile stays for the next
+        // await
+        nOS_INTERRUPTS_LOCK();
+        coro->wait_ = 0;
+        nOS_INTERRUPTS_UNLOCK();
+        coro->wake_ = wake;
+        return 0;
+    }
+
+    return 1;
+}
+
+void nOS_coro_dispatch (uint8_t id)
+{
+    nOS_coro_t *coro;
+    nOS_timer_t timer = nOS_TIMER_INVALID;
+    uint8_t wait, wake = 0;
+
+    nOS_INTERRUPTS_LOCK();
+    coro = coro_vars.coros_[id];
+    if (NULL != coro)
+    {
+        coro->flags_ &= ~CORO_SCHEDULED;
+        wait = coro->wait_;
+        if (wait & nOS_CORO_WAIT_READY)
+        {
+            wake = nOS_CORO_WAKE_READY;
+        }
+        else if ((wait & nOS_CORO_WAIT_EVENT) && coro->count_)
+        {
+            coro->event_ = coro->events_[coro->head_];
+            coro->head_ = (coro->head_ + 1) & CORO_EVENTS_MASK;
+            coro->count_--;
+            wake = nOS_CORO_WAKE_EVENT;
+        }
+        else if ((wait & nOS_CORO_WAIT_MSG)
+                && (coro->flags_ & CORO_MSG_PENDING))
+        {
+            coro->flags_ &= ~CORO_MSG_PENDING;
+            wake = nOS_CORO_WAKE_MSG;
+        }
+        else if ((wait & nOS_CORO_WAIT_TIMER)
+                && ((int32_t) (nOS_timer_now () - coro->deadline_) >= 0))
+        {
+            // The timer is free once it fired
+            coro->timer_ = nOS_TIMER_INVALID;
+            wake = nOS_CORO_WAKE_TIMEOUT;
+        }
+        if (wake)
+        {
+            timer = coro->timer_;
+            coro->timer_ = nOS_TIMER_INVALID;
+            coro->wait_ = 0;
+            coro->wake_ = wake;
+        }
+    }
+    nOS_INTERRUPTS_UNLOCK();
+
+    if (wake)
+    {
+        if (nOS_TIMER_INVALID != timer)
+        {
+            // Too late if it already fired, its resume will be ignored
+            nOS_timer_cancel (timer);
+        }
+        coro->fn_ (coro);
+    }
+}
+
+/* ------------------------------------------------------------- */
+/* Private function */
+/* ------------------------------------------------------------- */
+static nOS_err_t coro_resume (nOS_coro_t *coro)
+{
+    return nOS_task_enqueue (coro->prio_, CORO_TASK, coro->id_);
+}
+
+static nOS_err_t coro_post (nOS_coro_t *coro, uint8_t wait)
+{
+    nOS_err_t err = nOS_OK;
+    uint8_t resume = 0;
+
+    // Called with the interrupts locked, a single resume task is queued for
+    // all the posts until it runs
+    if ((coro->wait_ & wait) && !(coro->flags_ & CORO_SCHEDULED))
+    {
+        coro->flags_ |= CORO_SCHEDULED;
+        resume = 1;
+    }
+    nOS_INTERRUPTS_UNLOCK();
+
+    if (resume)
+    {
+        err = coro_resume (coro);
+        if (nOS_OK != err)
+        {
+            nOS_INTERRUPTS_LOCK();
+            coro->flags_ &= ~CORO_SCHEDULED;
+            nOS_INTERRUPTS_UNLOCK();
+        }
+    }
+
+    return err;
+}
+
+#endif /* nOS_CORO */
@@ -0,0 +1,246 @@
+/**
+ * @file nanoCoro.h
+ * @author Ehud Frank
+ * @date 17 Oct 2026
+ * @brief Stackless coroutines of the nanoRTOS, enabled by nOS_CORO.
+ * A coroutine is a multi step flow, e.g. send a command, wait for its ack or
+ * a timeout, retry, written as one function instead of a state machine over
+ * several tasks. It awaits an event (nOS_coro_post), a message
+ * (nOS_coro_post_msg) or a number of ticks and is resumed by a task of its
+ * priority, queued and dispatched by nOS_schedule like any other task.
+ * A coroutine has no stack of its own, its state is the nOS_coro_t of the
+ * application (about 32 bytes on a 32 bit MCU). Its locals are lost at
+ * every await, keep the state that spans an await in a structure that
+ * embeds the nOS_coro_t:
+ *
+ * typedef struct { nOS_coro_t coro_; uint8_t tries_; } ping_t;
+ *
+ * static void ping_flow (nOS_coro_t *coro)
+ * {
+ *     ping_t *ping = (ping_t *) coro;
+ *
+ *     nOS_CORO_BEGIN(coro);
+ *     for (ping->tries_ = 0; ping->tries_ < 3; ping->tries_++)
+ *     {
+ *         uart_send (PING);
+ *         nOS_CORO_AWAIT_EVENT_FOR(coro, 100);
+ *         if ((nOS_CORO_WAKE_EVENT == coro->wake_) && (ACK == coro->event_))
+ *         {
+ *             break;
+ *         }
+ *     }
+ *     nOS_CORO_END(coro);
+ * }
+ *
+ * nOS_coro_start (&ping.coro_, 3, ping_flow);
+ * nOS_coro_post (&ping.coro_, ACK);             // e.g. from the UART ISR
+ *
+ * The await macros resume by a switch on the line, so a coroutine awaits at
+ * most once per source line and shall not await inside a switch of its own.
+ * nanoCoro.hpp has the same coroutines as C++20 co_await.
+ */
+
+#ifndef NANOCORO_H_
+#define NANOCORO_H_
+
+#include "nanoRTOS.h"
+#include "nanoTimer.h"
+
+#if nOS_CORO
+/**
+ * @brief What a coroutine waits for, nOS_coro_t wait_
+ */
+#define nOS_CORO_WAIT_READY     0x01 // The next turn of its priority
+#define nOS_CORO_WAIT_EVENT     0x02 // An event of nOS_coro_post
+#define nOS_CORO_WAIT_MSG       0x04 // A message of nOS_coro_post_msg
+#define nOS_CORO_WAIT_TIMER     0x08 // The deadline, alone or as a timeout
+
+/**
+ * @brief Why a coroutine was resumed, nOS_coro_t wake_
+ */
+typedef enum
+{
+    nOS_CORO_WAKE_READY = 1, // Its start or nOS_CORO_YIELD
+    nOS_CORO_WAKE_EVENT,     // An event, in event_
+    nOS_CORO_WAKE_MSG,       // A message, in msg_
+    nOS_CORO_WAKE_TIMEOUT,   // The deadline passed
+    nOS_CORO_WAKE_ERR        // No timer or task queue room to await with
+} nOS_coro_wake_t;
+
+typedef struct nOS_coro nOS_coro_t;
+
+/**
+ * @brief The function of a coroutine, called again on every resume
+ * @param coro- The coroutine
+ */
+typedef void (*nOS_coro_fn_t) (nOS_coro_t *coro);
+
+/**
+ * @brief The state of a coroutine, owned by the application. The fields are
+ * set by the kernel, the coroutine reads event_, msg_ and wake_ after an
+ * await.
+ */
+struct nOS_coro
+{
+    nOS_coro_fn_t fn_;
+    void *msg_;             // The last message received
+    nOS_tick_t deadline_;   // The tick of the timeout of the wait
+    nOS_timer_t timer_;     // The timer of the timeout, nOS_TIMER_INVALID if none
+    unsigned int line_;     // The resume point, the line of the await
+    nOS_prio_t prio_;
+    uint8_t id_;            // The slot, the event of the dispatcher task
+    uint8_t wait_;          // nOS_CORO_WAIT_xxx flags, 0 while it runs
+    uint8_t wake_;          // nOS_coro_wake_t of the last resume
+    uint8_t flags_;         // Private
+    uint8_t event_;         // The last event received
+    uint8_t head_;          // The oldest event of the mailbox
+    uint8_t count_;         // The events in the mailbox
+    uint8_t events_[nOS_CORO_EVENTS];
+};
+
+/**
+ * @brief A function to start a coroutine, it runs first on the next turn of
+ * its priority
+ * @param coro- The coroutine state, it shall stay valid until the coroutine
+ * ended or was killed
+ * @param prio- The priority of its resumes
+ * @param fn- The function of the coroutine
+ * @return nOS_OK, nOS_TASK_ERR, nOS_PRIORITY_ERR, nOS_CORO_ERR when it is
+ * running or all the nOS_CORO_SLOTS are taken, or the error of the post
+ */
+nOS_err_t nOS_coro_start (nOS_coro_t *coro, nOS_prio_t prio, nOS_coro_fn_t fn);
+
+/**
+ * @brief A function to post an event to a coroutine, it resumes the
+ * coroutine if it awaits an event and is kept in its mailbox otherwise
+ * @param coro- The coroutine
+ * @param event- The event
+ * @return nOS_OK, nOS_CORO_ERR if the coroutine is not running,
+ * nOS_TASK_QUEUE_ERR if its mailbox is full, or the error of the post of its
+ * resume, then the event is kept and the next post retries the resume
+ * @note Can be called from interrupts.
+ */
+nOS_err_t nOS_coro_post (nOS_coro_t *coro, uint8_t event);
+
+/**
+ * @brief A function to post a message to a coroutine, a coroutine holds one
+ * message that it did not receive yet
+ * @param coro- The coroutine
+ * @param msg- The message, owned by the coroutine once it is received
+ * @return nOS_OK, nOS_CORO_ERR if the coroutine is not running,
+ * nOS_TASK_QUEUE_ERR if it holds a message, or the error of the post of its
+ * resume as for nOS_coro_post
+ * @note Can be called from interrupts.
+ */
+nOS_err_t nOS_coro_post_msg (nOS_coro_t *coro, void *msg);
+
+/**
+ * @brief A function to end a coroutine, its timeout is cancelled and its
+ * resumes already queued are ignored
+ * @param coro- The coroutine
+ * @return nOS_OK or nOS_CORO_ERR if it is not running
+ */
+nOS_err_t nOS_coro_kill (nOS_coro_t *coro);
+
+/**
+ * @brief A function to check if a coroutine is running
+ * @param coro- The coroutine
+ * @return 1 from nOS_coro_start until it ended or was killed, 0 otherwise
+ */
+uint8_t nOS_coro_running (const nOS_coro_t *coro);
+
+/**
+ * @brief The start of the body of a coroutine function
+ */
+#define nOS_CORO_BEGIN(coro)\
+    switch ((coro)->line_)\
+    {\
+        case 0:
+
+/**
+ * @brief The end of the body of a coroutine function, the coroutine ends
+ * when it gets there
+ */
+#define nOS_CORO_END(coro)\
+    }\
+    nOS_coro_kill (coro);\
+    return
+
+/**
+ * @brief A macro to await one of the nOS_CORO_WAIT_xxx, the function returns
+ * and is resumed after the macro. nOS_coro_wait returns 0 when there is
+ * nothing to wait for.
+ */
+#define nOS_CORO_AWAIT(coro, wait, ticks)\
+    do\
+    {\
+        if (nOS_coro_wait ((coro), (wait), (ticks)))\
+        {\
+            (coro)->line_ = __LINE__;\
+            return;\
+            case __LINE__:;\
+        }\
+    } while (0)
+
+/**
+ * @brief A macro to let the other tasks of the priority run first
+ */
+#define nOS_CORO_YIELD(coro)\
+    nOS_CORO_AWAIT(coro, nOS_CORO_WAIT_READY, 0)
+
+/**
+ * @brief A macro to await an event, in event_
+ */
+#define nOS_CORO_AWAIT_EVENT(coro)\
+    nOS_CORO_AWAIT(coro, nOS_CORO_WAIT_EVENT, 0)
+
+/**
+ * @brief A macro to await an event for up to ticks, wake_ tells which came
+ */
+#define nOS_CORO_AWAIT_EVENT_FOR(coro, ticks)\
+    nOS_CORO_AWAIT(coro, nOS_CORO_WAIT_EVENT | nOS_CORO_WAIT_TIMER, ticks)
+
+/**
+ * @brief A macro to await a message, in msg_
+ */
+#define nOS_CORO_AWAIT_MSG(coro)\
+    nOS_CORO_AWAIT(coro, nOS_CORO_WAIT_MSG, 0)
+
+/**
+ * @brief A macro to await a message for up to ticks, wake_ tells which came
+ */
+#define nOS_CORO_AWAIT_MSG_FOR(coro, ticks)\
+    nOS_CORO_AWAIT(coro, nOS_CORO_WAIT_MSG | nOS_CORO_WAIT_TIMER, ticks)
+
+/**
+ * @brief A macro to sleep for ticks, the events and messages posted
+ * meanwhile are kept
+ */
+#define nOS_CORO_SLEEP(coro, ticks)\
+    nOS_CORO_AWAIT(coro, nOS_CORO_WAIT_TIMER, ticks)
+
+/* ------------------------------------------------------------- */
+/* Kernel hooks */
+/* ------------------------------------------------------------- */
+/**
+ * @brief Called by nOS_start to free all the slots
+ */
+void nOS_coro_init (void);
+/**
+ * @brief Called by the await macros, it takes an event or a message that is
+ * already there, otherwise it arms the wait
+ * @param wait- nOS_CORO_WAIT_xxx flags
+ * @param ticks- The sleep or the timeout with nOS_CORO_WAIT_TIMER
+ * @return 1 when the coroutine shall return to be resumed later, 0 when it
+ * goes on at once (wake_ tells why)
+ */
+uint8_t nOS_coro_wait (nOS_coro_t *coro, uint8_t wait, nOS_tick_t ticks);
+/**
+ * @brief The callback of the resume tasks, it resumes the coroutine when what
+ * it waits for is there. With nOS_TASK_TABLE list it in the table.
+ * @param id- The slot of the coroutine
+ */
+void nOS_coro_dispatch (uint8_t id);
+#endif
+
+#endif /* NANOCORO_H_ */
@@ -0,0 +1,336 @@
+/**
+ * @file nanoCoro.hpp
+ * @author Ehud Frank
+ * @date 17 Oct 2026
+ * @brief The coroutines of nanoCoro.h as C++20 coroutines, an nOS::Task
+ * function co_awaits nOS::event, nOS::msg, nOS::sleep and the like and is
+ * resumed by the nOS_coro_dispatch tasks of its priority, as a C coroutine.
+ * The locals live in the coroutine frame, not on a stack, the frame is
+ * allocated with nOS_CORO_FRAME_ALLOC (operator new by default, e.g. map it
+ * to nOS_pool_alloc) and freed when the flow returns.
+ *
+ * static nOS::Coro ping;
+ *
+ * static nOS::Task ping_flow (void)
+ * {
+ *     for (uint8_t tries = 0; tries < 3; tries++)
+ *     {
+ *         uart_send (PING);
+ *         nOS::Wake wake = co_await nOS::event_for (100);
+ *         if (wake && (ACK == wake.event))
+ *         {
+ *             break;
+ *         }
+ *     }
+ * }
+ *
+ * ping.start (3, ping_flow ());
+ * ping.post (ACK);                              // e.g. from the UART ISR
+ *
+ * Needs nOS_CORO and a compiler with coroutines (-std=c++20), it is empty
+ * otherwise.
+ */
+
+#ifndef NANOCORO_HPP_
+#define NANOCORO_HPP_
+
+extern "C"
+{
+#include "nanoCoro.h"
+}
+
+#if nOS_CORO && defined(__cpp_impl_coroutine)
+#include <coroutine>
+#include <new>
+#include <type_traits>
+
+/**
+ * @brief The allocation of the coroutine frames, NULL when out of memory
+ * (then start returns nOS_CORO_ERR)
+ */
+#ifndef nOS_CORO_FRAME_ALLOC
+#define nOS_CORO_FRAME_ALLOC(size)  ::operator new (size, std::nothrow)
+#define nOS_CORO_FRAME_FREE(frame)  ::operator delete (frame)
+#endif
+
+namespace nOS
+{
+
+class Coro;
+
+/**
+ * @brief What resumed a co_await, the nOS_coro_t fields after it
+ */
+struct Wake
+{
+    uint8_t reason; // nOS_coro_wake_t
+    uint8_t event;  // The event, with nOS_CORO_WAKE_EVENT
+    void *msg;      // The message, with nOS_CORO_WAKE_MSG
+
+    /**
+     * @brief False after a timeout or nOS_CORO_WAKE_ERR
+     */
+    explicit operator bool () const
+    {
+        return (nOS_CORO_WAKE_TIMEOUT != reason) && (nOS_CORO_WAKE_ERR != reason);
+    }
+};
+
+/**
+ * @brief The return type of a coroutine function, run it with Coro::start
+ */
+class Task
+{
+public:
+    struct promise_type
+    {
+        Coro *coro_ = nullptr;
+
+        static void *operator new (size_t size) noexcept
+        {
+            return nOS_CORO_FRAME_ALLOC(size);
+        }
+        static void operator delete (void *frame) noexcept
+        {
+            nOS_CORO_FRAME_FREE(frame);
+        }
+        static Task get_return_object_on_allocation_failure () noexcept
+        {
+            return Task ();
+        }
+        Task get_return_object () noexcept
+        {
+            return Task (std::coroutine_handle<promise_type>::from_promise (*this));
+        }
+        // Started by Coro::start, freed once it returned
+        std::suspend_always initial_suspend () noexcept
+        {
+            return {};
+        }
+        std::suspend_never final_suspend () noexcept
+        {
+            return {};
+        }
+        void return_void () noexcept;
+        void unhandled_exception () noexcept
+        {
+            return_void ();
+        }
+    };
+
+    Task () : handle_ ()
+    {
+    }
+    Task (Task &&other) noexcept : handle_ (other.handle_)
+    {
+        other.handle_ = nullptr;
+    }
+    ~Task ()
+    {
+        // Never started
+        if (handle_)
+        {
+            handle_.destroy ();
+        }
+    }
+    Task (const Task &) = delete;
+    Task &operator= (const Task &) = delete;
+
+private:
+    friend class Coro;
+
+    explicit Task (std::coroutine_handle<promise_type> handle) : handle_ (handle)
+    {
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+/**
+ * @brief A coroutine, the nOS_coro_t of a Task. It outlives the flows it
+ * runs, so posts after the end fail with nOS_CORO_ERR instead of reaching a
+ * freed frame.
+ */
+class Coro
+{
+public:
+    Coro () : coro_ (), handle_ ()
+    {
+    }
+    Coro (const Coro &) = delete;
+    Coro &operator= (const Coro &) = delete;
+
+    /**
+     * @brief Runs the flow, first on the next turn of prio
+     * @return As nOS_coro_start, nOS_CORO_ERR if the frame was not allocated.
+     * The flow is freed on an error.
+     */
+    nOS_err_t start (nOS_prio_t prio, Task task)
+    {
+        nOS_err_t err;
+
+        if (!task.handle_)
+        {
+            return nOS_CORO_ERR;
+        }
+        task.handle_.promise ().coro_ = this;
+        err = nOS_coro_start (&coro_, prio, resume);
+        if (nOS_OK == err)
+        {
+            handle_ = task.handle_;
+            task.handle_ = nullptr;
+        }
+        return err;
+    }
+
+    /**
+     * @brief nOS_coro_post, can be called from interrupts
+     */
+    nOS_err_t post (uint8_t event)
+    {
+        return nOS_coro_post (&coro_, event);
+    }
+
+    /**
+     * @brief nOS_coro_post_msg, can be called from interrupts
+     */
+    nOS_err_t post_msg (void *msg)
+    {
+        return nOS_coro_post_msg (&coro_, msg);
+    }
+
+    /**
+     * @brief Ends the flow where it awaits and frees it, not from the flow
+     * itself (a flow ends by returning)
+     */
+    nOS_err_t kill ()
+    {
+        nOS_err_t err = nOS_coro_kill (&coro_);
+
+        if (nOS_OK == err)
+        {
+            handle_.destroy ();
+            handle_ = nullptr;
+        }
+        return err;
+    }
+
+    bool running () const
+    {
+        return 0 != nOS_coro_running (&coro_);
+    }
+
+    /**
+     * @brief The nOS_coro_t, for the C modules to post to
+     */
+    nOS_coro_t *native ()
+    {
+        return &coro_;
+    }
+
+private:
+    friend struct Task::promise_type;
+
+    // The fn_ of the nOS_coro_t, coro_ is the first member
+    static void resume (nOS_coro_t *coro)
+    {
+        reinterpret_cast<Coro *> (coro)->handle_.resume ();
+    }
+
+    nOS_coro_t coro_;
+    std::coroutine_handle<> handle_;
+};
+
+static_assert (std::is_standard_layout<Coro>::value,
+               "Coro::resume casts the nOS_coro_t back to its Coro");
+
+inline void Task::promise_type::return_void () noexcept
+{
+    // The frame is freed by final_suspend right after
+    nOS_coro_kill (&coro_->coro_);
+    coro_->handle_ = nullptr;
+}
+
+/**
+ * @brief The awaiter of the nOS_CORO_WAIT_xxx, see nOS_CORO_AWAIT
+ */
+class Await
+{
+public:
+    Await (uint8_t wait, nOS_tick_t ticks) : coro_ (nullptr), wait_ (wait), ticks_ (ticks)
+    {
+    }
+    bool await_ready () const noexcept
+    {
+        return false;
+    }
+    // Suspended unless what it awaits is already there
+    bool await_suspend (std::coroutine_handle<Task::promise_type> handle) noexcept
+    {
+        coro_ = handle.promise ().coro_->native ();
+        return 0 != nOS_coro_wait (coro_, wait_, ticks_);
+    }
+    Wake await_resume () const noexcept
+    {
+        return Wake { coro_->wake_, coro_->event_, coro_->msg_ };
+    }
+
+private:
+    nOS_coro_t *coro_;
+    uint8_t wait_;
+    nOS_tick_t ticks_;
+};
+
+/**
+ * @brief Lets the other tasks of the priority run first
+ */
+inline Await yield ()
+{
+    return Await (nOS_CORO_WAIT_READY, 0);
+}
+
+/**
+ * @brief Awaits an event, Wake::event
+ */
+inline Await event ()
+{
+    return Await (nOS_CORO_WAIT_EVENT, 0);
+}
+
+/**
+ * @brief Awaits an event for up to ticks, false on the timeout
+ */
+inline Await event_for (nOS_tick_t ticks)
+{
+    return Await (nOS_CORO_WAIT_EVENT | nOS_CORO_WAIT_TIMER, ticks);
+}
+
+/**
+ * @brief Awaits a message, Wake::msg
+ */
+inline Await msg ()
+{
+    return Await (nOS_CORO_WAIT_MSG, 0);
+}
+
+/**
+ * @brief Awaits a message for up to ticks, false on the timeout
+ */
+inline Await msg_for (nOS_tick_t ticks)
+{
+    return Await (nOS_CORO_WAIT_MSG | nOS_CORO_WAIT_TIMER, ticks);
+}
+
+/**
+ * @brief Sleeps for ticks, the events and messages posted meanwhile are kept
+ */
+inline Await sleep (nOS_tick_t ticks)
+{
+    return Await (nOS_CORO_WAIT_TIMER, ticks);
+}
+
+} // namespace nOS
+
+#endif /* nOS_CORO && __cpp_impl_coroutine */
+
+#endif /* NANOCORO_HPP_ */
@@ -0,0 +1,330 @@
+/**
+ * @file nanoPool.c
+ * @author Ehud Frank
+ * Description Fixed block memory pool, see nanoPool.h.
+ * Every class is a stack of free blocks linked by their number. The stack
+ * head holds a tag above the number of the top block, every push and pop
+ * changes the tag, so a pop that raced with a pop and a push of the same
+ * block fails its compare and swap instead of corrupting the list (ABA).
+ * Every header also tells if its block is free, so a second free of a block
+ * is rejected, and counts the posts of the block, so the dispatch of a block
+ * frees it only if the callback did not hand it over.
+ * @date 17 Oct 2026
+ */
+
+#include "nanoPool.h"
+#include "nanoAtomic.h"
+#include "string.h"
+
+#if nOS_MSG_POOL
+
+#define POOL_NONE       0xFFFF     // The end of a free list
+#define POOL_INDEX_MASK 0xFFFF
+#define POOL_TAG_ONE    0x10000
+
+/**
+ * The header in front of every block
+ */
+typedef struct
+{
+    nOS_msg_callback_t callback_; // Posted, the task to call
+    uint16_t next_;               // Free, the next free block of the class
+    uint16_t posts_;              // Counts the posts, wraps around
+    uint16_t free_;               // 1 while in the free stack
+} pool_header_t;
+
+// Keeps the blocks 8 bytes aligned
+#define POOL_HEADER_BYTES       ((sizeof(pool_header_t) + 7) & ~7u)
+#define POOL_BLOCK_BYTES(bytes) (POOL_HEADER_BYTES + (((bytes) + 7) & ~7u))
+#define POOL_MSG(header)        ((uint8_t *) (header) + POOL_HEADER_BYTES)
+
+/**
+ * A block size class
+ */
+typedef struct
+{
+    uint8_t *blocks_;     // The header of the first block
+    uint16_t stride_;     // The bytes from a header to the next one
+    uint16_t first_;      // The number of the first block in the whole pool
+    uint32_t free_;       // The free stack head, a tag above a block index
+    nOS_pool_stats_t stats_;
+} pool_class_t;
+
+#define POOL_STORAGE_ENTRY(bytes, blocks) + (blocks) * POOL_BLOCK_BYTES(bytes)
+#define POOL_CLASS_ENTRY(bytes, blocks) { (bytes), (blocks) },
+
+static const struct
+{
+    uint16_t bytes_;
+    uint16_t blocks_;
+} pool_config_[nOS_POOL_CLASS_COUNT] = { nOS_POOL_CLASSES(POOL_CLASS_ENTRY) };
+
+static uint64_t pool_storage_[(0 nOS_POOL_CLASSES(POOL_STORAGE_ENTRY)) / 8];
+static pool_class_t pool_classes_[nOS_POOL_CLASS_COUNT];
+
+/**
+ * @brief A function to pop a free block of a class
+ * @return The header of the block, NULL if the class is empty
+ */
+static pool_header_t *pool_pop (pool_class_t *pool);
+/**
+ * @brief A function to push a block back on the free stack of its class
+ * @return nOS_OK or nOS_POOL_ERR if the block is free already
+ */
+static nOS_err_t pool_push (pool_class_t *pool, pool_header_t *header);
+/**
+ * @brief A function to find the class and the header of a block
+ * @return The class, NULL if msg is not a pool block
+ */
+static pool_class_t *pool_lookup (void *msg, pool_header_t **header);
+/**
+ * @brief A function to find the class and the header of a block number
+ * @return The class of the block
+ */
+static pool_class_t *pool_block (uint8_t block, pool_header_t **header);
+
+void nOS_pool_init (void)
+{
+    uint8_t *blocks = (uint8_t *) pool_storage_;
+    pool_header_t *header;
+    uint16_t first = 0;
+    uint16_t i;
+    uint16_t j;
+
+    nOS_INTERRUPTS_LOCK();
+    memset (pool_classes_, 0, sizeof(pool_classes_));
+    for (i = 0; i < nOS_POOL_CLASS_COUNT; i++)
+    {
+        pool_class_t *pool = &pool_classes_[i];
+
+        pool->blocks_ = blocks;
+        pool->stride_ = (uint16_t) POOL_BLOCK_BYTES(pool_config_[i].bytes_);
+        pool->first_ = first;
+        pool->stats_.block_size_ = pool_config_[i].bytes_;
+        pool->stats_.blocks_ = pool_config_[i].blocks_;
+        // Chain the blocks in order, block 0 on top
+        for (j = 0; j < pool_config_[i].blocks_; j++)
+        {
+            header = (pool_header_t *) (blocks + j * pool->stride_);
+            header->next_ = (j + 1 < pool_config_[i].blocks_) ? j + 1 : POOL_NONE;
+            header->free_ = 1;
+        }
+        pool->free_ = pool_config_[i].blocks_ ? 0 : POOL_NONE;
+        blocks += pool_config_[i].blocks_ * pool->stride_;
+        first += pool_config_[i].blocks_;
+    }
+    nOS_INTERRUPTS_UNLOCK();
+}
+
+void *nOS_pool_alloc (uint16_t size)
+{
+    pool_class_t *pool;
+    pool_header_t *header;
+    uint16_t used;
+    uint8_t i;
+
+    for (i = 0; i < nOS_POOL_CLASS_COUNT; i++)
+    {
+        pool = &pool_classes_[i];
+        if (size > pool->stats_.block_size_)
+        {
+            continue;
+        }
+        header = pool_pop (pool);
+        if (NULL == header)
+        {
+            nOS_ATOMIC_FETCH_ADD(&pool->stats_.failures_, 1);
+            continue;
+        }
+        used = (uint16_t) (nOS_ATOMIC_FETCH_ADD(&pool->stats_.used_, 1) + 1);
+        nOS_ATOMIC_RAISE(&pool->stats_.high_water_, used);
+        return POOL_MSG(header);
+    }
+
+    return NULL;
+}
+
+nOS_err_t nOS_pool_free (void *msg)
+{
+    pool_header_t *header;
+    pool_class_t *pool = pool_lookup (msg, &header);
+
+    if (NULL == pool)
+    {
+        return nOS_POOL_ERR;
+    }
+
+    return pool_push (pool, header);
+}
+
+nOS_err_t nOS_pool_stats_get (uint8_t pool_class, nOS_pool_stats_t *stats)
+{
+    if (pool_class >= nOS_POOL_CLASS_COUNT)
+    {
+        return nOS_POOL_ERR;
+    }
+    nOS_INTERRUPTS_LOCK();
+    memcpy (stats, &pool_classes_[pool_class].stats_, sizeof(*stats));
+    nOS_INTERRUPTS_UNLOCK();
+
+    return nOS_OK;
+}
+
+void nOS_pool_stats_reset (void)
+{
+    uint8_t i;
+
+    nOS_INTERRUPTS_LOCK();
+    for (i = 0; i < nOS_POOL_CLASS_COUNT; i++)
+    {
+        pool_classes_[i].stats_.high_water_ = pool_classes_[i].stats_.used_;
+        pool_classes_[i].stats_.failures_ = 0;
+    }
+    nOS_INTERRUPTS_UNLOCK();
+}
+
+uint16_t nOS_pool_attach (void *msg, nOS_msg_callback_t callback)
+{
+    pool_header_t *header;
+    pool_class_t *pool = pool_lookup (msg, &header);
+
+    if ((NULL == pool) || nOS_ATOMIC_LOAD(&header->free_))
+    {
+        return nOS_POOL_NO_BLOCK;
+    }
+    header->callback_ = callback;
+    if (NULL != callback)
+    {
+        nOS_ATOMIC_FETCH_ADD(&header->posts_, 1);
+    }
+    else
+    {
+        // The post failed, the block stays with the poster
+        nOS_ATOMIC_FETCH_SUB(&header->posts_, 1);
+    }
+
+    return (uint16_t) (pool->first_
+            + ((uint8_t *) header - pool->blocks_) / pool->stride_);
+}
+
+void nOS_pool_dispatch (uint8_t block)
+{
+    pool_header_t *header;
+    pool_class_t *pool = pool_block (block, &header);
+    nOS_msg_callback_t callback = header->callback_;
+    uint16_t posts = nOS_ATOMIC_LOAD(&header->posts_);
+
+    callback (POOL_MSG(header));
+    // A post of the block from the callback handed it over, its dispatch may
+    // even have freed it already (nested or on another core)
+    if (posts == nOS_ATOMIC_LOAD(&header->posts_))
+    {
+        pool_push (pool, header);
+    }
+}
+
+void nOS_pool_drop (uint8_t block)
+{
+    pool_header_t *header;
+    pool_class_t *pool = pool_block (block, &header);
+
+    pool_push (pool, header);
+}
+
+/* ------------------------------------------------------------- */
+/* Private function */
+/* ------------------------------------------------------------- */
+static pool_class_t *pool_block (uint8_t block, pool_header_t **header)
+{
+    pool_class_t *pool = pool_classes_;
+
+    while (block >= pool->first_ + pool->stats_.blocks_)
+    {
+        pool++;
+    }
+    *header = (pool_header_t *) (pool->blocks_
+            + (block - pool->first_) * pool->stride_);
+
+    return pool;
+}
+
+static pool_header_t *pool_pop (pool_class_t *pool)
+{
+    uint32_t head = nOS_ATOMIC_LOAD(&pool->free_);
+    pool_header_t *header;
+    uint32_t next;
+
+    do
+    {
+        if (POOL_NONE == (head & POOL_INDEX_MASK))
+        {
+            return NULL;
+        }
+        header = (pool_header_t *) (pool->blocks_
+                + (head & POOL_INDEX_MASK) * pool->stride_);
+        // The block may be taken meanwhile, then the tag changed and the
+        // compare and swap fails whatever the link read here
+        next = ((head & ~POOL_INDEX_MASK) + POOL_TAG_ONE)
+                | nOS_ATOMIC_LOAD_RELAXED(&header->next_);
+    }
+    while (!nOS_ATOMIC_CAS(&pool->free_, &head, next));
+    nOS_ATOMIC_STORE(&header->free_, 0);
+
+    return header;
+}
+
+static nOS_err_t pool_push (pool_class_t *pool, pool_header_t *header)
+{
+    uint32_t index = (uint32_t) ((uint8_t *) header - pool->blocks_)
+            / pool->stride_;
+    uint32_t head;
+    uint32_t next;
+    uint16_t used = 0;
+
+    // Of two frees of the same block only the first gets here
+    if (!nOS_ATOMIC_CAS(&header->free_, &used, 1))
+    {
+        return nOS_POOL_ERR;
+    }
+    head = nOS_ATOMIC_LOAD(&pool->free_);
+    do
+    {
+        nOS_ATOMIC_STORE_RELAXED(&header->next_,
+                                 (uint16_t) (head & POOL_INDEX_MASK));
+        next = ((head & ~POOL_INDEX_MASK) + POOL_TAG_ONE) | index;
+    }
+    while (!nOS_ATOMIC_CAS(&pool->free_, &head, next));
+    nOS_ATOMIC_FETCH_SUB(&pool->stats_.used_, 1);
+
+    return nOS_OK;
+}
+
+static pool_class_t *pool_lookup (void *msg, pool_header_t **header)
+{
+    uint8_t *block = (uint8_t *) msg - POOL_HEADER_BYTES;
+    pool_class_t *pool;
+    uint8_t i;
+
+    if (NULL == msg)
+    {
+        return NULL;
+    }
+    for (i = 0; i < nOS_POOL_CLASS_COUNT; i++)
+    {
+        pool = &pool_classes_[i];
+        if ((block >= pool->blocks_)
+                && (block < pool->blocks_
+                        + pool->stats_.blocks_ * pool->stride_))
+        {
+            if (0 != (block - pool->blocks_) % pool->stride_)
+            {
+                return NULL;
+            }
+            *header = (pool_header_t *) block;
+            return pool;
+        }
+    }
+
+    return NULL;
+}
+#endif
@@ -0,0 +1,98 @@
+/**
+ * @file nanoPool.h
+ * @author Ehud Frank
+ * @date 17 Oct 2026
+ * @brief Fixed block memory pool of the nanoRTOS, enabled by nOS_MSG_POOL.
+ * The blocks come in the size classes of nOS_POOL_CLASSES, each class keeps
+ * its free blocks in a lock free stack, so alloc and free are O(1) (a few
+ * compare and swap retries at most) and can be called from interrupts.
+ * The blocks carry the payloads of the message tasks, see nOS_task_post_msg.
+ */
+
+#ifndef NANOPOOL_H_
+#define NANOPOOL_H_
+
+#include "nanoRTOS.h"
+
+#if nOS_MSG_POOL
+/**
+ * @brief Not a pool block, returned by nOS_pool_attach
+ */
+#define nOS_POOL_NO_BLOCK   0xFFFF
+
+/**
+ * @brief The usage statistics of one block size class
+ */
+typedef struct
+{
+    uint16_t block_size_; // The payload bytes of a block
+    uint16_t blocks_;     // The number of blocks of the class
+    uint16_t used_;       // The blocks allocated now
+    uint16_t high_water_; // The most blocks allocated at once
+    uint32_t failures_;   // The allocations that found the class empty
+} nOS_pool_stats_t;
+
+/**
+ * @brief A function to initialise the pool, all the blocks are free
+ * @note This function is called by nOS_start.
+ */
+void nOS_pool_init (void);
+
+/**
+ * @brief A function to allocate a block
+ * The smallest class the size fits in is tried first, when it is empty the
+ * next larger classes are tried.
+ * @param size- The bytes needed
+ * @return The block, 8 bytes aligned, or NULL if no class has a free block
+ * that fits
+ */
+void *nOS_pool_alloc (uint16_t size);
+
+/**
+ * @brief A function to return a block to its class
+ * @param msg- A block from nOS_pool_alloc
+ * @return nOS_OK or nOS_POOL_ERR if msg is not a pool block or is free
+ * already
+ * @note A block posted with nOS_task_post_msg is freed by the kernel.
+ */
+nOS_err_t nOS_pool_free (void *msg);
+
+/**
+ * @brief A function to read the usage statistics of a block size class
+ * @param pool_class- The class index, in the nOS_POOL_CLASSES order
+ * @param stats- Output, a copy of the statistics
+ * @return nOS_OK or nOS_POOL_ERR
+ */
+nOS_err_t nOS_pool_stats_get (uint8_t pool_class, nOS_pool_stats_t *stats);
+
+/**
+ * @brief A function to clear the high water marks and the failure counts
+ */
+void nOS_pool_stats_reset (void);
+
+/* ------------------------------------------------------------- */
+/* Kernel hooks */
+/* ------------------------------------------------------------- */
+/**
+ * @brief Called by nOS_task_post_msg to bind the callback to the block, NULL
+ * unbinds it again when the post failed
+ * @return The block number, or nOS_POOL_NO_BLOCK if msg is not a pool block
+ * or is free
+ */
+uint16_t nOS_pool_attach (void *msg, nOS_msg_callback_t callback);
+/**
+ * @brief The callback of the queued message tasks, it calls the bound
+ * callback with the block and frees the block afterwards, unless the
+ * callback posted the block again
+ * @param block- The block number
+ */
+void nOS_pool_dispatch (uint8_t block);
+/**
+ * @brief Called by the kernel for a message task dropped by the
+ * nOS_OVERFLOW_DROP_OLDEST policy, it frees the block without calling back
+ * @param block- The block number
+ */
+void nOS_pool_drop (uint8_t block);
+#endif
+
+#endif /* NANOPOOL_H_ */
@@ -0,0 +1,45 @@
+/**
+ * @file nanoPort.h
+ * @author Ehud Frank
+ * @date 17 Oct 2026
+ * @brief The hooks a port layer provides to the nanoRTOS.
+ * Only the hooks of the enabled features (see nanoConfig.h) shall be provided.
+ */
+
+#ifndef NANOPORT_H_
+#define NANOPORT_H_
+
+#include "nanoTimer.h"
+
+#if nOS_TICKLESS_IDLE
+/**
+ * @brief Tickless idle hook, puts the MCU to sleep until wake_tick or until an
+ * interrupt occurs, whichever comes first.
+ * It is called with interrupts locked and shall return with interrupts locked,
+ * a pending interrupt shall still wake the MCU (e.g. WFI with PRIMASK set).
+ * The port stops the periodic tick, programs a wake up timer for
+ * wake_tick - nOS_timer_now() ticks and measures the ticks actually slept.
+ * @param wake_tick- The tick of the next timer expiry or nOS_TICK_FOREVER
+ * @return The number of ticks that elapsed during the sleep
+ */
+nOS_tick_t nOS_port_sleep_until (nOS_tick_t wake_tick);
+#endif
+
+#if nOS_STATS || nOS_TRACE || nOS_BUDGET
+/**
+ * @brief Cycle counter hook, the default nOS_GET_CYCLES
+ * @return A free running 32 bit cycle counter
+ */
+uint32_t nOS_port_cycles (void);
+#endif
+
+#if (nOS_SMP_CORES > 1)
+/**
+ * @brief Core ID hook, the default nOS_CORE_ID
+ * Tasks posted without a core go to the queues of the calling core.
+ * @return The index of the calling core, from 0 to nOS_SMP_CORES - 1
+ */
+uint8_t nOS_port_core_id (void);
+#endif
+
+#endif /* NANOPORT_H_ */
@@ -0,0 +1,85 @@
+/**
+ * @file nanoProfile.c
+ * @author Ehud Frank
+ * Description Optional queue occupancy profile, see nanoProfile.h.
+ * @date 17 Oct 2026
+ */
+
+#include "nanoProfile.h"
+#include "nanoAtomic.h"
+#include "string.h"
+
+#if nOS_QUEUE_PROFILE
+
+static nOS_profile_entry_t nOS_profile_[nOS_PRIO_COUNT];
+
+nOS_err_t nOS_profile_get (nOS_prio_t prio, nOS_profile_entry_t *entry)
+{
+    if ((prio < 1) || (prio > nOS_PRIO_COUNT))
+    {
+        return nOS_PRIORITY_ERR;
+    }
+    nOS_INTERRUPTS_LOCK();
+    memcpy (entry, &nOS_profile_[prio - 1], sizeof(*entry));
+    nOS_INTERRUPTS_UNLOCK();
+
+    return nOS_OK;
+}
+
+uint32_t nOS_profile_dump (void *dump, uint32_t size)
+{
+    nOS_profile_header_t header;
+
+    if (size < nOS_PROFILE_DUMP_SIZE)
+    {
+        return 0;
+    }
+    memset (&header, 0, sizeof(header));
+    header.magic_ = nOS_PROFILE_MAGIC;
+    header.version_ = nOS_PROFILE_VERSION;
+    header.entry_size_ = (uint8_t) sizeof(nOS_profile_entry_t);
+    header.prio_count_ = (uint16_t) nOS_PRIO_COUNT;
+    header.queue_impl_ = (uint8_t) nOS_TASK_QUEUE_IMPL;
+    header.cores_ = (uint8_t) nOS_SMP_CORES;
+    memcpy (dump, &header, sizeof(header));
+    nOS_INTERRUPTS_LOCK();
+    memcpy ((uint8_t *) dump + sizeof(header), nOS_profile_, sizeof(nOS_profile_));
+    nOS_INTERRUPTS_UNLOCK();
+
+    return (uint32_t) nOS_PROFILE_DUMP_SIZE;
+}
+
+void nOS_profile_reset (void)
+{
+    uint16_t i;
+
+    nOS_INTERRUPTS_LOCK();
+    for (i = 0; i < nOS_PRIO_COUNT; i++)
+    {
+        nOS_profile_[i].peak_ = 0;
+        nOS_profile_[i].enqueued_ = 0;
+        nOS_profile_[i].overflows_ = 0;
+    }
+    nOS_INTERRUPTS_UNLOCK();
+}
+
+void nOS_profile_init (nOS_prio_t prio, uint16_t capacity)
+{
+    memset (&nOS_profile_[prio - 1], 0, sizeof(nOS_profile_[prio - 1]));
+    nOS_profile_[prio - 1].capacity_ = capacity;
+}
+
+void nOS_profile_enqueued (nOS_prio_t prio, uint16_t count, uint16_t n)
+{
+    nOS_profile_entry_t *entry = &nOS_profile_[prio - 1];
+
+    nOS_ATOMIC_FETCH_ADD(&entry->enqueued_, n);
+    nOS_ATOMIC_RAISE(&entry->peak_, count);
+}
+
+void nOS_profile_overflowed (nOS_prio_t prio)
+{
+    nOS_ATOMIC_FETCH_ADD(&nOS_profile_[prio - 1].overflows_, 1);
+}
+
+#endif /* nOS_QUEUE_PROFILE */
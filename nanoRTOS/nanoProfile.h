@@ -0,0 +1,99 @@
+/**
+ * @file nanoProfile.h
+ * @author Ehud Frank
+ * @date 17 Oct 2026
+ * @brief Optional queue occupancy profile (nOS_QUEUE_PROFILE in nanoConfig.h).
+ * The kernel records the peak number of tasks queued at each priority, the
+ * posts and the overflows. Run a profiling build through a representative
+ * load, copy the profile out with nOS_profile_dump and feed the dumps to the
+ * host tool in nanoRTOS_tune, it writes a header of the smallest safe
+ * nOS_TASK_QUEUE_LENGTHS (see nOS_QUEUE_LENGTHS_HEADER). It needs no cycle
+ * counter and runs on any port. The dump layout is declared without
+ * nOS_QUEUE_PROFILE too, for the tool.
+ */
+
+#ifndef NANOPROFILE_H_
+#define NANOPROFILE_H_
+
+#include "nanoRTOS.h"
+
+/**
+ * @brief The profile of one priority
+ */
+typedef struct
+{
+    uint16_t capacity_;  // The slots of the task queue
+    uint16_t peak_;      // The highest number of tasks queued at once
+    uint32_t enqueued_;  // The number of tasks posted
+    uint32_t overflows_; // The posts that found the queue full, the peak of a
+                         // priority that overflowed is not its real need
+} nOS_profile_entry_t;
+
+#define nOS_PROFILE_MAGIC   0x51534F6Eu // "nOSQ" in little endian
+#define nOS_PROFILE_VERSION 1
+
+/**
+ * @brief The header of a dump, an entry per priority follows it from priority
+ * 1 up. A dump is in the byte order of the target.
+ */
+typedef struct
+{
+    uint32_t magic_;      // nOS_PROFILE_MAGIC
+    uint8_t version_;     // nOS_PROFILE_VERSION
+    uint8_t entry_size_;  // sizeof(nOS_profile_entry_t)
+    uint16_t prio_count_; // nOS_PRIO_COUNT
+    uint8_t queue_impl_;  // nOS_TASK_QUEUE_IMPL, the tool rounds for it
+    uint8_t cores_;       // nOS_SMP_CORES, the peak is of the busiest core
+    uint16_t reserved_;
+} nOS_profile_header_t;
+
+/**
+ * @brief The size of a dump
+ */
+#define nOS_PROFILE_DUMP_SIZE\
+    (sizeof(nOS_profile_header_t) + nOS_PRIO_COUNT * sizeof(nOS_profile_entry_t))
+
+#if nOS_QUEUE_PROFILE
+/**
+ * @brief A function to read the profile of a priority
+ * @param prio- The priority
+ * @param entry- Output, a copy of the profile
+ * @return nOS_OK or nOS_PRIORITY_ERR
+ */
+nOS_err_t nOS_profile_get (nOS_prio_t prio, nOS_profile_entry_t *entry);
+
+/**
+ * @brief A function to copy the profile into a dump
+ * @param dump- Output, the header and the entries
+ * @param size- The size of dump in bytes
+ * @return The number of bytes written, 0 if size is below
+ * nOS_PROFILE_DUMP_SIZE
+ */
+uint32_t nOS_profile_dump (void *dump, uint32_t size);
+
+/**
+ * @brief A function to clear the profile of all the priorities, e.g. once the
+ * start up is over
+ */
+void nOS_profile_reset (void);
+
+/* ------------------------------------------------------------- */
+/* Kernel hooks */
+/* ------------------------------------------------------------- */
+/**
+ * @brief Called by nOS_start for each priority
+ */
+void nOS_profile_init (nOS_prio_t prio, uint16_t capacity);
+/**
+ * @brief Called after tasks were queued, from any context
+ * @param count- The number of tasks in the queue including the new ones
+ * @param n- The number of tasks posted
+ */
+void nOS_profile_enqueued (nOS_prio_t prio, uint16_t count, uint16_t n);
+/**
+ * @brief Called when a post found the queue full, from any context
+ */
+void nOS_profile_overflowed (nOS_prio_t prio);
+#endif
+
+#endif /* NANOPROFILE_H_ */
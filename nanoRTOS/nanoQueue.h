@@ -18,9 +18,18 @@ extern "C" {
  * int name##_is_full(name##_t* self);
  * int name##_in(name##_t* self, T* value);
  * int name##_out(name##_t* self, T* value);
+ * int name##_in_n(name##_t* self, T* values, int n);
+ * int name##_out_n(name##_t* self, T* values, int* n);
  * int name##_capacity(name##_t* self);
+ * name##_in_n copies n values in, or none when there is no room for all.
+ * name##_out_n copies up to *n values out and sets *n to the number taken.
+ * Both copy the values as (at most two) contiguous ring segments.
+ * name##_in on a full queue overwrites the oldest value, which is dropped, and
+ * returns nOS_QUEUE_OVERFLOWED, check name##_is_full first to keep it.
  */
 #include "string.h"
+#include "stdint.h"
+#include "nanoAtomic.h"
 
 /**
  * @brief Error code
@@ -43,6 +52,9 @@ extern "C" {
 #ifndef nOS_QUEUE_EMPTY
 #define nOS_QUEUE_EMPTY                 5
 #endif
+#ifndef nOS_QUEUE_BAD_CAPACITY
+#define nOS_QUEUE_BAD_CAPACITY          6
+#endif
 #ifndef nOS_QUEUE_ERR_UNKNOWN
 #define nOS_QUEUE_ERR_UNKNOWN           (-1)
 #endif
@@ -61,6 +73,8 @@ int name##_is_empty(name##_t* self);\
 int name##_is_full(name##_t* self);\
 int name##_in(name##_t* self, void* value);\
 int name##_out(name##_t* self, void* value);\
+int name##_in_n(name##_t* self, void* values, int n);\
+int name##_out_n(name##_t* self, void* values, int* n);\
 int name##_capacity(name##_t* self);
 
 #define nOS_INSTALL_QUEUE_APIs(name, T)\
@@ -97,8 +111,13 @@ int name##_in(name##_t* self, void* value)\
     if (NULL == self->values)/* Check if queue was initiates*/\
         return nOS_QUEUE_ARRAY_NULL_POINTER; /* Return error code */\
     if (self->count >= self->capacity)\
+    {\
         ret = nOS_QUEUE_OVERFLOWED;/* This is only warning */\
-        /* !!! IT IS THE USER RESPONSIBILITY TO CHECK IF QUEUE IS FULL !!! */\
+        /* Full, the oldest value is overwritten, the next one becomes the oldest */\
+        self->count--;\
+        if (++self->outdex >= self->capacity)\
+            self->outdex = 0;\
+    }\
     self->count++;\
     self->values[self->index++] = *(T*)value;\
     if (self->index >= self->capacity)\
@@ -122,11 +141,459 @@ int name##_out(name##_t* self, void* value)\
         self->outdex = 0;\
     return nOS_QUEUE_OK;\
 }\
+int name##_in_n(name##_t* self, void* values, int n)\
+{\
+    int first;\
+    \
+    if (NULL == self)/* Check if queue was initiates*/\
+        {return nOS_QUEUE_NULL_POINTER;} /* Return error code */\
+    if (NULL == self->values)/* Check if queue was initiates*/\
+        return nOS_QUEUE_ARRAY_NULL_POINTER; /* Return error code */\
+    if (self->count + n > self->capacity)\
+        return nOS_QUEUE_OVERFLOWED;/* Unlike name##_in nothing is written */\
+    first = self->capacity - self->index;/* Up to the end of the ring */\
+    if (first > n)\
+        first = n;\
+    memcpy( &self->values[self->index], values, first * sizeof(T) );\
+    memcpy( self->values, (T*)values + first, (n - first) * sizeof(T) );\
+    self->index += n;\
+    if (self->index >= self->capacity)\
+        self->index -= self->capacity;\
+    self->count += n;\
+    return nOS_QUEUE_OK;\
+}\
+int name##_out_n(name##_t* self, void* values, int* n)\
+{\
+    int first;\
+    \
+    if (NULL == self)/* Check if queue was initiates*/\
+        {return nOS_QUEUE_NULL_POINTER;} /* Return error code */\
+    if (NULL == self->values)/* Check if queue was initiates*/\
+        return nOS_QUEUE_ARRAY_NULL_POINTER; /* Return error code */\
+    if (self->count <= 0)\
+    {\
+        self->count = 0;\
+        *n = 0;\
+        return nOS_QUEUE_EMPTY;\
+    }\
+    if (*n > self->count)\
+        *n = self->count;\
+    first = self->capacity - self->outdex;/* Up to the end of the ring */\
+    if (first > *n)\
+        first = *n;\
+    memcpy( values, &self->values[self->outdex], first * sizeof(T) );\
+    memcpy( (T*)values + first, self->values, (*n - first) * sizeof(T) );\
+    self->outdex += *n;\
+    if (self->outdex >= self->capacity)\
+        self->outdex -= self->capacity;\
+    self->count -= *n;\
+    return nOS_QUEUE_OK;\
+}\
+int name##_capacity(name##_t* self)\
+{\
+    return self->capacity;\
+}
+
+/*
+ * Lock free variants of the queue above, both have:
+ * int name##_init(name##_t* self, void* values, int capacity);
+ * int name##_is_empty(name##_t* self);
+ * int name##_is_full(name##_t* self);
+ * int name##_in(name##_t* self, void* value);
+ * int name##_out(name##_t* self, void* value);
+ * int name##_capacity(name##_t* self);
+ * name##_init returns nOS_QUEUE_OK or the error of its checks. Unlike the
+ * queue above, name##_in never overwrites, it returns nOS_QUEUE_OVERFLOWED
+ * and drops the value when the queue is full. Only the multi producer queue
+ * has the bulk operations, its values array is of name##_slot_t.
+ */
+
+/*
+ * Single producer / single consumer lock free queue.
+ * The producer only writes index and the consumer only writes outdex.
+ * Both run over [0, 2 * capacity) so a full queue can be told apart from an
+ * empty one without a shared counter, and capacity does not have to be a
+ * power of two.
+ */
+#define nOS_CREATE_SPSC_QUEUE(name, T)\
+typedef struct \
+{\
+    int index;\
+    int outdex;\
+    int capacity;\
+    T* values;\
+} name##_t;\
+int name##_init(name##_t* self, void* values, int capacity);\
+int name##_is_empty(name##_t* self);\
+int name##_is_full(name##_t* self);\
+int name##_in(name##_t* self, void* value);\
+int name##_out(name##_t* self, void* value);\
+int name##_capacity(name##_t* self);
+
+#define nOS_INSTALL_SPSC_QUEUE_APIs(name, T)\
+static int name##_used(name##_t* self, int index, int outdex)\
+{\
+    int used = index - outdex;\
+    if (used < 0)\
+        used += 2 * self->capacity;\
+    return used;\
+}\
+int name##_init(name##_t* self, void* values, int capacity)\
+{\
+    if (NULL == self)/* Check if queue was initiates*/\
+        {return nOS_QUEUE_NULL_POINTER;} /* Return error code */\
+    if (NULL == values)/* Check if queue was initiates*/\
+        {return nOS_QUEUE_ARRAY_NULL_POINTER;} /* Return error code */\
+    if (0 == capacity)/* Check if capacity is not 0 */\
+        {return nOS_QUEUE_WITHOUT_CAPACITY;} /* Return error code */\
+    self->outdex = 0;\
+    self->index = 0;\
+    self->capacity = capacity;\
+    memset( values, 0, capacity * sizeof(T) );\
+    self->values = (T*)values;\
+    return nOS_QUEUE_OK;\
+}\
+int name##_is_empty(name##_t* self)\
+{\
+    return nOS_ATOMIC_LOAD(&self->index) == nOS_ATOMIC_LOAD(&self->outdex);\
+}\
+int name##_is_full(name##_t* self)\
+{\
+    return name##_used(self, nOS_ATOMIC_LOAD(&self->index),\
+                       nOS_ATOMIC_LOAD(&self->outdex)) >= self->capacity;\
+}\
+int name##_in(name##_t* self, void* value)\
+{\
+    int index;\
+    \
+    if (NULL == self)/* Check if queue was initiates*/\
+        {return nOS_QUEUE_NULL_POINTER;} /* Return error code */\
+    if (NULL == self->values)/* Check if queue was initiates*/\
+        return nOS_QUEUE_ARRAY_NULL_POINTER; /* Return error code */\
+    index = nOS_ATOMIC_LOAD_RELAXED(&self->index);/* Owned by the producer */\
+    if (name##_used(self, index, nOS_ATOMIC_LOAD(&self->outdex)) >= self->capacity)\
+        return nOS_QUEUE_OVERFLOWED;\
+    self->values[(index < self->capacity) ? index : index - self->capacity] = *(T*)value;\
+    if (++index >= 2 * self->capacity)\
+        index = 0;\
+    nOS_ATOMIC_STORE(&self->index, index);/* Publish the value */\
+    return nOS_QUEUE_OK;\
+}\
+int name##_out(name##_t* self, void* value)\
+{\
+    int outdex;\
+    \
+    if (NULL == self)/* Check if queue was initiates*/\
+        {return nOS_QUEUE_NULL_POINTER;} /* Return error code */\
+    if (NULL == self->values)/* Check if queue was initiates*/\
+        return nOS_QUEUE_ARRAY_NULL_POINTER; /* Return error code */\
+    outdex = nOS_ATOMIC_LOAD_RELAXED(&self->outdex);/* Owned by the consumer */\
+    if (outdex == nOS_ATOMIC_LOAD(&self->index))\
+        return nOS_QUEUE_EMPTY;\
+    *((T*)value) = self->values[(outdex < self->capacity) ? outdex : outdex - self->capacity];\
+    if (++outdex >= 2 * self->capacity)\
+        outdex = 0;\
+    nOS_ATOMIC_STORE(&self->outdex, outdex);/* Release the slot */\
+    return nOS_QUEUE_OK;\
+}\
+int name##_capacity(name##_t* self)\
+{\
+    return self->capacity;\
+}
+
+/*
+ * Multi producer / single consumer lock free queue, producers can be ISRs of
+ * any nesting level or threads running on other cores.
+ * A producer first reserves room by incrementing count, then claims a slot by
+ * advancing index and finally publishes the slot by setting its ready flag.
+ * The consumer only takes published slots, clears the ready flag and gives the
+ * room back by decrementing count.
+ * count therefore also covers slots that are reserved but not yet published.
+ * The bulk operations follow the interface of the queue above, in addition:
+ * int name##_reserve(name##_t* self, int n);
+ * void name##_in_reserved(name##_t* self, void* values, int n);
+ * split name##_in_n so a producer can reserve room for a long batch once and
+ * publish it in several parts.
+ * The values are copied slot by slot since every slot carries a ready flag.
+ */
+#define nOS_CREATE_MPSC_QUEUE(name, T)\
+typedef struct \
+{\
+    uint8_t ready;\
+    T value;\
+} name##_slot_t;\
+typedef struct \
+{\
+    int count;\
+    int index;\
+    int outdex;\
+    int capacity;\
+    name##_slot_t* values;\
+} name##_t;\
+int name##_init(name##_t* self, void* values, int capacity);\
+int name##_is_empty(name##_t* self);\
+int name##_is_full(name##_t* self);\
+int name##_in(name##_t* self, void* value);\
+int name##_out(name##_t* self, void* value);\
+int name##_reserve(name##_t* self, int n);\
+void name##_in_reserved(name##_t* self, void* values, int n);\
+int name##_in_n(name##_t* self, void* values, int n);\
+int name##_out_n(name##_t* self, void* values, int* n);\
+int name##_capacity(name##_t* self);
+
+#define nOS_INSTALL_MPSC_QUEUE_APIs(name, T)\
+int name##_init(name##_t* self, void* values, int capacity)\
+{\
+    if (NULL == self)/* Check if queue was initiates*/\
+        {return nOS_QUEUE_NULL_POINTER;} /* Return error code */\
+    if (NULL == values)/* Check if queue was initiates*/\
+        {return nOS_QUEUE_ARRAY_NULL_POINTER;} /* Return error code */\
+    if (0 == capacity)/* Check if capacity is not 0 */\
+        {return nOS_QUEUE_WITHOUT_CAPACITY;} /* Return error code */\
+    self->count = 0;\
+    self->outdex = 0;\
+    self->index = 0;\
+    self->capacity = capacity;\
+    memset( values, 0, capacity * sizeof(name##_slot_t) );\
+    self->values = (name##_slot_t*)values;\
+    return nOS_QUEUE_OK;\
+}\
+int name##_is_empty(name##_t* self)\
+{\
+    return nOS_ATOMIC_LOAD(&self->count) == 0;\
+}\
+int name##_is_full(name##_t* self)\
+{\
+    return nOS_ATOMIC_LOAD(&self->count) >= self->capacity;\
+}\
+int name##_in(name##_t* self, void* value)\
+{\
+    int count, index, next;\
+    name##_slot_t* slot;\
+    \
+    if (NULL == self)/* Check if queue was initiates*/\
+        {return nOS_QUEUE_NULL_POINTER;} /* Return error code */\
+    if (NULL == self->values)/* Check if queue was initiates*/\
+        return nOS_QUEUE_ARRAY_NULL_POINTER; /* Return error code */\
+    /* Reserve room in the queue */\
+    count = nOS_ATOMIC_LOAD(&self->count);\
+    do\
+    {\
+        if (count >= self->capacity)\
+            return nOS_QUEUE_OVERFLOWED;\
+    } while (!nOS_ATOMIC_CAS(&self->count, &count, count + 1));\
+    /* Claim the next slot, the reservation guarantees it was consumed */\
+    index = nOS_ATOMIC_LOAD(&self->index);\
+    do\
+    {\
+        next = index + 1;\
+        if (next >= self->capacity)\
+            next = 0;\
+    } while (!nOS_ATOMIC_CAS(&self->index, &index, next));\
+    slot = &self->values[index];\
+    slot->value = *(T*)value;\
+    nOS_ATOMIC_STORE(&slot->ready, 1);/* Publish the value */\
+    return nOS_QUEUE_OK;\
+}\
+int name##_out(name##_t* self, void* value)\
+{\
+    name##_slot_t* slot;\
+    \
+    if (NULL == self)/* Check if queue was initiates*/\
+        {return nOS_QUEUE_NULL_POINTER;} /* Return error code */\
+    if (NULL == self->values)/* Check if queue was initiates*/\
+        return nOS_QUEUE_ARRAY_NULL_POINTER; /* Return error code */\
+    slot = &self->values[self->outdex];\
+    /* Empty, or the oldest slot is claimed but not yet published */\
+    if (!nOS_ATOMIC_LOAD(&slot->ready))\
+        return nOS_QUEUE_EMPTY;\
+    *((T*)value) = slot->value;\
+    nOS_ATOMIC_STORE_RELAXED(&slot->ready, 0);\
+    if (++self->outdex >= self->capacity)\
+        self->outdex = 0;\
+    nOS_ATOMIC_FETCH_SUB(&self->count, 1);/* Give the room back */\
+    return nOS_QUEUE_OK;\
+}\
+int name##_reserve(name##_t* self, int n)\
+{\
+    int count = nOS_ATOMIC_LOAD(&self->count);\
+    \
+    do\
+    {\
+        if (count + n > self->capacity)\
+            return nOS_QUEUE_OVERFLOWED;\
+    } while (!nOS_ATOMIC_CAS(&self->count, &count, count + n));\
+    return nOS_QUEUE_OK;\
+}\
+void name##_in_reserved(name##_t* self, void* values, int n)\
+{\
+    int index, next, i;\
+    \
+    /* Claim n consecutive slots at once */\
+    index = nOS_ATOMIC_LOAD(&self->index);\
+    do\
+    {\
+        next = index + n;\
+        if (next >= self->capacity)\
+            next -= self->capacity;\
+    } while (!nOS_ATOMIC_CAS(&self->index, &index, next));\
+    for (i = 0; i < n; i++)\
+    {\
+        self->values[index].value = ((T*)values)[i];\
+        nOS_ATOMIC_STORE(&self->values[index].ready, 1);/* Publish the value */\
+        if (++index >= self->capacity)\
+            index = 0;\
+    }\
+}\
+int name##_in_n(name##_t* self, void* values, int n)\
+{\
+    if (NULL == self)/* Check if queue was initiates*/\
+        {return nOS_QUEUE_NULL_POINTER;} /* Return error code */\
+    if (NULL == self->values)/* Check if queue was initiates*/\
+        return nOS_QUEUE_ARRAY_NULL_POINTER; /* Return error code */\
+    if (nOS_QUEUE_OK != name##_reserve(self, n))\
+        return nOS_QUEUE_OVERFLOWED;\
+    name##_in_reserved(self, values, n);\
+    return nOS_QUEUE_OK;\
+}\
+int name##_out_n(name##_t* self, void* values, int* n)\
+{\
+    name##_slot_t* slot;\
+    int taken = 0;\
+    \
+    if (NULL == self)/* Check if queue was initiates*/\
+        {return nOS_QUEUE_NULL_POINTER;} /* Return error code */\
+    if (NULL == self->values)/* Check if queue was initiates*/\
+        return nOS_QUEUE_ARRAY_NULL_POINTER; /* Return error code */\
+    /* Stop at the first slot that is not yet published */\
+    while (taken < *n)\
+    {\
+        slot = &self->values[self->outdex];\
+        if (!nOS_ATOMIC_LOAD(&slot->ready))\
+            break;\
+        ((T*)values)[taken++] = slot->value;\
+        nOS_ATOMIC_STORE_RELAXED(&slot->ready, 0);\
+        if (++self->outdex >= self->capacity)\
+            self->outdex = 0;\
+    }\
+    *n = taken;\
+    if (0 == taken)\
+        return nOS_QUEUE_EMPTY;\
+    nOS_ATOMIC_FETCH_SUB(&self->count, taken);/* Give the room back */\
+    return nOS_QUEUE_OK;\
+}\
 int name##_capacity(name##_t* self)\
 {\
     return self->capacity;\
 }
 
+/*
+ * Power of two queue, a narrow variant of the queue above for callers that
+ * already guard the queue (e.g. with interrupts locked).
+ * index and outdex run freely over the whole range of the index type I
+ * (uint8_t or uint16_t) and are masked on access, their difference is the
+ * number of queued values so no count is kept.
+ * Interface:
+ * int name##_init(name##_t* self, void* values, int capacity);
+ * int name##_is_empty(name##_t* self);
+ * int name##_is_full(name##_t* self);
+ * void name##_in(name##_t* self, void* value);
+ * void name##_out(name##_t* self, void* value);
+ * void name##_in_n(name##_t* self, void* values, int n);
+ * void name##_out_n(name##_t* self, void* values, int n);
+ * int name##_count(name##_t* self);
+ * int name##_capacity(name##_t* self);
+ * capacity shall be a power of two, up to half the range of I (128 for
+ * uint8_t), otherwise init returns nOS_QUEUE_BAD_CAPACITY.
+ * name##_in and name##_out do not check anything, the caller shall check
+ * name##_is_full before name##_in and name##_is_empty before name##_out.
+ * Likewise n shall not exceed the free room for name##_in_n nor name##_count
+ * for name##_out_n.
+ */
+#define nOS_CREATE_POW2_QUEUE(name, T, I)\
+typedef struct \
+{\
+    I index;\
+    I outdex;\
+    I mask;\
+    T* values;\
+} name##_t;\
+int name##_init(name##_t* self, void* values, int capacity);\
+int name##_is_empty(name##_t* self);\
+int name##_is_full(name##_t* self);\
+void name##_in(name##_t* self, void* value);\
+void name##_out(name##_t* self, void* value);\
+void name##_in_n(name##_t* self, void* values, int n);\
+void name##_out_n(name##_t* self, void* values, int n);\
+int name##_count(name##_t* self);\
+int name##_capacity(name##_t* self);
+
+#define nOS_INSTALL_POW2_QUEUE_APIs(name, T, I)\
+int name##_init(name##_t* self, void* values, int capacity)\
+{\
+    if (NULL == self)/* Check if queue was initiates*/\
+        {return nOS_QUEUE_NULL_POINTER;} /* Return error code */\
+    if (NULL == values)/* Check if queue was initiates*/\
+        {return nOS_QUEUE_ARRAY_NULL_POINTER;} /* Return error code */\
+    if (0 == capacity)/* Check if capacity is not 0 */\
+        {return nOS_QUEUE_WITHOUT_CAPACITY;} /* Return error code */\
+    if ((capacity & (capacity - 1))\
+        || (capacity > (int) ((I) ~(I) 0 / 2 + 1)))\
+        {return nOS_QUEUE_BAD_CAPACITY;} /* Return error code */\
+    self->outdex = 0;\
+    self->index = 0;\
+    self->mask = (I) (capacity - 1);\
+    memset( values, 0, capacity * sizeof(T) );\
+    self->values = (T*)values;\
+    return nOS_QUEUE_OK;\
+}\
+int name##_is_empty(name##_t* self)\
+{\
+    return self->index == self->outdex;\
+}\
+int name##_is_full(name##_t* self)\
+{\
+    return (I) (self->index - self->outdex) > self->mask;\
+}\
+void name##_in(name##_t* self, void* value)\
+{\
+    self->values[self->index++ & self->mask] = *(T*)value;\
+}\
+void name##_out(name##_t* self, void* value)\
+{\
+    *((T*)value) = self->values[self->outdex++ & self->mask];\
+}\
+void name##_in_n(name##_t* self, void* values, int n)\
+{\
+    int index = self->index & self->mask;\
+    int first = self->mask + 1 - index;/* Up to the end of the ring */\
+    \
+    if (first > n)\
+        first = n;\
+    memcpy( &self->values[index], values, first * sizeof(T) );\
+    memcpy( self->values, (T*)values + first, (n - first) * sizeof(T) );\
+    self->index += (I) n;\
+}\
+void name##_out_n(name##_t* self, void* values, int n)\
+{\
+    int outdex = self->outdex & self->mask;\
+    int first = self->mask + 1 - outdex;/* Up to the end of the ring */\
+    \
+    if (first > n)\
+        first = n;\
+    memcpy( values, &self->values[outdex], first * sizeof(T) );\
+    memcpy( (T*)values + first, self->values, (n - first) * sizeof(T) );\
+    self->outdex += (I) n;\
+}\
+int name##_count(name##_t* self)\
+{\
+    return (I) (self->index - self->outdex);\
+}\
+int name##_capacity(name##_t* self)\
+{\
+    return self->mask + 1;\
+}
+
 #ifdef __cplusplus
 }
 #endif
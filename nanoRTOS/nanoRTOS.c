@@ -8,51 +8,468 @@
 
 #include "nanoRTOS.h"
 #include "nanoQueue.h"
+#include "nanoTimer.h"
+#include "nanoPort.h"
+#include "nanoStats.h"
+#include "nanoTrace.h"
+#include "nanoPool.h"
+#include "nanoBudget.h"
+#include "nanoProfile.h"
+#include "nanoCoro.h"
 #include "string.h"
 
 //
 /**
  * A macro to create a queue to hold nOS_task_t elements
  */
+#if (nOS_TASK_QUEUE_IMPL == nOS_TASK_QUEUE_LOCK_FREE)
+nOS_CREATE_MPSC_QUEUE(task_queue, nOS_task_t)
+typedef task_queue_slot_t task_slot_t; // A lock free queue element
+#define TASK_QUEUE_COUNT(queue) nOS_ATOMIC_LOAD(&(queue)->count)
+#elif (nOS_TASK_QUEUE_IMPL == nOS_TASK_QUEUE_POW2)
+nOS_CREATE_POW2_QUEUE(task_queue, nOS_task_t, nOS_TASK_QUEUE_INDEX_T)
+typedef nOS_task_t task_slot_t;
+#define TASK_QUEUE_COUNT(queue) task_queue_count (queue)
+#define TASK_QUEUE_OUT_N(queue, tasks, count) \
+    task_queue_out_n (queue, tasks, *(count))
+#define TASK_QUEUE_HEAD(queue)  (&(queue)->values[(queue)->outdex & (queue)->mask])
+#define TASK_QUEUE_TAIL(queue)  (&(queue)->values[(queue)->index & (queue)->mask])
+#else
 nOS_CREATE_TYPED_QUEUE(task_queue, nOS_task_t)
+typedef nOS_task_t task_slot_t;
+#define TASK_QUEUE_COUNT(queue) ((queue)->count)
+#define TASK_QUEUE_OUT_N(queue, tasks, count) \
+    task_queue_out_n (queue, tasks, count)
+#define TASK_QUEUE_HEAD(queue)  (&(queue)->values[(queue)->outdex])
+#define TASK_QUEUE_TAIL(queue)  (&(queue)->values[(queue)->index])
+#endif
+#if nOS_EDF
+/**
+ * A task in a deadline heap
+ */
+typedef struct
+{
+    nOS_task_t task_;
+    nOS_tick_t deadline_; // The absolute deadline tick
+    uint32_t seq_;        // The post order, for the tasks of the same deadline
+} deadline_task_t;
+#endif
+
 /**
  * This structure joins the data needed for a Task Control Block (TCB)
  */
 typedef struct
 {
-    uint8_t prio_; // The priority of the task
+    nOS_prio_t prio_; // The priority of the task
+#if (nOS_SMP_CORES > 1)
+    uint8_t core_;    // The core the queue belongs to
+#endif
     task_queue_t task_queue_; // A queue structure to queue tasks
+#if nOS_EDF
+    deadline_task_t *deadlines_; // A binary heap, the earliest deadline first
+    uint16_t deadline_length_;   // 0 for a FIFO only priority
+    uint16_t deadline_count_;
+    uint32_t deadline_seq_;      // The post counter of the heap
+    uint32_t deadline_misses_;   // The tasks dispatched after their deadline
+#endif
+#if nOS_OVERFLOW_POLICY
+    uint32_t overflows_[nOS_OVERFLOW_POLICY_COUNT]; // The overflows per policy
+#endif
 } nOS_tcb_t;
 
+/**
+ * The ready bitmap, bit (prio - 1) % 32 of word (prio - 1) / 32 is set while
+ * the queue of prio may hold tasks. Above 32 priorities a summary word flags
+ * the non empty words, so the highest ready priority is always two CLZ away.
+ */
+#define READY_WORDS ((nOS_PRIO_COUNT + 31) / 32)
+
+typedef struct
+{
+#if (READY_WORDS > 1)
+    uint32_t summary_; // Bit w is set while words_[w] may be non zero
+#endif
+    uint32_t words_[READY_WORDS];
+} ready_bitmap_t;
+
+#if nOS_TASK_COALESCE
+/**
+ * A pending coalesced task, the queued task only carries the entry index
+ */
+typedef struct
+{
+    nOS_task_callback_t callback_; // NULL while the entry is free
+    nOS_prio_t prio_;
+    uint8_t event_; // The event, or the accumulated event bits
+    uint8_t mode_;  // nOS_coalesce_t
+} coalesce_entry_t;
+
+// Entries are only looked up this many slots from their hash
+#define COALESCE_PROBES 4
+#endif
+
 /**
  * A structure to hold all the private variables of the module
  */
 typedef struct
 {
-    uint8_t current_prio_;    // The current running priority of the task
-    uint8_t read_queue_flags; // A variable to indicate which queue needs to be scheduled
+    nOS_prio_t current_prio_; // The current running priority of the task
+    ready_bitmap_t ready_[nOS_SMP_CORES]; // Indicates which queue needs to be scheduled
+#if (nOS_SMP_CORES > 1)
+    uint32_t locks_[nOS_SMP_CORES]; // Guard the queues of each core
+#endif
+#if nOS_TASK_COALESCE
+    coalesce_entry_t coalesce_[nOS_TASK_COALESCE_SLOTS]; // Pending coalesced tasks
+#endif
+#if nOS_AGING_CREDITS
+    uint16_t aging_bypassed_; // Batches taken while a lower priority waited
+    nOS_prio_t aged_prio_;    // The last priority that took an aging turn
+#endif
+#if nOS_TICKLESS_IDLE || nOS_TRACE
+    uint8_t task_depth_; // The callbacks running, nested ones included
+#endif
 } private_vars_t;
 
-static nOS_task_t prio1_task_q_container_[nOS_PRIO1_TASK_QUEUE_LENGTH];
-static nOS_task_t prio2_task_q_container_[nOS_PRIO2_TASK_QUEUE_LENGTH];
-static nOS_task_t prio3_task_q_container_[nOS_PRIO3_TASK_QUEUE_LENGTH];
-static nOS_task_t prio4_task_q_container_[nOS_PRIO4_TASK_QUEUE_LENGTH];
-static nOS_task_t prio5_task_q_container_[nOS_PRIO5_TASK_QUEUE_LENGTH];
-static nOS_task_t prio6_task_q_container_[nOS_PRIO6_TASK_QUEUE_LENGTH];
-static nOS_task_t prio7_task_q_container_[nOS_PRIO7_TASK_QUEUE_LENGTH];
-static nOS_task_t prio8_task_q_container_[nOS_PRIO8_TASK_QUEUE_LENGTH];
-// read_queue_flags_mask is an array to allow quick conversion from priority number to bit field mask
-static const uint8_t read_queue_flags_mask[8] =
-{ 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
-//{ 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01 };
-
-static nOS_tcb_t nOS_tcb_[8];
+#define TASK_QUEUE_LENGTH_ENTRY(length) nOS_TASK_QUEUE_SLOTS(length),
+// The number of task slots of each priority, see nOS_TASK_QUEUE_SLOTS
+static const uint16_t task_queue_lengths_[nOS_PRIO_COUNT] =
+{ nOS_TASK_QUEUE_LENGTHS(TASK_QUEUE_LENGTH_ENTRY) };
+// All the task queues share one container, split by init_nOS_tcb
+static task_slot_t task_q_container_[nOS_SMP_CORES * nOS_TASK_QUEUE_TOTAL_LENGTH];
+#if nOS_TASK_CANCEL
+// The generation of each slot of the container, odd while the slot holds a
+// pending task, even once it was taken or cancelled
+static uint16_t task_gens_[nOS_SMP_CORES * nOS_TASK_QUEUE_TOTAL_LENGTH];
+#define TASK_SLOT(slot)         ((uint16_t) ((slot) - task_q_container_))
+#endif
+
+#if nOS_EDF
+#define DEADLINE_LENGTH_ENTRY(length) (length),
+// The deadline heap length of each priority, 0 for a FIFO only priority
+static const uint16_t deadline_lengths_[nOS_PRIO_COUNT] =
+{ nOS_TASK_DEADLINE_LENGTHS(DEADLINE_LENGTH_ENTRY) };
+// All the deadline heaps share one container, split by init_nOS_tcb
+static deadline_task_t deadline_container_[nOS_TASK_DEADLINE_TOTAL_LENGTH];
+#endif
+
+#if nOS_OVERFLOW_POLICY
+#define OVERFLOW_POLICY_ENTRY(policy) (policy),
+// The overflow policy of each priority, nOS_OVERFLOW_*
+static const uint8_t overflow_policies_[nOS_PRIO_COUNT] =
+{ nOS_TASK_OVERFLOW_POLICIES(OVERFLOW_POLICY_ENTRY) };
+// The posts may overflow from ISRs and the other cores meanwhile
+#define OVERFLOW_COUNT(nOS_tcb, policy)\
+    nOS_ATOMIC_FETCH_ADD(&(nOS_tcb)->overflows_[policy], 1)
+#else
+#define OVERFLOW_COUNT(nOS_tcb, policy)
+#endif
+
+// The TCBs of all the priorities of core 0, then of core 1 and so on
+static nOS_tcb_t nOS_tcb_[nOS_SMP_CORES * nOS_PRIO_COUNT];
 static private_vars_t prvt_vars;
 
+#define TCB(core, prio)         (&nOS_tcb_[(core) * nOS_PRIO_COUNT + (prio) - 1])
+#if (nOS_SMP_CORES > 1)
+#define CURRENT_CORE            nOS_CORE_ID()
+#define TCB_CORE(nOS_tcb)       ((nOS_tcb)->core_)
+#define TASK_PIN(task, pinned)  ((task)->pinned_ = (pinned))
+// The queues of a core are shared with the other cores
+#define CORE_LOCK(core)         nOS_SPIN_LOCK(&prvt_vars.locks_[core])
+#define CORE_UNLOCK(core)       nOS_SPIN_UNLOCK(&prvt_vars.locks_[core])
+#else
+#define CURRENT_CORE            0
+#define TCB_CORE(nOS_tcb)       0
+#define TASK_PIN(task, pinned)
+#define CORE_LOCK(core)
+#define CORE_UNLOCK(core)
+#endif
+#define TCB_READY(nOS_tcb)      (&prvt_vars.ready_[TCB_CORE(nOS_tcb)])
+#if (nOS_TASK_QUEUE_IMPL == nOS_TASK_QUEUE_LOCK_FREE)
+// The lock free queues take concurrent producers as they are
+#define TASKS_LOCK(core)
+#define TASKS_UNLOCK(core)
+#else
+// Guard the queues and the ready bitmap of a core
+#define TASKS_LOCK(core)        nOS_INTERRUPTS_LOCK(); CORE_LOCK(core)
+#define TASKS_UNLOCK(core)      CORE_UNLOCK(core); nOS_INTERRUPTS_UNLOCK()
+#endif
+#if nOS_PREEMPTIVE
+// The priority of the running task, 0 outside of the tasks
+#define CURRENT_PRIO            prvt_vars.current_prio_
+#define CURRENT_PRIO_SET(prio)  (prvt_vars.current_prio_ = (prio))
+#else
+#define CURRENT_PRIO            0
+#define CURRENT_PRIO_SET(prio)
+#endif
+#if nOS_TICKLESS_IDLE || nOS_TRACE
+// Non zero while a callback runs, a nOS_schedule from it is not idle
+#define TASK_DEPTH              prvt_vars.task_depth_
+#define TASK_DEPTH_ENTER()      (prvt_vars.task_depth_++)
+#define TASK_DEPTH_LEAVE()      (prvt_vars.task_depth_--)
+#else
+#define TASK_DEPTH              0
+#define TASK_DEPTH_ENTER()
+#define TASK_DEPTH_LEAVE()
+#endif
+
 /**
  * @brief A function to initialise the prio_task_q_containers
  */
 static void init_nOS_tcb (void);
+/**
+ * @brief A function to push a task in a TCB queue and flag the queue as ready
+ * @param nOS_tcb- The TCB of the task priority
+ * @param task- The task to push
+ * @return nOS_OK or nOS_TASK_QUEUE_ERR when the queue is full
+ */
+static nOS_err_t task_post (nOS_tcb_t *nOS_tcb, nOS_task_t *task);
+/**
+ * @brief A function to push a task in a TCB queue without flagging it, the
+ * caller holds TASKS_LOCK and flags the queue once the task was published
+ * @param nOS_tcb- In/output, the TCB of the task priority, the TCB the task
+ * was pushed to after the overflow policy spilled it
+ * @return nOS_OK or nOS_TASK_QUEUE_ERR when the queue is full
+ */
+static nOS_err_t task_push (nOS_tcb_t **nOS_tcb, nOS_task_t *task);
+#if nOS_OVERFLOW_POLICY
+/**
+ * @brief A function to apply the overflow policy of a full TCB queue, called
+ * by task_push with TASKS_LOCK held
+ * @param nOS_tcb- In/output, the full TCB, the next lower one to spill to
+ * @param task- The task that did not fit
+ * @return 1 when task_push shall try again, 0 when the post is rejected
+ */
+static int task_overflow (nOS_tcb_t **nOS_tcb, nOS_task_t *task);
+#if (nOS_TASK_QUEUE_IMPL != nOS_TASK_QUEUE_LOCK_FREE)
+/**
+ * @brief A function to release what a dropped task holds, the coalesce entry
+ * or the message block
+ */
+static void task_drop (nOS_task_t *task);
+#endif
+#else
+// Without overflow policies a full queue rejects the post
+#define task_overflow(nOS_tcb, task)    0
+#endif
+#if nOS_TASK_CANCEL
+/**
+ * @brief A function to flag the next n slots of a queue as pending, called
+ * with TASKS_LOCK held before they are written
+ */
+static void task_gens_push (task_queue_t *queue, int n);
+/**
+ * @brief A function to dequeue the next tasks of a queue without the
+ * cancelled ones, called with TASKS_LOCK held
+ * @param count- In/output, the number of tasks to dequeue, then the number of
+ * tasks to call
+ */
+static void task_take_n (task_queue_t *queue, nOS_task_t *tasks, int *count);
+#define TASK_TAKE_N(queue, tasks, count)    task_take_n (queue, tasks, count)
+#else
+#define TASK_TAKE_N(queue, tasks, count)    TASK_QUEUE_OUT_N(queue, tasks, count)
+#endif
+#if (nOS_TASK_QUEUE_IMPL != nOS_TASK_QUEUE_LOCK_FREE) || nOS_TASK_COALESCE
+/**
+ * @brief task_post for callers that already locked the interrupts
+ */
+static nOS_err_t task_post_locked (nOS_tcb_t *nOS_tcb, nOS_task_t *task);
+#endif
+#if nOS_TASK_COALESCE
+/**
+ * @brief The callback of the queued coalesced tasks, it frees the entry and
+ * calls the actual task with the merged event
+ * @param event- The coalesce entry index
+ */
+static void coalesced_task (uint8_t event);
+#endif
+
+#ifdef nOS_TASK_TABLE
+#define TASK_TABLE_ENTRY(callback) callback,
+// The callbacks of the tasks indexed by task ID, the coalesced tasks last
+static const nOS_task_callback_t task_table_[] =
+{ nOS_TASK_TABLE(TASK_TABLE_ENTRY)
+#if nOS_TASK_COALESCE
+        coalesced_task,
+#endif
+#if nOS_MSG_POOL
+        nOS_pool_dispatch,
+#endif
+};
+#define TASK_SET(task, ref)     ((task)->id_ = (uint8_t) (ref))
+#define TASK_REF(task)          ((nOS_task_ref_t) (task)->id_)
+#define TASK_CALLBACK(task)     (task_table_[(task)->id_])
+#define REF_CALLBACK(ref)       (task_table_[ref])
+#define COALESCED_TASK          ((nOS_task_ref_t) nOS_TASK_COUNT)
+#define MSG_TASK                ((nOS_task_ref_t) (nOS_TASK_COUNT\
+                                 + (nOS_TASK_COALESCE != 0)))
+#else
+#define TASK_SET(task, ref)     ((task)->callback_ = (ref))
+#define TASK_REF(task)          ((task)->callback_)
+#define TASK_CALLBACK(task)     ((task)->callback_)
+#define REF_CALLBACK(ref)       (ref)
+#define COALESCED_TASK          coalesced_task
+#define MSG_TASK                nOS_pool_dispatch
+#endif
+
+#ifdef nOS_TOPIC_TABLE
+/**
+ * A subscriber of a topic
+ */
+typedef struct
+{
+    nOS_task_ref_t callback_;
+    nOS_prio_t prio_;
+} subscriber_t;
+
+/**
+ * The subscribers of a topic
+ */
+typedef struct
+{
+    const subscriber_t *subscribers_;
+    uint16_t count_;
+} topic_t;
+
+#ifdef nOS_TASK_TABLE
+#define SUBSCRIBER_REF(callback) nOS_TASK_ID(callback)
+#else
+#define SUBSCRIBER_REF(callback) callback
+#endif
+// A subscriber priority out of range fails the build on a negative array size
+#define nOS_SUBSCRIBER(prio, callback)\
+    extern char subscriber_prio_check_[((prio) >= 1)\
+            && ((prio) <= nOS_PRIO_COUNT) ? 1 : -1];
+#define TOPIC_CHECK_ENTRY(topic, subscribers) subscribers
+nOS_TOPIC_TABLE(TOPIC_CHECK_ENTRY)
+#undef nOS_SUBSCRIBER
+// The subscribers of each topic
+#define nOS_SUBSCRIBER(prio, callback) { SUBSCRIBER_REF(callback), (prio) },
+#define TOPIC_SUBSCRIBERS_ENTRY(topic, subscribers)\
+    static const subscriber_t topic_##topic##_[] = { subscribers };
+nOS_TOPIC_TABLE(TOPIC_SUBSCRIBERS_ENTRY)
+#undef nOS_SUBSCRIBER
+#define TOPIC_ENTRY(topic, subscribers)\
+    { topic_##topic##_, sizeof(topic_##topic##_) / sizeof(subscriber_t) },
+// The subscribers of the topics indexed by topic ID
+static const topic_t topics_[nOS_TOPIC_COUNT] =
+{ nOS_TOPIC_TABLE(TOPIC_ENTRY) };
+#endif
+/**
+ * @brief A function to push a batch of tasks in a TCB queue, all or none
+ * @param nOS_tcb- The TCB of the tasks priority
+ * @param callback- The callback of all the tasks
+ * @param events- One event per task
+ * @param n- The number of tasks
+ * @return nOS_OK or nOS_TASK_QUEUE_ERR when the queue has no room for all
+ */
+static nOS_err_t task_post_n (nOS_tcb_t *nOS_tcb, nOS_task_ref_t callback,
+                              const uint8_t *events, uint16_t n);
+/**
+ * @brief A function to build the next chunk of tasks of a batch
+ * @return The number of tasks built, up to nOS_TASK_BATCH_CHUNK
+ */
+static int task_fill (nOS_task_t *tasks, nOS_task_ref_t callback,
+                      const uint8_t *events, uint16_t n);
+/**
+ * @brief A function to pop the next tasks of the highest pending priority
+ * @param floor- Only a priority above it is popped
+ * @param tasks- Output, the tasks to call
+ * @param count- Output, the number of tasks popped, up to nOS_SCHEDULE_BATCH
+ * @return The TCB the tasks were popped from, NULL if no task is pending
+ */
+static nOS_tcb_t *task_fetch (nOS_prio_t floor, nOS_task_t *tasks, int *count);
+/**
+ * @brief A function to run the pending tasks of the priorities above floor
+ * @param floor- The priority of the preempted task, 0 for all the tasks
+ */
+static void schedule_above (nOS_prio_t floor);
+#if (nOS_SMP_CORES > 1)
+/**
+ * @brief A function to steal the next tasks of another core when it has a
+ * higher priority ready than the calling core
+ * @param core- The calling core
+ * @return The TCB the tasks were stolen from, NULL if the calling core shall
+ * run its own tasks
+ */
+static nOS_tcb_t *task_steal (uint8_t core, nOS_task_t *tasks, int *count);
+#endif
+/**
+ * @brief A function to flag a priority as ready
+ */
+static void ready_set (ready_bitmap_t *ready, nOS_prio_t prio);
+/**
+ * @brief A function to clear the ready flag of a priority
+ */
+static void ready_clear (ready_bitmap_t *ready, nOS_prio_t prio);
+#ifdef nOS_TOPIC_TABLE
+/**
+ * @brief A function to flag the priorities of a bitmap as ready at once, one
+ * read-modify-write per word
+ * @param posted- The priorities to flag, its summary word is not used
+ */
+static void ready_set_all (ready_bitmap_t *ready, const ready_bitmap_t *posted);
+#endif
+/**
+ * @brief A function to find the highest ready priority
+ * @return The highest ready priority, 0 if none is ready
+ */
+static nOS_prio_t ready_highest (ready_bitmap_t *ready);
+/**
+ * @brief A function to pick the priority to run next, the highest ready one
+ * unless a waiting lower priority is due for an aging turn
+ * @param floor- Only a priority above it may be picked
+ * @return The priority, not above floor if none is ready above it
+ */
+static nOS_prio_t ready_pick (ready_bitmap_t *ready, nOS_prio_t floor);
+#if nOS_AGING_CREDITS
+/**
+ * @brief A function to find the lowest ready priority above a priority
+ * @param after- The priority to search above
+ * @return The lowest ready priority above after, else the lowest ready
+ * priority, 0 if none is ready
+ */
+static nOS_prio_t ready_next (ready_bitmap_t *ready, nOS_prio_t after);
+#endif
+#if nOS_EDF
+/**
+ * @brief A function to push a task in the deadline heap of a TCB and flag the
+ * priority as ready, called with the interrupts locked
+ * @return nOS_OK or nOS_TASK_QUEUE_ERR when the heap is full
+ */
+static nOS_err_t deadline_post_locked (nOS_tcb_t *nOS_tcb, nOS_task_t *task,
+                                       nOS_tick_t deadline);
+/**
+ * @brief A function to pop the earliest deadline tasks of a TCB and count the
+ * ones that are late, called with the interrupts locked
+ * @param tasks- Output, the tasks to call
+ * @param n- The maximum number of tasks to pop
+ * @return The number of tasks popped
+ */
+static int deadline_out_n (nOS_tcb_t *nOS_tcb, nOS_task_t *tasks, int n);
+#endif
+#if nOS_TICKLESS_IDLE
+/**
+ * @brief A function to sleep until the next timer expiry when no task is pending
+ */
+static void nOS_idle (void);
+#endif
+#if nOS_STATS || nOS_QUEUE_PROFILE
+/**
+ * @brief A function to record a post of n tasks in the statistics and the
+ * profile, from any context
+ */
+static void queue_enqueued (nOS_tcb_t *nOS_tcb, uint16_t n);
+/**
+ * @brief A function to record a post that found the queue full, from any
+ * context
+ */
+static void queue_overflowed (nOS_tcb_t *nOS_tcb);
+#define QUEUE_ENQUEUED(nOS_tcb, n)  queue_enqueued ((nOS_tcb), (uint16_t) (n))
+#define QUEUE_OVERFLOWED(nOS_tcb)   queue_overflowed (nOS_tcb)
+#else
+#define QUEUE_ENQUEUED(nOS_tcb, n)
+#define QUEUE_OVERFLOWED(nOS_tcb)
+#endif
 
 nOS_err_t nOS_start (void)
 {
@@ -60,83 +477,488 @@ nOS_err_t nOS_start (void)
     nOS_CRITICAL_SECTION(init_nOS_tcb ()
     ;
     )
+    // Stop all the software timers
+    nOS_timer_init ();
+#if nOS_TRACE
+    // Start a new trace
+    nOS_trace_reset ();
+#endif
+#if nOS_MSG_POOL
+    // Free all the message blocks
+    nOS_pool_init ();
+#endif
+#if nOS_BUDGET
+    // Clear the budgets and their measurements
+    nOS_budget_init ();
+#endif
+#if nOS_CORO
+    // Forget all the coroutines
+    nOS_coro_init ();
+#endif
     return 0;
 }
 
-nOS_err_t nOS_task_enqueue (uint8_t prio, nOS_task_callback_t callback,
+nOS_err_t nOS_task_enqueue (nOS_prio_t prio, nOS_task_ref_t callback,
                             uint8_t event)
 {
     nOS_task_t task;
 
     // Check inputs to function
-    if (NULL == callback)
+    if (!nOS_TASK_REF_IS_VALID(callback))
     {
         return nOS_TASK_ERR;
     }
-    if ((prio < 1) || (prio > 8))
+    if ((prio < 1) || (prio > nOS_PRIO_COUNT))
     {
         return nOS_PRIORITY_ERR;
     }
-    if (task_queue_is_full (&nOS_tcb_[prio - 1].task_queue_))
+
+    TASK_SET(&task, callback);
+    task.event_ = event;
+    TASK_PIN(&task, 0);
+#if nOS_STATS
+    task.enqueued_ = nOS_GET_CYCLES();
+#endif
+
+    return task_post (TCB(CURRENT_CORE, prio), &task);
+}
+
+#if (nOS_SMP_CORES > 1)
+nOS_err_t nOS_task_enqueue_core (nOS_prio_t prio, nOS_task_ref_t callback,
+                                 uint8_t event, uint8_t core)
+{
+    nOS_task_t task;
+
+    // Check inputs to function
+    if (!nOS_TASK_REF_IS_VALID(callback))
+    {
+        return nOS_TASK_ERR;
+    }
+    if ((prio < 1) || (prio > nOS_PRIO_COUNT))
     {
-        return nOS_TASK_QUEUE_ERR;
+        return nOS_PRIORITY_ERR;
+    }
+    if (nOS_CORE_ANY == core)
+    {
+        return nOS_task_enqueue (prio, callback, event);
+    }
+    if (core >= nOS_SMP_CORES)
+    {
+        return nOS_CORE_ERR;
     }
 
-    task.callback_ = callback;
+    TASK_SET(&task, callback);
     task.event_ = event;
+    TASK_PIN(&task, 1);
 
-    nOS_tcb_[prio - 1].prio_ = prio;
-    task_queue_in (&nOS_tcb_[prio - 1].task_queue_, &task);
-    prvt_vars.read_queue_flags |= read_queue_flags_mask[prio - 1];
+    return task_post (TCB(core, prio), &task);
+}
+#endif
 
-    return nOS_OK;
+#if nOS_TASK_CANCEL
+nOS_err_t nOS_task_enqueue_handle (nOS_prio_t prio, nOS_task_ref_t callback,
+                                   uint8_t event, nOS_task_handle_t *handle)
+{
+    nOS_tcb_t *nOS_tcb;
+    task_slot_t *newest;
+    nOS_task_t task;
+    nOS_err_t err;
+
+    // Check inputs to function
+    if (!nOS_TASK_REF_IS_VALID(callback) || (NULL == handle))
+    {
+        return nOS_TASK_ERR;
+    }
+    if ((prio < 1) || (prio > nOS_PRIO_COUNT))
+    {
+        return nOS_PRIORITY_ERR;
+    }
+
+    TASK_SET(&task, callback);
+    task.event_ = event;
+    TASK_PIN(&task, 0);
+#if nOS_STATS
+    task.enqueued_ = nOS_GET_CYCLES();
+#endif
+    nOS_tcb = TCB(CURRENT_CORE, prio);
+    TASKS_LOCK(TCB_CORE(nOS_tcb));
+    err = task_push (&nOS_tcb, &task);
+    if (nOS_OK == err)
+    {
+        // The task is the newest of the queue it was pushed to
+        newest = TASK_QUEUE_TAIL(&nOS_tcb->task_queue_);
+        if (newest == nOS_tcb->task_queue_.values)
+        {
+            newest += task_queue_capacity (&nOS_tcb->task_queue_);
+        }
+        handle->slot_ = TASK_SLOT(newest - 1);
+        handle->gen_ = task_gens_[handle->slot_];
+        ready_set (TCB_READY(nOS_tcb), nOS_tcb->prio_);
+    }
+    TASKS_UNLOCK(TCB_CORE(nOS_tcb));
+
+    return err;
 }
 
-nOS_err_t nOS_schedule (void)
+nOS_err_t nOS_task_cancel (nOS_task_handle_t handle)
+{
+    uint8_t core = (uint8_t) (handle.slot_ / nOS_TASK_QUEUE_TOTAL_LENGTH);
+    nOS_err_t err = nOS_TASK_ERR;
+
+    // Check inputs to function
+    if ((core >= nOS_SMP_CORES) || (0 == (handle.gen_ & 1)))
+    {
+        return nOS_TASK_ERR;
+    }
+
+    TASKS_LOCK(core);
+    // The generation moves on once the task is taken, the scheduler skips
+    // the slot of an even generation
+    if (task_gens_[handle.slot_] == handle.gen_)
+    {
+        task_gens_[handle.slot_]++;
+        err = nOS_OK;
+    }
+    TASKS_UNLOCK(core);
+
+    return err;
+}
+#endif
+
+#if nOS_TASK_COALESCE
+nOS_err_t nOS_task_enqueue_coalesced (nOS_prio_t prio,
+                                      nOS_task_ref_t callback,
+                                      uint8_t event, nOS_coalesce_t mode)
 {
-    static uint8_t const log2Lkup[] =
-    { 0, 1, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4, 5, 5, 5, 5, 5, 5, 5, 5, 5,
-            5, 5, 5, 5, 5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
-            6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 7, 7, 7, 7, 7, 7, 7,
-            7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
-            7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
-            7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
-            8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
-            8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
-            8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
-            8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
-            8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
-            8 };
+    coalesce_entry_t *entry;
+    coalesce_entry_t *free_entry = NULL;
+    nOS_task_t task;
+    nOS_err_t err;
+    uint32_t hash;
+    uint8_t probe;
+
+    // Check inputs to function
+    if (!nOS_TASK_REF_IS_VALID(callback))
+    {
+        return nOS_TASK_ERR;
+    }
+    if ((prio < 1) || (prio > nOS_PRIO_COUNT))
+    {
+        return nOS_PRIORITY_ERR;
+    }
+
+    hash = (uint32_t) ((uintptr_t) REF_CALLBACK(callback) >> 2)
+            ^ ((uint32_t) prio << 3)
+            ^ ((nOS_COALESCE_MERGE == mode) ? (uint32_t) event * 0x9Du : 0);
+    nOS_INTERRUPTS_LOCK();
+    for (probe = 0; probe < COALESCE_PROBES; probe++)
+    {
+        entry = &prvt_vars.coalesce_[(hash + probe)
+                & (nOS_TASK_COALESCE_SLOTS - 1)];
+        if (NULL == entry->callback_)
+        {
+            if (NULL == free_entry)
+            {
+                free_entry = entry;
+            }
+        }
+        else if ((entry->callback_ == REF_CALLBACK(callback))
+                && (entry->prio_ == prio)
+                && (entry->mode_ == mode)
+                && ((nOS_COALESCE_OR == mode) || (entry->event_ == event)))
+        {
+            // Already pending, fold the event in
+            entry->event_ |= event;
+            nOS_INTERRUPTS_UNLOCK();
+            return nOS_OK;
+        }
+    }
+
+    TASK_SET(&task, callback);
+    task.event_ = event;
+    TASK_PIN(&task, 0);
+    if (NULL != free_entry)
+    {
+        free_entry->callback_ = REF_CALLBACK(callback);
+        free_entry->prio_ = prio;
+        free_entry->event_ = event;
+        free_entry->mode_ = (uint8_t) mode;
+        TASK_SET(&task, COALESCED_TASK);
+        task.event_ = (uint8_t) (free_entry - prvt_vars.coalesce_);
+    }
+    // Otherwise the neighbourhood is taken, the task is queued as is
+#if nOS_STATS
+    task.enqueued_ = nOS_GET_CYCLES();
+#endif
+    err = task_post_locked (TCB(CURRENT_CORE, prio), &task);
+    if ((nOS_OK != err) && (NULL != free_entry))
+    {
+        free_entry->callback_ = NULL;
+    }
+    nOS_INTERRUPTS_UNLOCK();
+
+    return err;
+}
+#endif
 
+#if nOS_MSG_POOL
+nOS_err_t nOS_task_post_msg (nOS_prio_t prio, nOS_msg_callback_t callback,
+                             void *msg)
+{
     nOS_task_t task;
+    uint16_t block;
+    nOS_err_t err;
+
+    // Check inputs to function
+    if (NULL == callback)
+    {
+        return nOS_TASK_ERR;
+    }
+    if ((prio < 1) || (prio > nOS_PRIO_COUNT))
+    {
+        return nOS_PRIORITY_ERR;
+    }
+    // Bind the callback before the task can be dispatched
+    block = nOS_pool_attach (msg, callback);
+    if (nOS_POOL_NO_BLOCK == block)
+    {
+        return nOS_POOL_ERR;
+    }
+
+    TASK_SET(&task, MSG_TASK);
+    task.event_ = (uint8_t) block;
+    TASK_PIN(&task, 0);
+#if nOS_STATS
+    task.enqueued_ = nOS_GET_CYCLES();
+#endif
+    err = task_post (TCB(CURRENT_CORE, prio), &task);
+    if (nOS_OK != err)
+    {
+        // The caller keeps the block
+        nOS_pool_attach (msg, NULL);
+    }
+
+    return err;
+}
+#endif
+
+#ifdef nOS_TOPIC_TABLE
+nOS_err_t nOS_publish (nOS_topic_t topic, uint8_t event)
+{
+    const subscriber_t *subscriber;
+    const subscriber_t *end;
+    ready_bitmap_t posted;
     nOS_tcb_t *nOS_tcb;
-    uint8_t tcb_index;
+    uint8_t core = CURRENT_CORE;
+    nOS_task_t task;
+    nOS_err_t err = nOS_OK;
+    uint32_t bit;
 
-    // The scheduler always try to clear the ready task queue flags
-    while (prvt_vars.read_queue_flags)
+    // Check inputs to function, the subscribers were checked at compile time
+    if ((uint32_t) topic >= nOS_TOPIC_COUNT)
     {
-        // Assign a pointer to the highest priority pending queue
-        tcb_index = log2Lkup[prvt_vars.read_queue_flags] - 1;
-        nOS_tcb = &nOS_tcb_[tcb_index];
-        // If this is the last element of the queue
-        // , we can clear the pending task queue flag
-        if (1 == nOS_tcb->task_queue_.count)
+        return nOS_TOPIC_ERR;
+    }
+
+    memset (&posted, 0, sizeof(posted));
+    task.event_ = event;
+    TASK_PIN(&task, 0);
+#if nOS_STATS
+    task.enqueued_ = nOS_GET_CYCLES();
+#endif
+    subscriber = topics_[topic].subscribers_;
+    end = subscriber + topics_[topic].count_;
+    TASKS_LOCK(core);
+    for (; subscriber < end; subscriber++)
+    {
+        TASK_SET(&task, subscriber->callback_);
+        nOS_tcb = TCB(core, subscriber->prio_);
+        if (nOS_OK == task_push (&nOS_tcb, &task))
         {
-            prvt_vars.read_queue_flags &= ~(read_queue_flags_mask[nOS_tcb->prio_
-                    - 1]);
+            // The priority the task was spilled to, if its own was full
+            bit = (uint32_t) (nOS_tcb->prio_ - 1);
+            posted.words_[bit >> 5] |= (uint32_t) 1 << (bit & 31);
         }
-        // Dequeuing the last element
-        task_queue_out (&nOS_tcb->task_queue_, &task);
-        // Call the task with the event as parameter
-        task.callback_ (task.event_);
+        else
+        {
+            err = nOS_TASK_QUEUE_ERR;
+        }
+    }
+    // Flag the priorities once all the tasks were published
+    ready_set_all (&prvt_vars.ready_[core], &posted);
+    TASKS_UNLOCK(core);
+
+    return err;
+}
+#endif
+
+#if nOS_EDF
+nOS_err_t nOS_task_enqueue_deadline (nOS_prio_t prio, nOS_task_ref_t callback,
+                                     uint8_t event, nOS_tick_t deadline)
+{
+    nOS_task_t task;
+    nOS_err_t err;
+
+    // Check inputs to function
+    if (!nOS_TASK_REF_IS_VALID(callback))
+    {
+        return nOS_TASK_ERR;
+    }
+    if ((prio < 1) || (prio > nOS_PRIO_COUNT)
+            || (0 == TCB(0, prio)->deadline_length_))
+    {
+        return nOS_PRIORITY_ERR;
+    }
+
+    TASK_SET(&task, callback);
+    task.event_ = event;
+#if nOS_STATS
+    task.enqueued_ = nOS_GET_CYCLES();
+#endif
+    nOS_INTERRUPTS_LOCK();
+    err = deadline_post_locked (TCB(0, prio), &task, deadline);
+    nOS_INTERRUPTS_UNLOCK();
+
+    return err;
+}
+
+uint32_t nOS_task_deadline_misses (nOS_prio_t prio)
+{
+    if ((prio < 1) || (prio > nOS_PRIO_COUNT))
+    {
+        return 0;
+    }
+
+    return TCB(0, prio)->deadline_misses_;
+}
+#endif
+
+#if nOS_OVERFLOW_POLICY
+uint32_t nOS_task_overflows (nOS_prio_t prio, uint8_t policy)
+{
+    uint32_t overflows = 0;
+    uint8_t core;
+
+    if ((prio < 1) || (prio > nOS_PRIO_COUNT)
+            || (policy >= nOS_OVERFLOW_POLICY_COUNT))
+    {
+        return 0;
+    }
+    for (core = 0; core < nOS_SMP_CORES; core++)
+    {
+        overflows += nOS_ATOMIC_LOAD(&TCB(core, prio)->overflows_[policy]);
+    }
+
+    return overflows;
+}
+#endif
+
+nOS_err_t nOS_task_enqueue_batch (nOS_prio_t prio, nOS_task_ref_t callback,
+                                  const uint8_t *events, uint16_t n)
+{
+    // Check inputs to function
+    if (!nOS_TASK_REF_IS_VALID(callback) || (NULL == events))
+    {
+        return nOS_TASK_ERR;
+    }
+    if ((prio < 1) || (prio > nOS_PRIO_COUNT))
+    {
+        return nOS_PRIORITY_ERR;
+    }
+    if (0 == n)
+    {
+        return nOS_OK;
+    }
+
+    return task_post_n (TCB(CURRENT_CORE, prio), callback, events, n);
+}
+
+nOS_err_t nOS_schedule (void)
+{
+    // From within a task only the priorities above it run
+    schedule_above (CURRENT_PRIO);
+    // Called from a task, the task is still running and the MCU is not idle
+    if (0 == TASK_DEPTH)
+    {
+        nOS_TRACE_RECORD(nOS_TRACE_IDLE, 0, 0);
+#if nOS_TICKLESS_IDLE
+        // All the task queues are empty, sleep until there is work again
+        nOS_idle ();
+#endif
     }
 
     return 0;
 }
 
+#if nOS_PREEMPTIVE
+void nOS_isr_exit (void)
+{
+    nOS_prio_t floor = prvt_vars.current_prio_;
+    nOS_prio_t prio;
+
+    nOS_INTERRUPTS_LOCK();
+    prio = ready_highest (&prvt_vars.ready_[0]);
+    nOS_INTERRUPTS_UNLOCK();
+    // The tasks run nested on the stack of the preempted one, which resumes
+    // once no priority above it is pending
+    if (prio > floor)
+    {
+        schedule_above (floor);
+    }
+}
+#endif
+
 /* ------------------------------------------------------------- */
 /* Private function */
 /* ------------------------------------------------------------- */
+static void schedule_above (nOS_prio_t floor)
+{
+    nOS_task_t tasks[nOS_SCHEDULE_BATCH];
+    nOS_tcb_t *nOS_tcb;
+    int count;
+    int i;
+#if nOS_STATS || nOS_BUDGET
+    uint32_t started;
+    uint32_t ran;
+#endif
+#if nOS_BUDGET
+    uint32_t mark;
+#endif
+
+    // The scheduler always try to clear the ready task queue flags
+    while (NULL != (nOS_tcb = task_fetch (floor, tasks, &count)))
+    {
+        for (i = 0; i < count; i++)
+        {
+#if nOS_STATS || nOS_BUDGET
+            started = nOS_GET_CYCLES();
+#endif
+#if nOS_BUDGET
+            mark = nOS_budget_mark ();
+#endif
+            nOS_TRACE_RECORD(nOS_TRACE_START, nOS_tcb->prio_, tasks[i].event_);
+            // Call the task with the event as parameter
+            TASK_DEPTH_ENTER();
+            TASK_CALLBACK(&tasks[i]) (tasks[i].event_);
+            TASK_DEPTH_LEAVE();
+            nOS_TRACE_RECORD(nOS_TRACE_END, nOS_tcb->prio_, tasks[i].event_);
+#if nOS_STATS || nOS_BUDGET
+            ran = nOS_GET_CYCLES() - started;
+#endif
+#if nOS_STATS
+            nOS_stats_dispatched (nOS_tcb->prio_, started - tasks[i].enqueued_,
+                                  ran);
+#endif
+#if nOS_BUDGET
+            nOS_budget_dispatched (TASK_CALLBACK(&tasks[i]), nOS_tcb->prio_,
+                                   ran, mark);
+#endif
+        }
+        // task_fetch raised the running priority to the batch priority
+        CURRENT_PRIO_SET(floor);
+    }
+}
+
 /**
  * @param nOS_INSTALL_QUEUE_APIs(task_queue, nOS_task_t)
  * @param nOS_INSTALL_QUEUE_APIs(task_queue, nOS_task_t)
@@ -147,48 +969,913 @@ nOS_err_t nOS_schedule (void)
  * @brief installing the code for the queue
  * @param nOS_INSTALL_QUEUE_APIs(task_queue, nOS_task_t)
  */
+#if (nOS_TASK_QUEUE_IMPL == nOS_TASK_QUEUE_LOCK_FREE)
+nOS_INSTALL_MPSC_QUEUE_APIs(task_queue, nOS_task_t)
+#elif (nOS_TASK_QUEUE_IMPL == nOS_TASK_QUEUE_POW2)
+nOS_INSTALL_POW2_QUEUE_APIs(task_queue, nOS_task_t, nOS_TASK_QUEUE_INDEX_T)
+#else
 nOS_INSTALL_QUEUE_APIs(task_queue, nOS_task_t)
+#endif
 
-// function to initialise the TCB's
-static void init_nOS_tcb (void)
+#if (nOS_TASK_QUEUE_IMPL == nOS_TASK_QUEUE_LOCK_FREE)
+static nOS_err_t task_post (nOS_tcb_t *nOS_tcb, nOS_task_t *task)
 {
-    // Clearing the task queue ready flags and setting priority to 0 (idle)
-    memset (&prvt_vars, 0, sizeof(prvt_vars));
+    nOS_err_t err = task_push (&nOS_tcb, task);
+
+    // Flag the queue only after the task was published
+    if (nOS_OK == err)
+    {
+        ready_set (TCB_READY(nOS_tcb), nOS_tcb->prio_);
+    }
+
+    return err;
+}
+
+static nOS_err_t task_push (nOS_tcb_t **nOS_tcb, nOS_task_t *task)
+{
+    // The reservation in the queue is atomic, no need to check if it is full first
+    while (nOS_QUEUE_OK != task_queue_in (&(*nOS_tcb)->task_queue_, task))
+    {
+        QUEUE_OVERFLOWED(*nOS_tcb);
+        nOS_TRACE_RECORD(nOS_TRACE_OVERFLOW, (*nOS_tcb)->prio_, task->event_);
+        if (!task_overflow (nOS_tcb, task))
+        {
+            return nOS_TASK_QUEUE_ERR;
+        }
+    }
+    QUEUE_ENQUEUED(*nOS_tcb, 1);
+    nOS_TRACE_RECORD(nOS_TRACE_ENQUEUE, (*nOS_tcb)->prio_, task->event_);
+
+    return nOS_OK;
+}
+
+static nOS_err_t task_post_n (nOS_tcb_t *nOS_tcb, nOS_task_ref_t callback,
+                              const uint8_t *events, uint16_t n)
+{
+    nOS_task_t tasks[nOS_TASK_BATCH_CHUNK];
+    int chunk;
+#if nOS_STATS || nOS_QUEUE_PROFILE
+    uint16_t posted = n;
+#endif
+
+    // Reserve room for the whole batch, then publish it chunk by chunk
+    if (nOS_QUEUE_OK != task_queue_reserve (&nOS_tcb->task_queue_, n))
+    {
+        OVERFLOW_COUNT(nOS_tcb, nOS_OVERFLOW_REJECT);
+        QUEUE_OVERFLOWED(nOS_tcb);
+        nOS_TRACE_RECORD(nOS_TRACE_OVERFLOW, nOS_tcb->prio_, events[0]);
+        return nOS_TASK_QUEUE_ERR;
+    }
+    nOS_TRACE_RECORD(nOS_TRACE_ENQUEUE_N, nOS_tcb->prio_,
+                     (uint8_t) ((n < 255) ? n : 255));
+    while (n)
+    {
+        chunk = task_fill (tasks, callback, events, n);
+        task_queue_in_reserved (&nOS_tcb->task_queue_, tasks, chunk);
+        events += chunk;
+        n -= chunk;
+    }
+    QUEUE_ENQUEUED(nOS_tcb, posted);
+    // Flag the queue only after the tasks were published
+    ready_set (TCB_READY(nOS_tcb), nOS_tcb->prio_);
+
+    return nOS_OK;
+}
+
+static nOS_tcb_t *task_fetch (nOS_prio_t floor, nOS_task_t *tasks, int *count)
+{
+    nOS_prio_t prio;
+    nOS_tcb_t *nOS_tcb;
+
+    while (floor < (prio = ready_pick (&prvt_vars.ready_[0], floor)))
+    {
+        // Assign a pointer to the highest priority pending queue
+        nOS_tcb = TCB(0, prio);
+        // Clear the flag before dequeuing, a producer posting from now on
+        // sets it again so no task can be left behind unflagged
+        ready_clear (&prvt_vars.ready_[0], prio);
+#if nOS_EDF
+        // The deadline tasks first, a post after the flag was cleared shows
+        // in the heap count or flags the priority again
+        if (0 != nOS_tcb->deadline_count_)
+        {
+            nOS_INTERRUPTS_LOCK();
+            *count = deadline_out_n (nOS_tcb, tasks, nOS_SCHEDULE_BATCH);
+            if (0 != nOS_tcb->deadline_count_)
+            {
+                ready_set (&prvt_vars.ready_[0], prio);
+            }
+            nOS_INTERRUPTS_UNLOCK();
+            if (!task_queue_is_empty (&nOS_tcb->task_queue_))
+            {
+                ready_set (&prvt_vars.ready_[0], prio);
+            }
+            return nOS_tcb;
+        }
+#endif
+        *count = nOS_SCHEDULE_BATCH;
+        if (nOS_QUEUE_OK == task_queue_out_n (&nOS_tcb->task_queue_, tasks,
+                                              count))
+        {
+            // More tasks are pending in this queue
+            if (!task_queue_is_empty (&nOS_tcb->task_queue_))
+            {
+                ready_set (&prvt_vars.ready_[0], prio);
+            }
+            return nOS_tcb;
+        }
+        // Otherwise the oldest slot is still being written by a producer
+        // which flags the queue again once it is published
+    }
+
+    return NULL;
+}
+
+#if nOS_TASK_COALESCE
+static nOS_err_t task_post_locked (nOS_tcb_t *nOS_tcb, nOS_task_t *task)
+{
+    // The lock free post does not lock the interrupts itself
+    return task_post (nOS_tcb, task);
+}
+#endif
+
+/**
+ * The ready bitmap is shared with the producers, it is only changed with
+ * atomic read-modify-write instructions
+ */
+#define READY_LOAD(word)            nOS_ATOMIC_LOAD(word)
+#define READY_FETCH_OR(word, bits)  nOS_ATOMIC_FETCH_OR(word, bits)
+#define READY_FETCH_AND(word, bits) nOS_ATOMIC_FETCH_AND(word, bits)
+#else
+static nOS_err_t task_post (nOS_tcb_t *nOS_tcb, nOS_task_t *task)
+{
+    nOS_err_t err;
+
+    nOS_INTERRUPTS_LOCK();
+    err = task_post_locked (nOS_tcb, task);
+    nOS_INTERRUPTS_UNLOCK();
+
+    return err;
+}
+
+static nOS_err_t task_post_locked (nOS_tcb_t *nOS_tcb, nOS_task_t *task)
+{
+    nOS_err_t err;
+
+    CORE_LOCK(TCB_CORE(nOS_tcb));
+    // A spilled task stays on the same core
+    err = task_push (&nOS_tcb, task);
+    if (nOS_OK == err)
+    {
+        ready_set (TCB_READY(nOS_tcb), nOS_tcb->prio_);
+    }
+    CORE_UNLOCK(TCB_CORE(nOS_tcb));
+
+    return err;
+}
+
+static nOS_err_t task_push (nOS_tcb_t **nOS_tcb, nOS_task_t *task)
+{
+    while (task_queue_is_full (&(*nOS_tcb)->task_queue_))
+    {
+        QUEUE_OVERFLOWED(*nOS_tcb);
+        nOS_TRACE_RECORD(nOS_TRACE_OVERFLOW, (*nOS_tcb)->prio_, task->event_);
+        if (!task_overflow (nOS_tcb, task))
+        {
+            return nOS_TASK_QUEUE_ERR;
+        }
+    }
+#if nOS_TASK_CANCEL
+    task_gens_push (&(*nOS_tcb)->task_queue_, 1);
+#endif
+    task_queue_in (&(*nOS_tcb)->task_queue_, task);
+    QUEUE_ENQUEUED(*nOS_tcb, 1);
+    nOS_TRACE_RECORD(nOS_TRACE_ENQUEUE, (*nOS_tcb)->prio_, task->event_);
+
+    return nOS_OK;
+}
+
+static nOS_err_t task_post_n (nOS_tcb_t *nOS_tcb, nOS_task_ref_t callback,
+                              const uint8_t *events, uint16_t n)
+{
+    nOS_task_t tasks[nOS_TASK_BATCH_CHUNK];
+    nOS_err_t err = nOS_OK;
+    int chunk;
+#if nOS_STATS || nOS_QUEUE_PROFILE
+    uint16_t posted = n;
+#endif
+
+    nOS_INTERRUPTS_LOCK();
+    CORE_LOCK(TCB_CORE(nOS_tcb));
+    if (task_queue_capacity (&nOS_tcb->task_queue_)
+            - TASK_QUEUE_COUNT(&nOS_tcb->task_queue_) < n)
+    {
+        err = nOS_TASK_QUEUE_ERR;
+        OVERFLOW_COUNT(nOS_tcb, nOS_OVERFLOW_REJECT);
+        QUEUE_OVERFLOWED(nOS_tcb);
+        nOS_TRACE_RECORD(nOS_TRACE_OVERFLOW, nOS_tcb->prio_, events[0]);
+    }
+    else
+    {
+        nOS_TRACE_RECORD(nOS_TRACE_ENQUEUE_N, nOS_tcb->prio_,
+                         (uint8_t) ((n < 255) ? n : 255));
+#if nOS_TASK_CANCEL
+        task_gens_push (&nOS_tcb->task_queue_, n);
+#endif
+        // Every chunk fits, the room for the whole batch was checked
+        while (n)
+        {
+            chunk = task_fill (tasks, callback, events, n);
+            task_queue_in_n (&nOS_tcb->task_queue_, tasks, chunk);
+            events += chunk;
+            n -= chunk;
+        }
+        ready_set (TCB_READY(nOS_tcb), nOS_tcb->prio_);
+        QUEUE_ENQUEUED(nOS_tcb, posted);
+    }
+    CORE_UNLOCK(TCB_CORE(nOS_tcb));
+    nOS_INTERRUPTS_UNLOCK();
+
+    return err;
+}
+
+static nOS_tcb_t *task_fetch (nOS_prio_t floor, nOS_task_t *tasks, int *count)
+{
+    nOS_tcb_t *nOS_tcb = NULL;
+    uint8_t core = CURRENT_CORE;
+    nOS_prio_t prio;
+
+    nOS_INTERRUPTS_LOCK();
+#if (nOS_SMP_CORES > 1)
+    nOS_tcb = task_steal (core, tasks, count);
+    if (NULL != nOS_tcb)
+    {
+        nOS_INTERRUPTS_UNLOCK();
+        return nOS_tcb;
+    }
+#endif
+    CORE_LOCK(core);
+    prio = ready_pick (&prvt_vars.ready_[core], floor);
+    if (prio > floor)
+    {
+        // Raise the running priority before an ISR can see the queue popped,
+        // from now on it only preempts for a higher priority
+        CURRENT_PRIO_SET(prio);
+        // Assign a pointer to the highest priority pending queue
+        nOS_tcb = TCB(core, prio);
+#if nOS_EDF
+        // The deadline tasks first
+        if (0 != nOS_tcb->deadline_count_)
+        {
+            *count = deadline_out_n (nOS_tcb, tasks, nOS_SCHEDULE_BATCH);
+            if ((0 == nOS_tcb->deadline_count_)
+                    && (0 == TASK_QUEUE_COUNT(&nOS_tcb->task_queue_)))
+            {
+                ready_clear (&prvt_vars.ready_[core], prio);
+            }
+            CORE_UNLOCK(core);
+            nOS_INTERRUPTS_UNLOCK();
+            return nOS_tcb;
+        }
+#endif
+        *count = TASK_QUEUE_COUNT(&nOS_tcb->task_queue_);
+        // If the batch takes the last elements of the queue
+        // , we can clear the pending task queue flag
+        if (*count <= nOS_SCHEDULE_BATCH)
+        {
+            ready_clear (&prvt_vars.ready_[core], prio);
+        }
+        else
+        {
+            *count = nOS_SCHEDULE_BATCH;
+        }
+        // Dequeuing the batch
+        TASK_TAKE_N(&nOS_tcb->task_queue_, tasks, count);
+    }
+    CORE_UNLOCK(core);
+    nOS_INTERRUPTS_UNLOCK();
+
+    return nOS_tcb;
+}
+
+#if (nOS_SMP_CORES > 1)
+static nOS_tcb_t *task_steal (uint8_t core, nOS_task_t *tasks, int *count)
+{
+    nOS_prio_t best = ready_highest (&prvt_vars.ready_[core]);
+    nOS_prio_t prio;
+    nOS_tcb_t *nOS_tcb;
+    uint8_t victim = core;
+    uint8_t other;
+    int one;
+
+    // The bitmaps of the other cores are only read, a stale view costs a
+    // failed steal or a late one, never a lost task
+    for (other = 0; other < nOS_SMP_CORES; other++)
+    {
+        if (other != core)
+        {
+            prio = ready_highest (&prvt_vars.ready_[other]);
+            if (prio > best)
+            {
+                best = prio;
+                victim = other;
+            }
+        }
+    }
+    if (victim == core)
+    {
+        return NULL;
+    }
+
+    nOS_tcb = TCB(victim, best);
+    *count = 0;
+    CORE_LOCK(victim);
+    // Take the tasks up to the first one pinned to the victim
+    while ((*count < nOS_SCHEDULE_BATCH)
+            && (0 != TASK_QUEUE_COUNT(&nOS_tcb->task_queue_))
+            && !TASK_QUEUE_HEAD(&nOS_tcb->task_queue_)->pinned_)
+    {
+        one = 1;
+        TASK_TAKE_N(&nOS_tcb->task_queue_, &tasks[*count], &one);
+        *count += one;
+    }
+    if (0 == TASK_QUEUE_COUNT(&nOS_tcb->task_queue_))
+    {
+        ready_clear (&prvt_vars.ready_[victim], best);
+    }
+    CORE_UNLOCK(victim);
+
+    return (0 != *count) ? nOS_tcb : NULL;
+}
+#endif
+
+#if (nOS_SMP_CORES > 1)
+/**
+ * The other cores read the ready bitmaps without the core lock
+ */
+#define READY_LOAD(word)            nOS_ATOMIC_LOAD(word)
+#define READY_FETCH_OR(word, bits)  nOS_ATOMIC_FETCH_OR(word, bits)
+#define READY_FETCH_AND(word, bits) nOS_ATOMIC_FETCH_AND(word, bits)
+#else
+/**
+ * The ready bitmap is only accessed with interrupts locked
+ */
+static inline uint32_t ready_fetch_or (uint32_t *word, uint32_t bits)
+{
+    uint32_t old = *word;
+    *word = old | bits;
+    return old;
+}
+
+static inline uint32_t ready_fetch_and (uint32_t *word, uint32_t bits)
+{
+    uint32_t old = *word;
+    *word = old & bits;
+    return old;
+}
+
+#define READY_LOAD(word)            (*(word))
+#define READY_FETCH_OR(word, bits)  ready_fetch_or (word, bits)
+#define READY_FETCH_AND(word, bits) ready_fetch_and (word, bits)
+#endif
+#endif
+
+#if (READY_WORDS > 1)
+/**
+ * @brief A function to clear the summary bit of an empty ready word
+ */
+static void ready_summary_clear (ready_bitmap_t *ready, uint32_t word)
+{
+    READY_FETCH_AND(&ready->summary_, ~((uint32_t) 1 << word));
+    // A producer may have flagged a priority of the word meanwhile
+    if (0 != READY_LOAD(&ready->words_[word]))
+    {
+        READY_FETCH_OR(&ready->summary_, (uint32_t) 1 << word);
+    }
+}
+#endif
+
+static void ready_set (ready_bitmap_t *ready, nOS_prio_t prio)
+{
+    uint32_t word = (uint32_t) (prio - 1) >> 5;
+
+    READY_FETCH_OR(&ready->words_[word], (uint32_t) 1 << ((prio - 1) & 31));
+#if (READY_WORDS > 1)
+    READY_FETCH_OR(&ready->summary_, (uint32_t) 1 << word);
+#endif
+}
+
+static void ready_clear (ready_bitmap_t *ready, nOS_prio_t prio)
+{
+    uint32_t word = (uint32_t) (prio - 1) >> 5;
+    uint32_t bit = (uint32_t) 1 << ((prio - 1) & 31);
+
+#if (READY_WORDS > 1)
+    if (0 == (READY_FETCH_AND(&ready->words_[word], ~bit) & ~bit))
+    {
+        ready_summary_clear (ready, word);
+    }
+#else
+    READY_FETCH_AND(&ready->words_[word], ~bit);
+#endif
+}
+
+#ifdef nOS_TOPIC_TABLE
+static void ready_set_all (ready_bitmap_t *ready, const ready_bitmap_t *posted)
+{
+    uint32_t word;
+#if (READY_WORDS > 1)
+    uint32_t summary = 0;
+#endif
+
+    for (word = 0; word < READY_WORDS; word++)
+    {
+        if (0 != posted->words_[word])
+        {
+            READY_FETCH_OR(&ready->words_[word], posted->words_[word]);
+#if (READY_WORDS > 1)
+            summary |= (uint32_t) 1 << word;
+#endif
+        }
+    }
+#if (READY_WORDS > 1)
+    if (0 != summary)
+    {
+        READY_FETCH_OR(&ready->summary_, summary);
+    }
+#endif
+}
+#endif
+
+static nOS_prio_t ready_highest (ready_bitmap_t *ready)
+{
+    uint32_t bits;
+#if (READY_WORDS > 1)
+    uint32_t summary;
+    uint32_t word;
+
+    while (0 != (summary = READY_LOAD(&ready->summary_)))
+    {
+        word = 31 - nOS_CLZ32(summary);
+        bits = READY_LOAD(&ready->words_[word]);
+        if (0 != bits)
+        {
+            return (nOS_prio_t) ((word << 5) + 32 - nOS_CLZ32(bits));
+        }
+        // The word was emptied after the summary was read
+        ready_summary_clear (ready, word);
+    }
+
+    return 0;
+#else
+    bits = READY_LOAD(&ready->words_[0]);
+
+    return (0 != bits) ? (nOS_prio_t) (32 - nOS_CLZ32(bits)) : 0;
+#endif
+}
+
+static nOS_prio_t ready_pick (ready_bitmap_t *ready, nOS_prio_t floor)
+{
+    nOS_prio_t prio = ready_highest (ready);
+#if nOS_AGING_CREDITS
+    nOS_prio_t lowest;
+    nOS_prio_t aged;
+
+    if (prio <= floor)
+    {
+        return prio;
+    }
+    lowest = ready_next (ready, floor);
+    if ((lowest <= floor) || (lowest >= prio))
+    {
+        // No lower priority waits
+        prvt_vars.aging_bypassed_ = 0;
+        return prio;
+    }
+    if (prvt_vars.aging_bypassed_ < nOS_AGING_CREDITS)
+    {
+        prvt_vars.aging_bypassed_++;
+        return prio;
+    }
+    // The credits are spent, the waiting priority after the last one that
+    // took a turn runs one batch
+    prvt_vars.aging_bypassed_ = 0;
+    aged = ready_next (ready, prvt_vars.aged_prio_);
+    if ((aged <= floor) || (aged >= prio))
+    {
+        aged = lowest;
+    }
+    prvt_vars.aged_prio_ = aged;
+
+    return aged;
+#else
+    (void) floor;
+    return prio;
+#endif
+}
+
+#if nOS_AGING_CREDITS
+// The index of the lowest set bit of a non zero word
+#define READY_LOWEST_BIT(bits)  (31 - nOS_CLZ32((bits) & (0u - (bits))))
+
+static nOS_prio_t ready_next (ready_bitmap_t *ready, nOS_prio_t after)
+{
+    uint32_t bits;
+#if (READY_WORDS > 1)
+    uint32_t word = (uint32_t) after >> 5;
+    uint32_t summary = 0;
+    int pass;
+
+    // The priorities above after in its own word, then in the next words
+    if (word < READY_WORDS)
+    {
+        bits = READY_LOAD(&ready->words_[word]) & (~(uint32_t) 0 << (after & 31));
+        if (0 != bits)
+        {
+            return (nOS_prio_t) ((word << 5) + READY_LOWEST_BIT(bits) + 1);
+        }
+        summary = (word < 31) ? ~(uint32_t) 0 << (word + 1) : 0;
+    }
+    // Wrap around to the lowest ready priority on the second pass
+    for (pass = 0; pass < 2; pass++)
+    {
+        summary &= READY_LOAD(&ready->summary_);
+        while (0 != summary)
+        {
+            word = READY_LOWEST_BIT(summary);
+            bits = READY_LOAD(&ready->words_[word]);
+            if (0 != bits)
+            {
+                return (nOS_prio_t) ((word << 5) + READY_LOWEST_BIT(bits) + 1);
+            }
+            // The word was emptied after the summary was read
+            summary &= summary - 1;
+        }
+        summary = ~(uint32_t) 0;
+    }
+
+    return 0;
+#else
+    uint32_t above;
+
+    bits = READY_LOAD(&ready->words_[0]);
+    above = (after < 32) ? bits & (~(uint32_t) 0 << after) : 0;
+    if (0 == above)
+    {
+        above = bits;
+    }
+
+    return (0 != above) ? (nOS_prio_t) (READY_LOWEST_BIT(above) + 1) : 0;
+#endif
+}
+#endif
+
+#if nOS_TASK_COALESCE
+static void coalesced_task (uint8_t event)
+{
+    coalesce_entry_t *entry = &prvt_vars.coalesce_[event];
+    nOS_task_callback_t callback;
+    uint8_t merged;
+
+    // Free the entry first, a post from now on queues a new task
+    nOS_INTERRUPTS_LOCK();
+    callback = entry->callback_;
+    merged = entry->event_;
+    entry->callback_ = NULL;
+    nOS_INTERRUPTS_UNLOCK();
+
+    callback (merged);
+}
+#endif
+
+#if nOS_OVERFLOW_POLICY
+static int task_overflow (nOS_tcb_t **nOS_tcb, nOS_task_t *task)
+{
+    nOS_tcb_t *full = *nOS_tcb;
+#if (nOS_TASK_QUEUE_IMPL != nOS_TASK_QUEUE_LOCK_FREE)
+    nOS_task_t dropped;
+    int one = 1;
+#endif
+
+    switch (overflow_policies_[full->prio_ - 1])
+    {
+#if (nOS_TASK_QUEUE_IMPL != nOS_TASK_QUEUE_LOCK_FREE)
+        case nOS_OVERFLOW_DROP_OLDEST:
+            // TASKS_LOCK is held, the consumer cannot pop meanwhile
+            TASK_TAKE_N(&full->task_queue_, &dropped, &one);
+            // A cancelled oldest task only frees its slot, nothing is dropped
+            if (one)
+            {
+                task_drop (&dropped);
+                OVERFLOW_COUNT(full, nOS_OVERFLOW_DROP_OLDEST);
+            }
+            return 1;
+#endif
+        case nOS_OVERFLOW_SPILL:
+            if (full->prio_ > 1)
+            {
+                OVERFLOW_COUNT(full, nOS_OVERFLOW_SPILL);
+                // The TCBs of a core are in priority order
+                *nOS_tcb = full - 1;
+                return 1;
+            }
+            break;
+#if nOS_BACK_PRESSURE_USED
+        case nOS_OVERFLOW_BACK_PRESSURE:
+            OVERFLOW_COUNT(full, nOS_OVERFLOW_BACK_PRESSURE);
+            nOS_task_back_pressure (full->prio_, TASK_REF(task), task->event_);
+            return 0;
+#endif
+        default:
+            break;
+    }
+    OVERFLOW_COUNT(full, nOS_OVERFLOW_REJECT);
+
+    return 0;
+}
+
+#if (nOS_TASK_QUEUE_IMPL != nOS_TASK_QUEUE_LOCK_FREE)
+static void task_drop (nOS_task_t *task)
+{
+#if nOS_TASK_COALESCE
+    if (coalesced_task == TASK_CALLBACK(task))
+    {
+        // The entry is free for the next post
+        prvt_vars.coalesce_[task->event_].callback_ = NULL;
+    }
+#endif
+#if nOS_MSG_POOL
+    if (nOS_pool_dispatch == TASK_CALLBACK(task))
+    {
+        nOS_pool_drop (task->event_);
+    }
+#endif
+    (void) task;
+}
+#endif
+#endif
+
+#if nOS_TASK_CANCEL
+static void task_gens_push (task_queue_t *queue, int n)
+{
+    task_slot_t *slot = TASK_QUEUE_TAIL(queue);
+    task_slot_t *end = queue->values + task_queue_capacity (queue);
+
+    for (; n > 0; n--)
+    {
+        task_gens_[TASK_SLOT(slot)]++;
+        if (++slot == end)
+        {
+            slot = queue->values;
+        }
+    }
+}
+
+static void task_take_n (task_queue_t *queue, nOS_task_t *tasks, int *count)
+{
+    task_slot_t *slot = TASK_QUEUE_HEAD(queue);
+    task_slot_t *end = queue->values + task_queue_capacity (queue);
+    uint16_t *gen;
+    int live = 0;
+    int i;
+
+    TASK_QUEUE_OUT_N(queue, tasks, count);
+    for (i = 0; i < *count; i++)
+    {
+        gen = &task_gens_[TASK_SLOT(slot)];
+        // An even generation was cancelled, its slot is free already
+        if (*gen & 1)
+        {
+            (*gen)++;
+            tasks[live++] = tasks[i];
+        }
+        if (++slot == end)
+        {
+            slot = queue->values;
+        }
+    }
+    *count = live;
+}
+#endif
+
+#if nOS_EDF
+/**
+ * @brief A function to compare two deadline tasks, the deadlines may wrap
+ * @return 1 if a runs before b
+ */
+static inline int deadline_before (const deadline_task_t *a,
+                                   const deadline_task_t *b)
+{
+    int32_t diff = (int32_t) (a->deadline_ - b->deadline_);
+
+    if (0 != diff)
+    {
+        return diff < 0;
+    }
+    // The gap is the posts made while the older task waited, it wraps apart
+    // only after 2^31 of them
+    return (int32_t) (a->seq_ - b->seq_) < 0;
+}
+
+static nOS_err_t deadline_post_locked (nOS_tcb_t *nOS_tcb, nOS_task_t *task,
+                                       nOS_tick_t deadline)
+{
+    deadline_task_t *heap = nOS_tcb->deadlines_;
+    deadline_task_t posted;
+    uint16_t parent;
+    uint16_t i;
+
+    if (nOS_tcb->deadline_count_ >= nOS_tcb->deadline_length_)
+    {
+        OVERFLOW_COUNT(nOS_tcb, nOS_OVERFLOW_REJECT);
+        QUEUE_OVERFLOWED(nOS_tcb);
+        nOS_TRACE_RECORD(nOS_TRACE_OVERFLOW, nOS_tcb->prio_, task->event_);
+        return nOS_TASK_QUEUE_ERR;
+    }
+    posted.task_ = *task;
+    posted.deadline_ = deadline;
+    posted.seq_ = nOS_tcb->deadline_seq_++;
+    // Sift up from the new leaf
+    i = nOS_tcb->deadline_count_++;
+    while (i > 0)
+    {
+        parent = (uint16_t) ((i - 1) >> 1);
+        if (!deadline_before (&posted, &heap[parent]))
+        {
+            break;
+        }
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i] = posted;
+    nOS_TRACE_RECORD(nOS_TRACE_ENQUEUE, nOS_tcb->prio_, task->event_);
+    ready_set (TCB_READY(nOS_tcb), nOS_tcb->prio_);
+
+    return nOS_OK;
+}
+
+static int deadline_out_n (nOS_tcb_t *nOS_tcb, nOS_task_t *tasks, int n)
+{
+    deadline_task_t *heap = nOS_tcb->deadlines_;
+    nOS_tick_t now = nOS_timer_now ();
+    deadline_task_t *last;
+    uint16_t count;
+    uint16_t child;
+    uint16_t i;
+    int popped;
+
+    for (popped = 0; (popped < n) && (0 != nOS_tcb->deadline_count_); popped++)
+    {
+        tasks[popped] = heap[0].task_;
+        if ((int32_t) (now - heap[0].deadline_) > 0)
+        {
+            nOS_tcb->deadline_misses_++;
+        }
+        // Sift the last leaf down from the root
+        count = --nOS_tcb->deadline_count_;
+        last = &heap[count];
+        i = 0;
+        while ((child = (uint16_t) (2 * i + 1)) < count)
+        {
+            if ((child + 1 < count)
+                    && deadline_before (&heap[child + 1], &heap[child]))
+            {
+                child++;
+            }
+            if (!deadline_before (&heap[child], last))
+            {
+                break;
+            }
+            heap[i] = heap[child];
+            i = child;
+        }
+        heap[i] = *last;
+    }
+
+    return popped;
+}
+#endif
+
+static int task_fill (nOS_task_t *tasks, nOS_task_ref_t callback,
+                      const uint8_t *events, uint16_t n)
+{
+    int chunk = (n < nOS_TASK_BATCH_CHUNK) ? n : nOS_TASK_BATCH_CHUNK;
+    int i;
+#if nOS_STATS
+    uint32_t enqueued = nOS_GET_CYCLES();
+#endif
+
+    for (i = 0; i < chunk; i++)
+    {
+        TASK_SET(&tasks[i], callback);
+        tasks[i].event_ = events[i];
+        TASK_PIN(&tasks[i], 0);
+#if nOS_STATS
+        tasks[i].enqueued_ = enqueued;
+#endif
+    }
+
+    return chunk;
+}
+
+#if nOS_TICKLESS_IDLE
+static void nOS_idle (void)
+{
+    nOS_tick_t elapsed = 0;
+    nOS_tick_t next;
+
+    // Interrupts stay locked from the ready flags check until the port
+    // sleeps, a task posted in between keeps the MCU awake
+    nOS_INTERRUPTS_LOCK();
+    if (0 == ready_highest (&prvt_vars.ready_[0]))
+    {
+        next = nOS_timer_next_expiry ();
+        elapsed = nOS_port_sleep_until (
+                (nOS_TICK_FOREVER == next) ?
+                        nOS_TICK_FOREVER : nOS_timer_now () + next);
+    }
+    nOS_INTERRUPTS_UNLOCK();
+    // Catch up with the ticks that were not counted during the sleep
+    nOS_timer_advance (elapsed);
+}
+#endif
+
+// function to initialise the TCB's
+static void init_nOS_tcb (void)
+{
+    task_slot_t *container = task_q_container_;
+#if nOS_EDF
+    deadline_task_t *deadlines = deadline_container_;
+#endif
+    uint16_t i;
+
+    // Clearing the task queue ready flags and setting priority to 0 (idle)
+    memset (&prvt_vars, 0, sizeof(prvt_vars));
     // Clear all the nOS_tcb_
     memset (nOS_tcb_, 0, sizeof(nOS_tcb_));
+#if nOS_TASK_CANCEL
+    // Free the slots of the dropped tasks, their handles are never reused
+    for (i = 0; i < nOS_SMP_CORES * nOS_TASK_QUEUE_TOTAL_LENGTH; i++)
+    {
+        task_gens_[i] += task_gens_[i] & 1;
+    }
+#endif
     // Initialise all TCB by assigning the following:
     // Priority, pointer to the queue data container
     // The user defined queue length
-    // priority 1
-    nOS_tcb_[0].prio_ = 1;
-    nOS_tcb_[0].task_queue_.capacity = nOS_PRIO1_TASK_QUEUE_LENGTH;
-    nOS_tcb_[0].task_queue_.values = prio1_task_q_container_;
-    // priority 2
-    nOS_tcb_[1].prio_ = 2;
-    nOS_tcb_[1].task_queue_.capacity = nOS_PRIO2_TASK_QUEUE_LENGTH;
-    nOS_tcb_[1].task_queue_.values = prio2_task_q_container_;
-    // priority 3
-    nOS_tcb_[2].prio_ = 3;
-    nOS_tcb_[2].task_queue_.capacity = nOS_PRIO3_TASK_QUEUE_LENGTH;
-    nOS_tcb_[2].task_queue_.values = prio3_task_q_container_;
-    // priority 4
-    nOS_tcb_[3].prio_ = 4;
-    nOS_tcb_[3].task_queue_.capacity = nOS_PRIO4_TASK_QUEUE_LENGTH;
-    nOS_tcb_[3].task_queue_.values = prio4_task_q_container_;
-    // priority 5
-    nOS_tcb_[4].prio_ = 5;
-    nOS_tcb_[4].task_queue_.capacity = nOS_PRIO5_TASK_QUEUE_LENGTH;
-    nOS_tcb_[4].task_queue_.values = prio5_task_q_container_;
-    // priority 6
-    nOS_tcb_[5].prio_ = 6;
-    nOS_tcb_[5].task_queue_.capacity = nOS_PRIO6_TASK_QUEUE_LENGTH;
-    nOS_tcb_[5].task_queue_.values = prio6_task_q_container_;
-    // priority 7
-    nOS_tcb_[6].prio_ = 7;
-    nOS_tcb_[6].task_queue_.capacity = nOS_PRIO7_TASK_QUEUE_LENGTH;
-    nOS_tcb_[6].task_queue_.values = prio7_task_q_container_;
-    // priority 8
-    nOS_tcb_[7].prio_ = 8;
-    nOS_tcb_[7].task_queue_.capacity = nOS_PRIO8_TASK_QUEUE_LENGTH;
-    nOS_tcb_[7].task_queue_.values = prio8_task_q_container_;
+    // The queue init also clears the container of left over tasks
+    for (i = 0; i < nOS_SMP_CORES * nOS_PRIO_COUNT; i++)
+    {
+        nOS_tcb_[i].prio_ = (nOS_prio_t) (i % nOS_PRIO_COUNT + 1);
+#if (nOS_SMP_CORES > 1)
+        nOS_tcb_[i].core_ = (uint8_t) (i / nOS_PRIO_COUNT);
+#endif
+        task_queue_init (&nOS_tcb_[i].task_queue_, container,
+                         task_queue_lengths_[i % nOS_PRIO_COUNT]);
+        container += task_queue_lengths_[i % nOS_PRIO_COUNT];
+#if nOS_EDF
+        nOS_tcb_[i].deadlines_ = deadlines;
+        nOS_tcb_[i].deadline_length_ = deadline_lengths_[i % nOS_PRIO_COUNT];
+        deadlines += deadline_lengths_[i % nOS_PRIO_COUNT];
+#endif
+    }
+#if nOS_STATS
+    for (i = 0; i < nOS_PRIO_COUNT; i++)
+    {
+        nOS_stats_init (nOS_tcb_[i].prio_,
+                        (uint16_t) task_queue_capacity (&nOS_tcb_[i].task_queue_));
+    }
+#endif
+#if nOS_QUEUE_PROFILE
+    for (i = 0; i < nOS_PRIO_COUNT; i++)
+    {
+        nOS_profile_init (nOS_tcb_[i].prio_,
+                          (uint16_t) task_queue_capacity (&nOS_tcb_[i].task_queue_));
+    }
+#endif
+}
+
+#if nOS_STATS || nOS_QUEUE_PROFILE
+static void queue_enqueued (nOS_tcb_t *nOS_tcb, uint16_t n)
+{
+    // Read once, both modules record the same occupancy
+    uint16_t count = (uint16_t) TASK_QUEUE_COUNT(&nOS_tcb->task_queue_);
+
+#if nOS_STATS
+    nOS_stats_enqueued (nOS_tcb->prio_, count);
+#endif
+#if nOS_QUEUE_PROFILE
+    nOS_profile_enqueued (nOS_tcb->prio_, count, n);
+#endif
+}
+
+static void queue_overflowed (nOS_tcb_t *nOS_tcb)
+{
+#if nOS_STATS
+    nOS_stats_overflowed (nOS_tcb->prio_);
+#endif
+#if nOS_QUEUE_PROFILE
+    nOS_profile_overflowed (nOS_tcb->prio_);
+#endif
 }
+#endif
@@ -19,21 +19,74 @@ typedef enum
     nOS_TASK_ERR,       //!< nOS_TASK_ERR
     nOS_PRIORITY_ERR,   //!< nOS_PRIORITY_ERR
     nOS_TASK_QUEUE_ERR, //!< nOS_QUEUE_ERR
+    nOS_TIMER_ERR,      //!< nOS_TIMER_ERR
+    nOS_POOL_ERR,       //!< nOS_POOL_ERR
+    nOS_CORE_ERR,       //!< nOS_CORE_ERR
+    nOS_TOPIC_ERR,      //!< nOS_TOPIC_ERR
+    nOS_BUDGET_ERR,     //!< nOS_BUDGET_ERR
+    nOS_CORO_ERR,       //!< nOS_CORO_ERR
     nOS_UNKNOWN_ERR     //!< nOS_UNKNOWN_ERR
 } nOS_err_t;
 
+/**
+ * @brief A priority, from 1 (the lowest) to nOS_PRIO_COUNT (the highest)
+ */
+#if (nOS_PRIO_COUNT > 255)
+typedef uint16_t nOS_prio_t;
+#else
+typedef uint8_t nOS_prio_t;
+#endif
+
+/**
+ * @brief The kernel time base, one unit per nOS_timer_tick call (nanoTimer.h)
+ */
+typedef uint32_t nOS_tick_t;
+
 /**
  *
  * @param event
  */
 typedef void (*nOS_task_callback_t) (uint8_t event);
+
+/**
+ * @brief How a task is named when it is posted, by default its callback.
+ * When the application lists its tasks in nOS_TASK_TABLE (see nanoConfig.h)
+ * a task is named by its ID, nOS_TASK_ID(callback), and a queued task only
+ * takes two bytes.
+ */
+#ifdef nOS_TASK_TABLE
+#define nOS_TASK_ID(callback)               nOS_ID_##callback
+#define nOS_TASK_ID_ENTRY(callback)         nOS_TASK_ID(callback),
+#define nOS_TASK_PROTOTYPE_ENTRY(callback)  void callback (uint8_t event);
+nOS_TASK_TABLE(nOS_TASK_PROTOTYPE_ENTRY)
+typedef enum
+{
+    nOS_TASK_TABLE(nOS_TASK_ID_ENTRY)
+    nOS_TASK_COUNT
+} nOS_task_ref_t;
+#define nOS_TASK_REF_IS_VALID(ref)          ((uint32_t) (ref) < nOS_TASK_COUNT)
+#else
+typedef nOS_task_callback_t nOS_task_ref_t;
+#define nOS_TASK_REF_IS_VALID(ref)          (NULL != (ref))
+#endif
+
 /**
  *
  */
 typedef struct
 {
+#ifdef nOS_TASK_TABLE
+    uint8_t id_; // The index of the callback in nOS_TASK_TABLE
+#else
     nOS_task_callback_t callback_;
+#endif
     uint8_t event_;
+#if (nOS_SMP_CORES > 1)
+    uint8_t pinned_; // 1 when the other cores shall not steal the task
+#endif
+#if nOS_STATS
+    uint32_t enqueued_; // The cycle counter when the task was queued
+#endif
 } nOS_task_t;
 
 /**
@@ -45,18 +98,232 @@ nOS_err_t nOS_start (void);
 /**
  * @brief A function to enqueue a task in on of the priority queues
  * @param prio- The priority of the task
- * @param callback- The actual task callback function
+ * @param callback- The actual task callback function, or its nOS_TASK_ID
  * @param event- An optional event argument to pass the task per callback
  * @return nOS_err_t
  * @note This function invokes the scheduler.
  */
-nOS_err_t nOS_task_enqueue (uint8_t prio, nOS_task_callback_t callback, uint8_t event);
+nOS_err_t nOS_task_enqueue (nOS_prio_t prio, nOS_task_ref_t callback,
+                            uint8_t event);
+
+#if (nOS_SMP_CORES > 1)
+/**
+ * @brief Any core, the task goes to the calling core and can be stolen
+ */
+#define nOS_CORE_ANY    0xFF
+
+/**
+ * @brief A function to enqueue a task on a given core
+ * @param prio- The priority of the task
+ * @param callback- The actual task callback function, or its nOS_TASK_ID
+ * @param event- An optional event argument to pass the task per callback
+ * @param core- The core to run the task, from 0, or nOS_CORE_ANY
+ * @return nOS_err_t, nOS_CORE_ERR if there is no such core
+ * @note A task for a given core is never stolen by the other cores, the
+ * tasks queued after it at its priority are only stolen once it ran.
+ */
+nOS_err_t nOS_task_enqueue_core (nOS_prio_t prio, nOS_task_ref_t callback,
+                                 uint8_t event, uint8_t core);
+#endif
+
+#if nOS_TASK_CANCEL
+/**
+ * @brief The handle of a queued task, a zeroed handle is never valid
+ */
+typedef struct
+{
+    uint16_t slot_; // The task queue slot of the task
+    uint16_t gen_;  // The generation of the slot, odd while the task is pending
+} nOS_task_handle_t;
+
+/**
+ * @brief A function to enqueue a task that can be cancelled
+ * @param prio- The priority of the task
+ * @param callback- The actual task callback function, or its nOS_TASK_ID
+ * @param event- An optional event argument to pass the task per callback
+ * @param handle- Output, the handle of the task for nOS_task_cancel
+ * @return nOS_err_t, the handle is only set on nOS_OK
+ */
+nOS_err_t nOS_task_enqueue_handle (nOS_prio_t prio, nOS_task_ref_t callback,
+                                   uint8_t event, nOS_task_handle_t *handle);
+
+/**
+ * @brief A function to withdraw a queued task in O(1), the scheduler skips
+ * it without calling it
+ * @param handle- The handle of nOS_task_enqueue_handle
+ * @return nOS_OK, or nOS_TASK_ERR if the task was already taken by the
+ * scheduler, was already cancelled or the handle is invalid
+ */
+nOS_err_t nOS_task_cancel (nOS_task_handle_t handle);
+#endif
+
+#if nOS_TASK_COALESCE
+/**
+ * @brief How a post folds into the pending instance of its task
+ */
+typedef enum
+{
+    nOS_COALESCE_MERGE, //!< The same callback and event run once
+    nOS_COALESCE_OR     //!< The callback runs once with the OR of the event bits
+} nOS_coalesce_t;
+
+/**
+ * @brief A function to enqueue a task unless it is already pending, e.g. for
+ * tasks posted from interrupt storms
+ * @param prio- The priority of the task
+ * @param callback- The actual task callback function, or its nOS_TASK_ID
+ * @param event- The event, or the event bits for nOS_COALESCE_OR
+ * @param mode- nOS_COALESCE_MERGE or nOS_COALESCE_OR
+ * @return nOS_err_t
+ * @note A task is pending from its post until its callback is called, a post
+ * from the callback itself queues it again. The post locks the interrupts
+ * for the lookup, also with nOS_TASK_QUEUE_LOCK_FREE.
+ */
+nOS_err_t nOS_task_enqueue_coalesced (nOS_prio_t prio,
+                                      nOS_task_ref_t callback,
+                                      uint8_t event, nOS_coalesce_t mode);
+#endif
+
+/**
+ * @brief A function to enqueue a batch of tasks with the same callback, one
+ * task per event, e.g. an ISR posting a whole DMA buffer at once
+ * @param prio- The priority of the tasks
+ * @param callback- The actual task callback function, or its nOS_TASK_ID
+ * @param events- The events to pass the tasks, one task per event
+ * @param n- The number of events
+ * @return nOS_err_t, nOS_TASK_QUEUE_ERR if the queue has no room for all the
+ * events, then none is queued
+ */
+nOS_err_t nOS_task_enqueue_batch (nOS_prio_t prio, nOS_task_ref_t callback,
+                                  const uint8_t *events, uint16_t n);
+
+#if nOS_MSG_POOL
+/**
+ * @brief The callback of a message task
+ * @param msg- The message block, owned by the callback until it returns
+ */
+typedef void (*nOS_msg_callback_t) (void *msg);
+
+/**
+ * @brief A function to enqueue a task with a message block, the block is
+ * handed over without a copy, e.g. a frame an ISR filled
+ * @param prio- The priority of the task
+ * @param callback- The task callback function, it receives the block
+ * @param msg- A block from nOS_pool_alloc (see nanoPool.h)
+ * @return nOS_err_t, nOS_POOL_ERR if msg is not a pool block or is free
+ * @note On nOS_OK the kernel owns the block and frees it after the callback
+ * returned, unless the callback posted it again. On an error the caller
+ * still owns the block.
+ */
+nOS_err_t nOS_task_post_msg (nOS_prio_t prio, nOS_msg_callback_t callback,
+                             void *msg);
+#endif
+
+#ifdef nOS_TOPIC_TABLE
+/**
+ * @brief How a topic is named when it is published, nOS_TOPIC(topic) of the
+ * nOS_TOPIC_TABLE (see nanoConfig.h)
+ */
+#define nOS_TOPIC(topic)                    nOS_TOPIC_##topic
+#define nOS_TOPIC_ID_ENTRY(topic, subscribers) nOS_TOPIC(topic),
+#define nOS_TOPIC_PROTOTYPE_ENTRY(topic, subscribers) subscribers
+#define nOS_SUBSCRIBER(prio, callback)      void callback (uint8_t event);
+nOS_TOPIC_TABLE(nOS_TOPIC_PROTOTYPE_ENTRY)
+#undef nOS_SUBSCRIBER
+typedef enum
+{
+    nOS_TOPIC_TABLE(nOS_TOPIC_ID_ENTRY)
+    nOS_TOPIC_COUNT
+} nOS_topic_t;
+
+/**
+ * @brief A function to post an event to all the subscribers of a topic, e.g.
+ * an ISR fanning out to several handlers
+ * @param topic- The topic, nOS_TOPIC(topic)
+ * @param event- The event argument to pass every subscriber
+ * @return nOS_err_t, nOS_TOPIC_ERR if there is no such topic,
+ * nOS_TASK_QUEUE_ERR if the queue of a subscriber was full, the other
+ * subscribers still got the event
+ * @note The subscribers are checked at compile time, a publish only queues
+ * the tasks, in one critical section, and flags their priorities at once.
+ */
+nOS_err_t nOS_publish (nOS_topic_t topic, uint8_t event);
+#endif
+
+#if nOS_EDF
+/**
+ * @brief A function to enqueue a task by its deadline, the tasks of an EDF
+ * priority (see nOS_TASK_DEADLINE_LENGTHS) run earliest deadline first, ahead
+ * of the tasks of the priority posted without a deadline
+ * @param prio- The priority of the task, it shall have a deadline heap
+ * @param callback- The actual task callback function, or its nOS_TASK_ID
+ * @param event- An optional event argument to pass the task per callback
+ * @param deadline- The absolute deadline, a tick of nOS_timer_now()
+ * @return nOS_err_t, nOS_PRIORITY_ERR if the priority has no deadline heap,
+ * nOS_TASK_QUEUE_ERR if its heap is full
+ * @note The tasks of the same deadline run in their post order. A task
+ * dispatched after its deadline tick counts as a deadline miss.
+ */
+nOS_err_t nOS_task_enqueue_deadline (nOS_prio_t prio, nOS_task_ref_t callback,
+                                     uint8_t event, nOS_tick_t deadline);
+
+/**
+ * @brief A function to read the deadline misses of a priority
+ * @param prio- The priority
+ * @return The number of its tasks dispatched after their deadline since
+ * nOS_start, 0 for a priority without a deadline heap
+ */
+uint32_t nOS_task_deadline_misses (nOS_prio_t prio);
+#endif
+
+#if nOS_OVERFLOW_POLICY
+/**
+ * @brief A function to read the overflows of a priority (see
+ * nOS_TASK_OVERFLOW_POLICIES)
+ * @param prio- The priority
+ * @param policy- The policy the overflows were handled with, nOS_OVERFLOW_*,
+ * nOS_OVERFLOW_REJECT also counts the rejected batches, deadline posts and
+ * the spills of priority 1
+ * @return The number of posts to its full queue handled with policy since
+ * nOS_start, summed over the cores, 0 for an invalid input
+ */
+uint32_t nOS_task_overflows (nOS_prio_t prio, uint8_t policy);
+#endif
+
+#if nOS_BACK_PRESSURE_USED
+/**
+ * @brief The back pressure hook, defined by the application, called when a
+ * post to a full nOS_OVERFLOW_BACK_PRESSURE priority is rejected
+ * @param prio- The priority of the rejected task
+ * @param callback- The callback of the rejected task, the kernel dispatcher
+ * for a coalesced (nOS_task_enqueue_coalesced) or a message task
+ * @param event- The event of the rejected task
+ * @note It is called in the context of the post with the task queues locked,
+ * it shall not post tasks itself, e.g. it masks the producer interrupt or
+ * raises a flag the producer polls.
+ */
+void nOS_task_back_pressure (nOS_prio_t prio, nOS_task_ref_t callback,
+                             uint8_t event);
+#endif
 
 /**
  * @brief A function to dequeue all the priority task queues
+ * With nOS_SMP_CORES every core calls it, it returns once no core has a task
+ * the calling core can run.
  * @return nOS_err_t
  */
 nOS_err_t nOS_schedule (void);
 
+#if nOS_PREEMPTIVE
+/**
+ * @brief The ISR exit hook, runs the tasks of a higher priority than the
+ * preempted task before the ISR returns, then lets the preempted task resume
+ * The port calls it at the end of every ISR that interrupted a context with
+ * interrupts enabled, with interrupts enabled so the nested tasks can be
+ * interrupted in turn (e.g. from a PendSV of the lowest priority on Cortex-M).
+ */
+void nOS_isr_exit (void);
+#endif
+
 
 #endif /* NANORTOS_H_ */
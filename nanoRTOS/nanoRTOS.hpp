@@ -0,0 +1,431 @@
+/**
+ * @file nanoRTOS.hpp
+ * @author Ehud Frank
+ * @date 17 Oct 2026
+ * @brief Header only C++ task queue and scheduler, the number of priorities
+ * and the queue lengths are template parameters.
+ * nOS::Queue<T, N> is a ring of N values of a trivially copyable T, rounded
+ * up to a power of 2, with free running narrow indices like
+ * nOS_CREATE_POW2_QUEUE. The values are copied by assignment, not through
+ * void *, and nothing is cleared with memset.
+ * nOS::Scheduler<nOS::Config<...> > is the FIFO run to completion core of
+ * nanoRTOS.c in one object: the queue offsets and masks are constants and
+ * every post and dispatch inlines into its caller. SMP, EDF, aging,
+ * coalescing, messages, handles and the instrumentation stay in nanoRTOS.c.
+ * nOS_SCHEDULER_C_API serves the C API from a scheduler object, for the C
+ * modules (e.g. nanoTimer.c) of a build that does not link nanoRTOS.c.
+ */
+
+#ifndef NANORTOS_HPP_
+#define NANORTOS_HPP_
+
+extern "C"
+{
+#include "nanoRTOS.h"
+#include "nanoTimer.h"
+}
+#include <stddef.h>
+#include <type_traits>
+
+namespace nOS
+{
+
+namespace detail
+{
+/**
+ * @brief The smallest power of two not below x
+ */
+constexpr uint32_t pow2_ceil (uint32_t x, uint32_t pow2 = 1)
+{
+    return (pow2 >= x) ? pow2 : pow2_ceil (x, pow2 << 1);
+}
+
+/**
+ * @brief The narrowest index type that counts up to twice the slots, the
+ * indices run free and their difference is the count
+ */
+template <uint32_t Slots>
+struct Index
+{
+    typedef typename std::conditional<(Slots <= 128), uint8_t, uint16_t>::type type;
+};
+
+/**
+ * @brief The slot offsets of the priority queues in one array, a prefix sum
+ * of the slots built at compile time
+ */
+template <uint32_t... Values>
+struct Offsets
+{
+    static constexpr uint32_t values[sizeof...(Values)] = { Values... };
+};
+template <uint32_t... Values>
+constexpr uint32_t Offsets<Values...>::values[sizeof...(Values)];
+
+template <class Done, uint32_t Next, uint16_t... Lengths>
+struct Scan;
+template <uint32_t... Done, uint32_t Next>
+struct Scan<Offsets<Done...>, Next>
+{
+    typedef Offsets<Done...> offsets;
+    static constexpr uint32_t total = Next;
+};
+template <uint32_t... Done, uint32_t Next, uint16_t Length, uint16_t... Lengths>
+struct Scan<Offsets<Done...>, Next, Length, Lengths...> :
+        Scan<Offsets<Done..., Next>, Next + pow2_ceil (Length), Lengths...>
+{
+};
+} // namespace detail
+
+/**
+ * @brief A fixed size FIFO queue, not thread safe, lock it as the caller
+ * needs
+ */
+template <typename T, uint32_t N>
+class Queue
+{
+    static_assert ((N >= 1) && (N <= 32768), "nOS::Queue holds 1 to 32768 values");
+    static_assert (std::is_trivially_copyable<T>::value,
+                   "nOS::Queue values are copied by assignment");
+public:
+    static constexpr uint32_t capacity = detail::pow2_ceil (N);
+
+    bool empty (void) const
+    {
+        return in_ == out_;
+    }
+    bool full (void) const
+    {
+        return count () == capacity;
+    }
+    uint32_t count (void) const
+    {
+        return (index_t) (in_ - out_);
+    }
+    /**
+     * @brief Pushes a value at the back
+     * @return false if the queue was full
+     */
+    bool push (const T &value)
+    {
+        if (full ())
+        {
+            return false;
+        }
+        values_[in_++ & MASK] = value;
+        return true;
+    }
+    /**
+     * @brief Pops the value at the front
+     * @return false if the queue was empty
+     */
+    bool pop (T &value)
+    {
+        if (empty ())
+        {
+            return false;
+        }
+        value = values_[out_++ & MASK];
+        return true;
+    }
+    /**
+     * @brief Pops up to n values from the front
+     * @return The number of values popped
+     */
+    uint32_t pop_n (T *values, uint32_t n)
+    {
+        uint32_t popped = 0;
+
+        while ((popped < n) && !empty ())
+        {
+            values[popped++] = values_[out_++ & MASK];
+        }
+        return popped;
+    }
+    /**
+     * @brief The value at the front, NULL if the queue is empty
+     */
+    const T *front (void) const
+    {
+        return empty () ? NULL : &values_[out_ & MASK];
+    }
+    /**
+     * @brief Empties the queue, the values are left as they are
+     */
+    void clear (void)
+    {
+        in_ = 0;
+        out_ = 0;
+    }
+private:
+    typedef typename detail::Index<capacity>::type index_t;
+    static constexpr uint32_t MASK = capacity - 1;
+
+    T values_[capacity];
+    index_t in_ = 0;
+    index_t out_ = 0;
+};
+
+/**
+ * @brief The scheduler configuration, the queue lengths from priority 1 (the
+ * lowest) up like nOS_TASK_QUEUE_LENGTHS, each rounded up to a power of 2:
+ * nOS::Scheduler<nOS::Config<28, 24, 20, 16, 12, 8, 4, 2> > scheduler;
+ */
+template <uint16_t... Lengths>
+struct Config
+{
+    static_assert ((sizeof...(Lengths) >= 1) && (sizeof...(Lengths) <= 256),
+                   "nOS::Config lists 1 to 256 priorities");
+    static constexpr uint32_t prio_count = sizeof...(Lengths);
+    static constexpr uint32_t slots[sizeof...(Lengths)] =
+    { detail::pow2_ceil (Lengths)... };
+    typedef detail::Scan<detail::Offsets<>, 0, Lengths...> scan;
+    static constexpr uint32_t total = scan::total;
+    typedef typename scan::offsets offsets;
+};
+template <uint16_t... Lengths>
+constexpr uint32_t Config<Lengths...>::slots[sizeof...(Lengths)];
+
+/**
+ * @brief A run to completion scheduler with a FIFO queue per priority, the
+ * posts are safe from the ISRs with nOS_INTERRUPTS_LOCK
+ */
+template <class Config>
+class Scheduler
+{
+    static_assert (Config::total <= 32768, "nOS::Scheduler holds up to 32768 tasks");
+    static_assert (Config::prio_count < ((uint32_t) 1 << (8 * sizeof(nOS_prio_t))),
+                   "more priorities than nOS_prio_t holds, see nOS_PRIO_COUNT");
+public:
+    static constexpr nOS_prio_t prio_count = (nOS_prio_t) Config::prio_count;
+
+    /**
+     * @brief Drops all the pending tasks, as nOS_start
+     */
+    void start (void)
+    {
+        nOS_INTERRUPTS_LOCK();
+        for (uint32_t i = 0; i < Config::prio_count; i++)
+        {
+            rings_[i].in_ = 0;
+            rings_[i].out_ = 0;
+        }
+        for (uint32_t i = 0; i < WORDS; i++)
+        {
+            ready_[i] = 0;
+        }
+        nOS_INTERRUPTS_UNLOCK();
+    }
+
+    /**
+     * @brief Posts a task, as nOS_task_enqueue
+     * @return nOS_OK, nOS_TASK_ERR, nOS_PRIORITY_ERR or nOS_TASK_QUEUE_ERR
+     */
+    nOS_err_t enqueue (nOS_prio_t prio, nOS_task_callback_t callback,
+                       uint8_t event)
+    {
+        if (NULL == callback)
+        {
+            return nOS_TASK_ERR;
+        }
+        if ((prio < 1) || (prio > prio_count))
+        {
+            return nOS_PRIORITY_ERR;
+        }
+        return post (prio - 1, callback, event);
+    }
+
+    /**
+     * @brief Posts a task at a priority checked at compile time
+     */
+    template <nOS_prio_t Prio>
+    nOS_err_t enqueue (nOS_task_callback_t callback, uint8_t event)
+    {
+        static_assert ((Prio >= 1) && (Prio <= Config::prio_count),
+                       "no such priority in the nOS::Config");
+        if (NULL == callback)
+        {
+            return nOS_TASK_ERR;
+        }
+        return post (Prio - 1, callback, event);
+    }
+
+    /**
+     * @brief Posts a task per event, all or none, as nOS_task_enqueue_batch
+     */
+    nOS_err_t enqueue_batch (nOS_prio_t prio, nOS_task_callback_t callback,
+                             const uint8_t *events, uint16_t n)
+    {
+        uint32_t i;
+
+        if ((NULL == callback) || (NULL == events))
+        {
+            return nOS_TASK_ERR;
+        }
+        if ((prio < 1) || (prio > prio_count))
+        {
+            return nOS_PRIORITY_ERR;
+        }
+        if (0 == n)
+        {
+            return nOS_OK;
+        }
+        i = prio - 1;
+        nOS_INTERRUPTS_LOCK();
+        Ring &ring = rings_[i];
+        if (Config::slots[i] - (index_t) (ring.in_ - ring.out_) < n)
+        {
+            nOS_INTERRUPTS_UNLOCK();
+            return nOS_TASK_QUEUE_ERR;
+        }
+        for (uint16_t j = 0; j < n; j++)
+        {
+            Task &task = slot (i, ring.in_++);
+            task.callback_ = callback;
+            task.event_ = events[j];
+        }
+        ready_[i >> 5] |= (uint32_t) 1 << (i & 31);
+        nOS_INTERRUPTS_UNLOCK();
+
+        return nOS_OK;
+    }
+
+    /**
+     * @brief Runs the pending tasks, the highest priority first, as
+     * nOS_schedule: from within a task only the priorities above it run
+     */
+    void schedule (void)
+    {
+        nOS_prio_t floor = current_;
+        Task task;
+        int32_t i;
+
+        for (;;)
+        {
+            nOS_INTERRUPTS_LOCK();
+            i = highest ();
+            if (i < (int32_t) floor)
+            {
+                nOS_INTERRUPTS_UNLOCK();
+                break;
+            }
+            Ring &ring = rings_[i];
+            task = slot (i, ring.out_++);
+            if (ring.in_ == ring.out_)
+            {
+                ready_[i >> 5] &= ~((uint32_t) 1 << (i & 31));
+            }
+            nOS_INTERRUPTS_UNLOCK();
+            current_ = (nOS_prio_t) (i + 1);
+            task.callback_ (task.event_);
+        }
+        current_ = floor;
+    }
+
+    /**
+     * @brief The number of tasks pending at a priority, 0 for an invalid one
+     */
+    uint32_t count (nOS_prio_t prio) const
+    {
+        if ((prio < 1) || (prio > prio_count))
+        {
+            return 0;
+        }
+        return (index_t) (rings_[prio - 1].in_ - rings_[prio - 1].out_);
+    }
+private:
+    typedef typename detail::Index<Config::total>::type index_t;
+    static constexpr uint32_t WORDS = (Config::prio_count + 31) / 32;
+
+    struct Task
+    {
+        nOS_task_callback_t callback_;
+        uint8_t event_;
+    };
+    struct Ring
+    {
+        index_t in_;
+        index_t out_;
+    };
+
+    Task &slot (uint32_t i, index_t index)
+    {
+        return tasks_[Config::offsets::values[i] + (index & (Config::slots[i] - 1))];
+    }
+    nOS_err_t post (uint32_t i, nOS_task_callback_t callback, uint8_t event)
+    {
+        nOS_INTERRUPTS_LOCK();
+        Ring &ring = rings_[i];
+        if ((index_t) (ring.in_ - ring.out_) >= Config::slots[i])
+        {
+            nOS_INTERRUPTS_UNLOCK();
+            return nOS_TASK_QUEUE_ERR;
+        }
+        Task &task = slot (i, ring.in_++);
+        task.callback_ = callback;
+        task.event_ = event;
+        ready_[i >> 5] |= (uint32_t) 1 << (i & 31);
+        nOS_INTERRUPTS_UNLOCK();
+
+        return nOS_OK;
+    }
+    /**
+     * @brief The index of the highest ready priority, -1 if none is ready
+     */
+    int32_t highest (void) const
+    {
+        for (int32_t w = WORDS - 1; w >= 0; w--)
+        {
+            if (ready_[w])
+            {
+                return w * 32 + 31 - nOS_CLZ32(ready_[w]);
+            }
+        }
+        return -1;
+    }
+
+    Task tasks_[Config::total];
+    Ring rings_[Config::prio_count] = { };
+    uint32_t ready_[WORDS] = { };
+    nOS_prio_t current_ = 0; // The priority of the running task, 0 outside
+};
+
+} // namespace nOS
+
+/**
+ * @brief Defines the C API on a scheduler object, in one C++ file of a build
+ * without nanoRTOS.c:
+ * static nOS::Scheduler<nOS::Config<16, 8, 4> > app_scheduler;
+ * nOS_SCHEDULER_C_API(app_scheduler)
+ * Only nOS_start, nOS_task_enqueue, nOS_task_enqueue_batch and nOS_schedule,
+ * without nOS_TASK_TABLE.
+ */
+#define nOS_SCHEDULER_C_API(scheduler)\
+    static_assert (std::is_same<nOS_task_ref_t, nOS_task_callback_t>::value,\
+                   "nOS_SCHEDULER_C_API posts callbacks, not nOS_TASK_TABLE IDs");\
+    extern "C" nOS_err_t nOS_start (void)\
+    {\
+        (scheduler).start ();\
+        nOS_timer_init ();\
+        return nOS_OK;\
+    }\
+    extern "C" nOS_err_t nOS_task_enqueue (nOS_prio_t prio,\
+                                           nOS_task_ref_t callback,\
+                                           uint8_t event)\
+    {\
+        return (scheduler).enqueue (prio, callback, event);\
+    }\
+    extern "C" nOS_err_t nOS_task_enqueue_batch (nOS_prio_t prio,\
+                                                 nOS_task_ref_t callback,\
+                                                 const uint8_t *events,\
+                                                 uint16_t n)\
+    {\
+        return (scheduler).enqueue_batch (prio, callback, events, n);\
+    }\
+    extern "C" nOS_err_t nOS_schedule (void)\
+    {\
+        (scheduler).schedule ();\
+        return nOS_OK;\
+    }
+
+#endif /* NANORTOS_HPP_ */
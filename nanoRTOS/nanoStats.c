@@ -0,0 +1,99 @@
+/**
+ * @file nanoStats.c
+ * @author Ehud Frank
+ * Description Optional scheduler instrumentation, see nanoStats.h.
+ * @date 17 Oct 2026
+ */
+
+#include "nanoStats.h"
+#include "nanoAtomic.h"
+#include "string.h"
+
+#if nOS_STATS
+
+static nOS_prio_stats_t nOS_stats_[nOS_PRIO_COUNT];
+
+/**
+ * @brief A function to convert a number of cycles to its log2 histogram bin
+ */
+static uint8_t stats_bin (uint32_t cycles);
+
+nOS_err_t nOS_stats_get (nOS_prio_t prio, nOS_prio_stats_t *stats)
+{
+    if ((prio < 1) || (prio > nOS_PRIO_COUNT))
+    {
+        return nOS_PRIORITY_ERR;
+    }
+    nOS_INTERRUPTS_LOCK();
+    memcpy (stats, &nOS_stats_[prio - 1], sizeof(*stats));
+    nOS_INTERRUPTS_UNLOCK();
+
+    return nOS_OK;
+}
+
+void nOS_stats_reset (void)
+{
+    uint16_t i;
+    uint16_t capacity;
+
+    nOS_INTERRUPTS_LOCK();
+    for (i = 0; i < nOS_PRIO_COUNT; i++)
+    {
+        capacity = nOS_stats_[i].capacity_;
+        memset (&nOS_stats_[i], 0, sizeof(nOS_stats_[i]));
+        nOS_stats_[i].capacity_ = capacity;
+    }
+    nOS_INTERRUPTS_UNLOCK();
+}
+
+void nOS_stats_init (nOS_prio_t prio, uint16_t capacity)
+{
+    memset (&nOS_stats_[prio - 1], 0, sizeof(nOS_stats_[prio - 1]));
+    nOS_stats_[prio - 1].capacity_ = capacity;
+}
+
+void nOS_stats_enqueued (nOS_prio_t prio, uint16_t count)
+{
+    nOS_ATOMIC_RAISE(&nOS_stats_[prio - 1].high_water_, count);
+}
+
+void nOS_stats_overflowed (nOS_prio_t prio)
+{
+    nOS_ATOMIC_FETCH_ADD(&nOS_stats_[prio - 1].overflows_, 1);
+}
+
+void nOS_stats_dispatched (nOS_prio_t prio, uint32_t wait, uint32_t run)
+{
+    // Only the scheduler writes these fields
+    nOS_prio_stats_t *stats = &nOS_stats_[prio - 1];
+
+    stats->wait_hist_[stats_bin (wait)]++;
+    stats->run_hist_[stats_bin (run)]++;
+    if (wait > stats->wait_max_)
+    {
+        stats->wait_max_ = wait;
+    }
+    if (run > stats->run_max_)
+    {
+        stats->run_max_ = run;
+    }
+    stats->dispatched_++;
+}
+
+/* ------------------------------------------------------------- */
+/* Private function */
+/* ------------------------------------------------------------- */
+static uint8_t stats_bin (uint32_t cycles)
+{
+    uint8_t bin;
+
+    if (0 == cycles)
+    {
+        return 0;
+    }
+    bin = 32 - nOS_CLZ32(cycles);
+
+    return (bin < nOS_STATS_HIST_BINS) ? bin : nOS_STATS_HIST_BINS - 1;
+}
+
+#endif /* nOS_STATS */
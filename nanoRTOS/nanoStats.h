@@ -0,0 +1,72 @@
+/**
+ * @file nanoStats.h
+ * @author Ehud Frank
+ * @date 17 Oct 2026
+ * @brief Optional scheduler instrumentation, enabled by nOS_STATS.
+ * Per priority histograms of the enqueue to dispatch wait time and of the
+ * callback run time, queue high water marks and overflow counts.
+ * Times are measured with nOS_GET_CYCLES (see nanoConfig.h).
+ * When nOS_STATS is 0 nothing of this module is compiled in the kernel.
+ */
+
+#ifndef NANOSTATS_H_
+#define NANOSTATS_H_
+
+#include "nanoRTOS.h"
+
+#if nOS_STATS
+/**
+ * @brief The statistics of one priority
+ * Histogram bin 0 counts the zero cycle samples, bin i counts the samples in
+ * [2^(i-1), 2^i) cycles and the last bin also counts all the longer samples.
+ */
+typedef struct
+{
+    uint32_t wait_hist_[nOS_STATS_HIST_BINS]; // Enqueue to dispatch cycles
+    uint32_t run_hist_[nOS_STATS_HIST_BINS];  // Callback run cycles
+    uint32_t wait_max_;   // The longest wait in cycles
+    uint32_t run_max_;    // The longest callback run in cycles
+    uint32_t dispatched_; // The number of callbacks called
+    uint32_t overflows_;  // The number of tasks rejected by a full queue
+    uint16_t high_water_; // The highest number of tasks queued at once
+    uint16_t capacity_;   // The length of the task queue
+} nOS_prio_stats_t;
+
+/**
+ * @brief A function to read the statistics of a priority
+ * @param prio- The priority
+ * @param stats- Output, a copy of the statistics
+ * @return nOS_OK or nOS_PRIORITY_ERR
+ */
+nOS_err_t nOS_stats_get (nOS_prio_t prio, nOS_prio_stats_t *stats);
+
+/**
+ * @brief A function to clear the statistics of all the priorities
+ */
+void nOS_stats_reset (void);
+
+/* ------------------------------------------------------------- */
+/* Kernel hooks */
+/* ------------------------------------------------------------- */
+/**
+ * @brief Called by nOS_start for each priority
+ */
+void nOS_stats_init (nOS_prio_t prio, uint16_t capacity);
+/**
+ * @brief Called by nOS_task_enqueue after a task was queued
+ * @param count- The number of tasks in the queue including the new one
+ */
+void nOS_stats_enqueued (nOS_prio_t prio, uint16_t count);
+/**
+ * @brief Called by nOS_task_enqueue when the queue was full
+ */
+void nOS_stats_overflowed (nOS_prio_t prio);
+/**
+ * @brief Called by nOS_schedule after a callback returned
+ * @param wait- The cycles from the enqueue to the dispatch
+ * @param run- The cycles spent in the callback
+ */
+void nOS_stats_dispatched (nOS_prio_t prio, uint32_t wait, uint32_t run);
+#endif
+
+#endif /* NANOSTATS_H_ */
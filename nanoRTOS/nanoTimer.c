@@ -0,0 +1,328 @@
+/**
+ * @file nanoTimer.c
+ * @author Ehud Frank
+ * Description Software timers for the nanoRTOS, a hashed timer wheel.
+ * A timer is hashed to the wheel slot of its expiry tick, every tick only the
+ * timers of one slot are visited. Timers hashed to the slot that expire a
+ * later round stay in place.
+ * @date 17 Oct 2026
+ */
+
+#include "nanoTimer.h"
+#include "string.h"
+
+#define TIMER_WHEEL_MASK    (nOS_TIMER_WHEEL_SIZE - 1)
+#define TIMER_INDEX_MASK    0xFFFF
+
+/**
+ * The states of a timer control block
+ */
+typedef enum
+{
+    TIMER_FREE,     // In the free list
+    TIMER_ARMED,    // In a wheel slot
+    TIMER_FIRING,   // Expired, its task is being posted by nOS_timer_tick
+    TIMER_CANCELLED // Cancelled while firing, freed by nOS_timer_tick
+} timer_state_t;
+
+/**
+ * This structure joins the data needed for a timer
+ */
+typedef struct timer_cb
+{
+    struct timer_cb *next_; // The next timer in the wheel slot or free list
+    struct timer_cb *prev_; // The previous timer in the wheel slot
+    nOS_tick_t expiry_;     // The tick of the next expiry
+    nOS_tick_t period_;     // The reload value, 0 for a one shot timer
+    nOS_task_ref_t callback_;
+    uint16_t generation_;   // Incremented each time the timer is freed
+    nOS_prio_t prio_;
+    uint8_t event_;
+    uint8_t state_;
+} timer_cb_t;
+
+/**
+ * A structure to hold all the private variables of the module
+ */
+typedef struct
+{
+    nOS_tick_t now_;   // Ticks since nOS_timer_init
+    uint32_t post_failures_; // The expiries that found their task queue full
+    timer_cb_t *free_; // The list of stopped timers
+    timer_cb_t *wheel_[nOS_TIMER_WHEEL_SIZE]; // The timers hashed by expiry tick
+} timer_vars_t;
+
+static timer_cb_t timers_[nOS_TIMER_COUNT];
+static timer_vars_t timer_vars;
+
+/**
+ * @brief A function to link a timer in the wheel slot of its expiry tick
+ */
+static void wheel_insert (timer_cb_t *timer);
+/**
+ * @brief A function to unlink a timer from its wheel slot
+ */
+static void wheel_remove (timer_cb_t *timer);
+/**
+ * @brief A function to return a timer to the free list
+ */
+static void timer_free (timer_cb_t *timer);
+
+void nOS_timer_init (void)
+{
+    uint16_t i;
+
+    nOS_INTERRUPTS_LOCK();
+    memset (&timer_vars, 0, sizeof(timer_vars));
+    memset (timers_, 0, sizeof(timers_));
+    // Chain all the timers in the free list
+    for (i = 0; i < nOS_TIMER_COUNT; i++)
+    {
+        timers_[i].generation_ = 1;
+        timers_[i].next_ = timer_vars.free_;
+        timer_vars.free_ = &timers_[i];
+    }
+    nOS_INTERRUPTS_UNLOCK();
+}
+
+nOS_timer_t nOS_timer_start (nOS_prio_t prio, nOS_task_ref_t callback,
+                             uint8_t event, nOS_tick_t delay,
+                             nOS_tick_t period)
+{
+    timer_cb_t *timer;
+    nOS_timer_t handle = nOS_TIMER_INVALID;
+
+    // Check inputs to function
+    if (!nOS_TASK_REF_IS_VALID(callback) || (prio < 1)
+            || (prio > nOS_PRIO_COUNT))
+    {
+        return nOS_TIMER_INVALID;
+    }
+    if (0 == delay)
+    {
+        delay = 1;
+    }
+
+    nOS_INTERRUPTS_LOCK();
+    timer = timer_vars.free_;
+    if (NULL != timer)
+    {
+        timer_vars.free_ = timer->next_;
+        timer->expiry_ = timer_vars.now_ + delay;
+        timer->period_ = period;
+        timer->callback_ = callback;
+        timer->prio_ = prio;
+        timer->event_ = event;
+        timer->state_ = TIMER_ARMED;
+        wheel_insert (timer);
+        handle = ((nOS_timer_t) timer->generation_ << 16)
+                | (nOS_timer_t) (timer - timers_);
+    }
+    nOS_INTERRUPTS_UNLOCK();
+
+    return handle;
+}
+
+nOS_err_t nOS_timer_cancel (nOS_timer_t timer)
+{
+    uint32_t index = timer & TIMER_INDEX_MASK;
+    timer_cb_t *timer_cb;
+    nOS_err_t err = nOS_OK;
+
+    if (index >= nOS_TIMER_COUNT)
+    {
+        return nOS_TIMER_ERR;
+    }
+    timer_cb = &timers_[index];
+
+    nOS_INTERRUPTS_LOCK();
+    if (timer_cb->generation_ != (uint16_t) (timer >> 16))
+    {
+        // The handle belongs to an expired or cancelled timer
+        err = nOS_TIMER_ERR;
+    }
+    else if (TIMER_ARMED == timer_cb->state_)
+    {
+        wheel_remove (timer_cb);
+        timer_free (timer_cb);
+    }
+    else if (TIMER_FIRING == timer_cb->state_)
+    {
+        // nOS_timer_tick is posting it, let it free the timer afterwards
+        timer_cb->state_ = TIMER_CANCELLED;
+    }
+    else
+    {
+        err = nOS_TIMER_ERR;
+    }
+    nOS_INTERRUPTS_UNLOCK();
+
+    return err;
+}
+
+void nOS_timer_tick (void)
+{
+    timer_cb_t *timer;
+    timer_cb_t *next;
+    timer_cb_t *expired = NULL;
+    nOS_tick_t now;
+    nOS_err_t err;
+
+    // Detach the expired timers of the current slot
+    nOS_INTERRUPTS_LOCK();
+    now = ++timer_vars.now_;
+    for (timer = timer_vars.wheel_[now & TIMER_WHEEL_MASK]; NULL != timer;
+            timer = next)
+    {
+        next = timer->next_;
+        if (timer->expiry_ == now)
+        {
+            wheel_remove (timer);
+            timer->state_ = TIMER_FIRING;
+            timer->next_ = expired;
+            expired = timer;
+        }
+    }
+    nOS_INTERRUPTS_UNLOCK();
+
+    // Post the tasks with interrupts enabled, then re-arm or free the timers
+    while (NULL != expired)
+    {
+        timer = expired;
+        expired = timer->next_;
+        err = nOS_task_enqueue (timer->prio_, timer->callback_, timer->event_);
+
+        nOS_INTERRUPTS_LOCK();
+        if (nOS_OK != err)
+        {
+            timer_vars.post_failures_++;
+        }
+        if ((TIMER_FIRING == timer->state_) && (0 != timer->period_))
+        {
+            // Another tick (an ISR, nOS_timer_advance) may have run since the
+            // expiry, the missed periods are skipped so the expiry is ahead
+            timer->expiry_ += timer->period_;
+            now = timer_vars.now_;
+            if ((int32_t) (timer->expiry_ - now) <= 0)
+            {
+                timer->expiry_ += ((now - timer->expiry_) / timer->period_ + 1)
+                        * timer->period_;
+            }
+            timer->state_ = TIMER_ARMED;
+            wheel_insert (timer);
+        }
+        else if ((TIMER_FIRING == timer->state_) && (nOS_OK != err))
+        {
+            // A one shot timer is not lost to a full queue, it posts again on
+            // the next tick
+            timer->expiry_ = timer_vars.now_ + 1;
+            timer->state_ = TIMER_ARMED;
+            wheel_insert (timer);
+        }
+        else
+        {
+            timer_free (timer);
+        }
+        nOS_INTERRUPTS_UNLOCK();
+    }
+}
+
+void nOS_timer_advance (nOS_tick_t ticks)
+{
+    nOS_tick_t skip;
+
+    if (0 == ticks)
+    {
+        return;
+    }
+    // No timer expires before the next expiry, jump right before it
+    nOS_INTERRUPTS_LOCK();
+    skip = nOS_timer_next_expiry ();
+    if (skip > ticks)
+    {
+        skip = ticks;
+    }
+    timer_vars.now_ += skip - 1;
+    ticks -= skip - 1;
+    nOS_INTERRUPTS_UNLOCK();
+
+    while (ticks--)
+    {
+        nOS_timer_tick ();
+    }
+}
+
+nOS_tick_t nOS_timer_next_expiry (void)
+{
+    nOS_tick_t next = nOS_TICK_FOREVER;
+    timer_cb_t *timer;
+    uint16_t slot;
+
+    for (slot = 0; slot < nOS_TIMER_WHEEL_SIZE; slot++)
+    {
+        for (timer = timer_vars.wheel_[slot]; NULL != timer;
+                timer = timer->next_)
+        {
+            if ((nOS_tick_t) (timer->expiry_ - timer_vars.now_) < next)
+            {
+                next = timer->expiry_ - timer_vars.now_;
+            }
+        }
+    }
+
+    return next;
+}
+
+nOS_tick_t nOS_timer_now (void)
+{
+    return timer_vars.now_;
+}
+
+uint32_t nOS_timer_post_failures (void)
+{
+    return timer_vars.post_failures_;
+}
+
+/* ------------------------------------------------------------- */
+/* Private function */
+/* ------------------------------------------------------------- */
+static void wheel_insert (timer_cb_t *timer)
+{
+    timer_cb_t **slot = &timer_vars.wheel_[timer->expiry_ & TIMER_WHEEL_MASK];
+
+    timer->prev_ = NULL;
+    timer->next_ = *slot;
+    if (NULL != *slot)
+    {
+        (*slot)->prev_ = timer;
+    }
+    *slot = timer;
+}
+
+static void wheel_remove (timer_cb_t *timer)
+{
+    if (NULL != timer->prev_)
+    {
+        timer->prev_->next_ = timer->next_;
+    }
+    else
+    {
+        timer_vars.wheel_[timer->expiry_ & TIMER_WHEEL_MASK] = timer->next_;
+    }
+    if (NULL != timer->next_)
+    {
+        timer->next_->prev_ = timer->prev_;
+    }
+}
+
+static void timer_free (timer_cb_t *timer)
+{
+    // A new generation invalidates the handles of this run
+    if (0 == ++timer->generation_)
+    {
+        timer->generation_ = 1;
+    }
+    timer->state_ = TIMER_FREE;
+    timer->next_ = timer_vars.free_;
+    timer_vars.free_ = timer;
+}
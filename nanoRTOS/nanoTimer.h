@@ -0,0 +1,98 @@
+/**
+ * @file nanoTimer.h
+ * @author Ehud Frank
+ * @date 17 Oct 2026
+ * @brief Software timers for the nanoRTOS.
+ * A hashed timer wheel driven by a single tick hook, expired timers post their
+ * task straight into the priority task queues.
+ * Start, cancel and expiry are O(1), a tick only walks the timers hashed to
+ * the current wheel slot.
+ */
+
+#ifndef NANOTIMER_H_
+#define NANOTIMER_H_
+
+#include "nanoRTOS.h"
+
+/**
+ * @brief A tick that is never reached, no timer is running
+ */
+#define nOS_TICK_FOREVER    ((nOS_tick_t) 0xFFFFFFFF)
+
+/**
+ * @brief A timer handle, it holds the timer index and a generation counter so
+ * a handle of an expired or cancelled timer can no longer cancel its successor
+ */
+typedef uint32_t nOS_timer_t;
+
+/**
+ * @brief An invalid timer handle, returned when a timer could not be started
+ */
+#define nOS_TIMER_INVALID   ((nOS_timer_t) 0)
+
+/**
+ * @brief A function to initialise the timer wheel, all the timers are stopped
+ * @note This function is called by nOS_start.
+ */
+void nOS_timer_init (void);
+
+/**
+ * @brief A function to start a one shot or a periodic timer
+ * @param prio- The priority of the task to post on expiry
+ * @param callback- The task callback function, or its nOS_TASK_ID
+ * @param event- The event argument to pass the task per callback
+ * @param delay- Ticks until the first expiry, 0 expires on the next tick
+ * @param period- Ticks between the following expiries, 0 for a one shot timer
+ * @return A timer handle or nOS_TIMER_INVALID if the arguments are wrong or
+ * all the nOS_TIMER_COUNT timers are running
+ */
+nOS_timer_t nOS_timer_start (nOS_prio_t prio, nOS_task_ref_t callback,
+                             uint8_t event, nOS_tick_t delay,
+                             nOS_tick_t period);
+
+/**
+ * @brief A function to cancel a running timer
+ * @param timer- The handle returned by nOS_timer_start
+ * @return nOS_OK or nOS_TIMER_ERR if the timer already expired or was cancelled
+ */
+nOS_err_t nOS_timer_cancel (nOS_timer_t timer);
+
+/**
+ * @brief The tick hook, shall be called periodically (e.g. from a SysTick ISR)
+ * Expired timers post their task, the tasks run on the next nOS_schedule.
+ * When the task queue is full a one shot timer posts again on the next tick,
+ * a periodic timer on its next period, see nOS_timer_post_failures.
+ */
+void nOS_timer_tick (void);
+
+/**
+ * @brief A function to advance the time by several ticks at once, e.g. after
+ * the tick was stopped during a tickless sleep
+ * The ticks up to the next expiry are skipped in one step, the rest are
+ * processed as by nOS_timer_tick.
+ * @param ticks- The number of ticks that elapsed
+ */
+void nOS_timer_advance (nOS_tick_t ticks);
+
+/**
+ * @brief A function to compute the number of ticks until the next expiry
+ * @return The ticks until the next timer expires or nOS_TICK_FOREVER
+ * @note Shall be called with interrupts locked, it walks all the wheel slots
+ * and running timers so it is meant for the idle path only.
+ */
+nOS_tick_t nOS_timer_next_expiry (void);
+
+/**
+ * @brief A function to read the number of ticks since nOS_timer_init
+ * @return The current tick
+ */
+nOS_tick_t nOS_timer_now (void);
+
+/**
+ * @brief A function to read the number of expiries that could not post their
+ * task, the task queue was full
+ * @return The failed posts since nOS_timer_init
+ */
+uint32_t nOS_timer_post_failures (void);
+
+#endif /* NANOTIMER_H_ */
@@ -0,0 +1,83 @@
+/**
+ * @file nanoTrace.c
+ * @author Ehud Frank
+ * Description Optional binary trace of the scheduler, see nanoTrace.h.
+ * @date 17 Oct 2026
+ */
+
+#include "nanoTrace.h"
+#include "nanoPort.h"
+#include "nanoAtomic.h"
+#include "string.h"
+
+#if nOS_TRACE
+
+#define TRACE_MASK  (nOS_TRACE_RECORDS - 1)
+
+static nOS_trace_record_t trace_ring_[nOS_TRACE_RECORDS];
+// The number of records claimed since the reset, the ring holds the newest
+static uint32_t trace_head_;
+
+uint32_t nOS_trace_dump (void *dump, uint32_t size)
+{
+    nOS_trace_header_t header;
+    nOS_trace_record_t *records;
+    uint32_t capacity;
+    uint32_t head;
+    uint32_t count;
+    uint32_t i;
+
+    if (size < sizeof(header))
+    {
+        return 0;
+    }
+    capacity = (size - (uint32_t) sizeof(header)) / sizeof(nOS_trace_record_t);
+    records = (nOS_trace_record_t *) ((uint8_t *) dump + sizeof(header));
+
+    nOS_INTERRUPTS_LOCK();
+    head = nOS_ATOMIC_LOAD(&trace_head_);
+    count = (head < nOS_TRACE_RECORDS) ? head : nOS_TRACE_RECORDS;
+    if (count > capacity)
+    {
+        count = capacity;
+    }
+    // The oldest record kept first
+    for (i = 0; i < count; i++)
+    {
+        records[i] = trace_ring_[(head - count + i) & TRACE_MASK];
+    }
+    nOS_INTERRUPTS_UNLOCK();
+
+    header.magic_ = nOS_TRACE_MAGIC;
+    header.version_ = nOS_TRACE_VERSION;
+    header.record_size_ = (uint8_t) sizeof(nOS_trace_record_t);
+    header.prio_count_ = (uint16_t) nOS_PRIO_COUNT;
+    header.cycles_per_us_ = nOS_TRACE_CYCLES_PER_US;
+    header.count_ = count;
+    header.lost_ = head - count;
+    memcpy (dump, &header, sizeof(header));
+
+    return (uint32_t) (sizeof(header) + count * sizeof(nOS_trace_record_t));
+}
+
+void nOS_trace_reset (void)
+{
+    nOS_INTERRUPTS_LOCK();
+    memset (trace_ring_, 0, sizeof(trace_ring_));
+    nOS_ATOMIC_STORE(&trace_head_, 0);
+    nOS_INTERRUPTS_UNLOCK();
+}
+
+void nOS_trace_record (nOS_trace_type_t type, nOS_prio_t prio, uint8_t arg)
+{
+    // Claim a slot first, an ISR recording meanwhile takes the next one
+    nOS_trace_record_t *record =
+            &trace_ring_[nOS_ATOMIC_FETCH_ADD(&trace_head_, 1) & TRACE_MASK];
+
+    record->cycles_ = nOS_GET_CYCLES();
+    record->prio_ = (uint16_t) prio;
+    record->type_ = (uint8_t) (nOS_IN_ISR() ? (type | nOS_TRACE_ISR) : type);
+    record->arg_ = arg;
+}
+
+#endif /* nOS_TRACE */
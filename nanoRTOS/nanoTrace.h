@@ -0,0 +1,102 @@
+/**
+ * @file nanoTrace.h
+ * @author Ehud Frank
+ * @date 17 Oct 2026
+ * @brief Optional binary trace of the scheduler (nOS_TRACE in nanoConfig.h).
+ * The kernel records its enqueues, dispatches, overflows and idle entries in a
+ * ring of 8 byte records stamped with nOS_GET_CYCLES. nOS_trace_dump copies
+ * the ring out, e.g. to send it over a UART, and the host tool in
+ * nanoRTOS_trace decodes the dump into a Chrome/Perfetto trace, nanoRTOS_replay
+ * replays it. The dump layout is declared without nOS_TRACE too, for them.
+ */
+
+#ifndef NANOTRACE_H_
+#define NANOTRACE_H_
+
+#include "nanoRTOS.h"
+
+/**
+ * @brief The trace events
+ */
+typedef enum
+{
+    nOS_TRACE_ENQUEUE,   //!< A task was queued, arg is its event
+    nOS_TRACE_ENQUEUE_N, //!< A batch was queued, arg is its size (up to 255)
+    nOS_TRACE_OVERFLOW,  //!< A post found its queue full, arg is the event, an
+                         //!< enqueue follows when its overflow policy queued it
+    nOS_TRACE_START,     //!< A callback is called, arg is the event
+    nOS_TRACE_END,       //!< A callback returned, arg is the event
+    nOS_TRACE_IDLE       //!< nOS_schedule returned with no task pending
+} nOS_trace_type_t;
+
+/**
+ * @brief Flags the type of the records made in an ISR (see nOS_IN_ISR)
+ */
+#define nOS_TRACE_ISR       0x80
+
+/**
+ * @brief A trace record
+ */
+typedef struct
+{
+    uint32_t cycles_; // nOS_GET_CYCLES() at the event
+    uint16_t prio_;   // The priority of the task, 0 for nOS_TRACE_IDLE
+    uint8_t type_;    // nOS_trace_type_t, with nOS_TRACE_ISR in an ISR
+    uint8_t arg_;     // See nOS_trace_type_t
+} nOS_trace_record_t;
+
+#define nOS_TRACE_MAGIC     0x54534F6Eu // "nOST" in little endian
+#define nOS_TRACE_VERSION   2   // 2 added nOS_TRACE_ISR
+
+/**
+ * @brief The header of a dump, the records follow it oldest first. A dump is
+ * in the byte order of the target.
+ */
+typedef struct
+{
+    uint32_t magic_;         // nOS_TRACE_MAGIC
+    uint8_t version_;        // nOS_TRACE_VERSION
+    uint8_t record_size_;    // sizeof(nOS_trace_record_t)
+    uint16_t prio_count_;    // nOS_PRIO_COUNT
+    uint32_t cycles_per_us_; // nOS_TRACE_CYCLES_PER_US
+    uint32_t count_;         // The number of records in the dump
+    uint32_t lost_;          // The older records that were overwritten
+} nOS_trace_header_t;
+
+/**
+ * @brief The size of a dump of the whole ring
+ */
+#define nOS_TRACE_DUMP_SIZE\
+    (sizeof(nOS_trace_header_t) + nOS_TRACE_RECORDS * sizeof(nOS_trace_record_t))
+
+#if nOS_TRACE
+/**
+ * @brief A function to copy the trace into a dump
+ * @param dump- Output, the header and the records
+ * @param size- The size of dump in bytes, nOS_TRACE_DUMP_SIZE for the whole
+ * ring, else only the newest records that fit are copied
+ * @return The number of bytes written, 0 if size cannot hold the header
+ * @note The interrupts are locked for the copy.
+ */
+uint32_t nOS_trace_dump (void *dump, uint32_t size);
+
+/**
+ * @brief A function to clear the trace
+ * @note This function is called by nOS_start.
+ */
+void nOS_trace_reset (void);
+
+/* ------------------------------------------------------------- */
+/* Kernel hooks */
+/* ------------------------------------------------------------- */
+/**
+ * @brief Records an event, lock free, from any context
+ */
+void nOS_trace_record (nOS_trace_type_t type, nOS_prio_t prio, uint8_t arg);
+
+#define nOS_TRACE_RECORD(type, prio, arg)   nOS_trace_record ((type), (prio), (arg))
+#else
+#define nOS_TRACE_RECORD(type, prio, arg)
+#endif
+
+#endif /* NANOTRACE_H_ */
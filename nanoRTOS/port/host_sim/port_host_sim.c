@@ -0,0 +1,153 @@
+/**
+ * @file port_host_sim.c
+ * @author Ehud Frank
+ * Description A host port that simulates the MCU sleep and counts the wake ups.
+ * @date 17 Oct 2026
+ */
+
+#if defined(nOS_PORT_HOST_SIM)
+
+#include "nanoPort.h"
+#include "string.h"
+
+/**
+ * A structure to hold all the private variables of the simulation
+ */
+typedef struct
+{
+    int lock_depth_;            // The interrupt lock nesting
+    int isr_depth_;             // The ISR nesting
+    int sleep_enabled_;         // 0 returns from the sleep hook at once
+    uint32_t cycles_;           // The simulated cycle counter
+    uint32_t wakeups_;          // The number of sleeps
+    uint32_t slept_ticks_;      // The ticks spent sleeping
+    uint32_t unlocked_sleeps_;  // Sleeps entered with interrupts enabled
+    uint32_t irq_after_;        // Ticks of sleep until the pending interrupt
+    port_sim_isr_t irq_isr_;    // The pending interrupt, NULL if none
+} port_sim_vars_t;
+
+static port_sim_vars_t port_sim_vars;
+
+void port_sim_lock (void)
+{
+    port_sim_vars.lock_depth_++;
+}
+
+void port_sim_unlock (void)
+{
+    port_sim_vars.lock_depth_--;
+}
+
+int port_sim_in_isr (void)
+{
+    return port_sim_vars.isr_depth_;
+}
+
+void port_sim_reset (void)
+{
+    memset (&port_sim_vars, 0, sizeof(port_sim_vars));
+}
+
+void port_sim_enable_sleep (int enable)
+{
+    port_sim_vars.sleep_enabled_ = enable;
+}
+
+void port_sim_raise_irq (uint32_t after_ticks, port_sim_isr_t isr)
+{
+    port_sim_vars.irq_after_ = after_ticks;
+    port_sim_vars.irq_isr_ = isr;
+}
+
+void port_sim_isr (port_sim_isr_t isr)
+{
+    port_sim_vars.isr_depth_++;
+    isr ();
+    port_sim_vars.isr_depth_--;
+#if nOS_PREEMPTIVE
+    if (0 == port_sim_vars.lock_depth_)
+    {
+        nOS_isr_exit ();
+    }
+#endif
+}
+
+void port_sim_advance_cycles (uint32_t cycles)
+{
+    port_sim_vars.cycles_ += cycles;
+}
+
+uint32_t port_sim_wakeups (void)
+{
+    return port_sim_vars.wakeups_;
+}
+
+uint32_t port_sim_slept_ticks (void)
+{
+    return port_sim_vars.slept_ticks_;
+}
+
+uint32_t port_sim_unlocked_sleeps (void)
+{
+    return port_sim_vars.unlocked_sleeps_;
+}
+
+#if nOS_STATS || nOS_TRACE || nOS_BUDGET
+uint32_t nOS_port_cycles (void)
+{
+    return port_sim_vars.cycles_;
+}
+#endif
+
+#if nOS_TICKLESS_IDLE
+nOS_tick_t nOS_port_sleep_until (nOS_tick_t wake_tick)
+{
+    nOS_tick_t ticks = 0;
+    port_sim_isr_t isr = port_sim_vars.irq_isr_;
+
+    if (port_sim_vars.lock_depth_ <= 0)
+    {
+        port_sim_vars.unlocked_sleeps_++;
+    }
+    if (!port_sim_vars.sleep_enabled_)
+    {
+        return 0;
+    }
+    if (nOS_TICK_FOREVER != wake_tick)
+    {
+        ticks = wake_tick - nOS_timer_now ();
+    }
+    // Nothing would ever wake the MCU, do not simulate an endless sleep
+    if ((NULL == isr) && (nOS_TICK_FOREVER == wake_tick))
+    {
+        return 0;
+    }
+    // An external interrupt wakes the MCU before the wake up timer
+    if ((NULL != isr)
+            && ((nOS_TICK_FOREVER == wake_tick) || (port_sim_vars.irq_after_ < ticks)))
+    {
+        ticks = port_sim_vars.irq_after_;
+        port_sim_vars.irq_isr_ = NULL;
+    }
+    else
+    {
+        if (NULL != isr)
+        {
+            port_sim_vars.irq_after_ -= ticks;
+        }
+        isr = NULL;
+    }
+    port_sim_vars.wakeups_++;
+    port_sim_vars.slept_ticks_ += ticks;
+    if (NULL != isr)
+    {
+        port_sim_vars.isr_depth_++;
+        isr ();
+        port_sim_vars.isr_depth_--;
+    }
+
+    return ticks;
+}
+#endif
+
+#endif /* nOS_PORT_HOST_SIM */
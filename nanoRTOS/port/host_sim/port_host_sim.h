@@ -0,0 +1,87 @@
+/**
+ * @file port_host_sim.h
+ * @author Ehud Frank
+ * @date 17 Oct 2026
+ * @brief A host port that simulates the MCU, for the tickless idle tests.
+ * The time only moves when the kernel sleeps (or when the test ticks), every
+ * sleep is counted as one wake up. Enabled by defining nOS_PORT_HOST_SIM.
+ */
+
+#ifndef PORT_HOST_SIM_H_
+#define PORT_HOST_SIM_H_
+
+#include "stdint.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The interrupt lock only counts the nesting, so the simulation can
+ * verify the kernel sleeps with interrupts locked
+ */
+#define nOS_INTERRUPTS_LOCK()   port_sim_lock ()
+#define nOS_INTERRUPTS_UNLOCK() port_sim_unlock ()
+/**
+ * @brief Non zero while a simulated ISR runs
+ */
+#define nOS_IN_ISR()            port_sim_in_isr ()
+
+/**
+ * @brief A simulated interrupt service routine
+ */
+typedef void (*port_sim_isr_t) (void);
+
+void port_sim_lock (void);
+void port_sim_unlock (void);
+int port_sim_in_isr (void);
+
+/**
+ * @brief A function to clear the simulation statistics and pending interrupt
+ */
+void port_sim_reset (void);
+/**
+ * @brief A function to let the simulated MCU sleep
+ * When disabled (default after port_sim_reset) the sleep hook returns at once
+ * as if an interrupt was pending, so tests can drive the tick themselves.
+ * @param enable- 1 to simulate the sleeps, 0 to return at once
+ */
+void port_sim_enable_sleep (int enable);
+/**
+ * @brief A function to raise an external interrupt after some ticks of sleep
+ * The interrupt wakes the simulated MCU and its ISR runs before the sleep hook
+ * returns.
+ * @param after_ticks- The ticks of sleep before the interrupt fires
+ * @param isr- The ISR to call
+ */
+void port_sim_raise_irq (uint32_t after_ticks, port_sim_isr_t isr);
+/**
+ * @brief A function to run an ISR now, as if its interrupt fired
+ * With nOS_PREEMPTIVE the ISR ends with nOS_isr_exit, unless it interrupted
+ * a context with interrupts locked.
+ * @param isr- The ISR to call
+ */
+void port_sim_isr (port_sim_isr_t isr);
+/**
+ * @brief A function to advance the simulated cycle counter (nOS_port_cycles)
+ * @param cycles- The number of cycles that elapsed
+ */
+void port_sim_advance_cycles (uint32_t cycles);
+/**
+ * @return The number of times the simulated MCU woke up from sleep
+ */
+uint32_t port_sim_wakeups (void);
+/**
+ * @return The number of ticks the simulated MCU slept
+ */
+uint32_t port_sim_slept_ticks (void);
+/**
+ * @return The number of sleeps entered without interrupts locked
+ */
+uint32_t port_sim_unlocked_sleeps (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PORT_HOST_SIM_H_ */
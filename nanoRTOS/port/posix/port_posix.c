@@ -0,0 +1,515 @@
+/**
+ * @file port_posix.c
+ * @author Ehud Frank
+ * Description A Linux port, real time signals play the interrupts.
+ * The fd sources are watched by a poller thread (edge triggered epoll) that
+ * raises their IRQ on the kernel thread, the handler reads the fd counter
+ * and skips the ISR when an earlier raise already consumed it.
+ * @date 17 Oct 2026
+ */
+
+#if defined(nOS_PORT_POSIX)
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include "nanoPort.h"
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+#define PORT_IRQ_SIGNAL(irq)    (SIGRTMIN + (irq))
+#define PORT_NS_PER_SEC         1000000000ull
+
+/**
+ * A structure to hold all the private variables of the port
+ */
+typedef struct
+{
+    pthread_t kernel_;                      // The thread that runs the ISRs
+    sigset_t irqs_;                         // All the IRQ signals
+    port_posix_isr_t isr_[PORT_POSIX_IRQS]; // The ISR of every IRQ, or NULL
+    int fd_[PORT_POSIX_IRQS];               // The fd source of an IRQ or -1
+    uint64_t fd_count_[PORT_POSIX_IRQS];    // The last counter read of an fd
+    volatile uint32_t irq_count_[PORT_POSIX_IRQS];
+    int epoll_;                             // The poller set or -1
+    int poller_stop_;                       // An eventfd that stops the poller
+    int poller_started_;
+    pthread_t poller_;
+    int tick_fd_;                           // The tick timerfd or -1
+    uint64_t tick_ns_;                      // The tick period
+    uint64_t tick_base_ns_;                 // The time of the last counted tick
+    volatile int sleeping_;                 // 1 while nOS_port_sleep_until waits
+    volatile uint32_t sleeps_;
+} port_posix_vars_t;
+
+static port_posix_vars_t port_posix_vars = { .epoll_ = -1, .poller_stop_ = -1,
+                                             .tick_fd_ = -1 };
+
+// The interrupt lock nesting and the mask to restore, per thread
+static __thread int port_lock_depth;
+static __thread sigset_t port_lock_saved;
+// The ISR nesting of the kernel thread
+static __thread int port_isr_depth;
+#if (nOS_SMP_CORES > 1)
+static __thread uint8_t port_core;
+#endif
+
+/**
+ * @brief The signal handler of all the IRQs, the interrupt entry
+ */
+static void port_irq_entry (int sig);
+/**
+ * @brief The poller thread, raises the IRQ of every fd that became readable
+ */
+static void *port_poller (void *arg);
+/**
+ * @brief The ISR of the tick, catches up with every expiry of the timerfd
+ */
+static void port_tick_isr (void);
+/**
+ * @return The CLOCK_MONOTONIC time in nanoseconds
+ */
+static uint64_t port_now_ns (void);
+/**
+ * @brief A function to program the tick timerfd
+ * @param first_ns- The absolute time of the first expiry, 0 disarms
+ * @param period_ns- The period, 0 for a one shot
+ */
+static int port_tick_arm (uint64_t first_ns, uint64_t period_ns);
+
+void port_posix_lock (void)
+{
+    sigset_t old;
+
+    pthread_sigmask (SIG_BLOCK, &port_posix_vars.irqs_, &old);
+    if (0 == port_lock_depth++)
+    {
+        port_lock_saved = old;
+    }
+}
+
+void port_posix_unlock (void)
+{
+    if (0 == --port_lock_depth)
+    {
+        pthread_sigmask (SIG_SETMASK, &port_lock_saved, NULL);
+    }
+}
+
+int port_posix_in_isr (void)
+{
+    return port_isr_depth;
+}
+
+int port_posix_init (void)
+{
+    uint8_t irq;
+
+    sigemptyset (&port_posix_vars.irqs_);
+    for (irq = 0; irq < PORT_POSIX_IRQS; irq++)
+    {
+        if (PORT_IRQ_SIGNAL(irq) > SIGRTMAX)
+        {
+            errno = EINVAL;
+            return -1;
+        }
+        sigaddset (&port_posix_vars.irqs_, PORT_IRQ_SIGNAL(irq));
+        port_posix_vars.isr_[irq] = NULL;
+        port_posix_vars.fd_[irq] = -1;
+        port_posix_vars.irq_count_[irq] = 0;
+    }
+    port_posix_vars.kernel_ = pthread_self ();
+    port_posix_vars.sleeps_ = 0;
+
+    return 0;
+}
+
+void port_posix_deinit (void)
+{
+    uint64_t one = 1;
+    uint8_t irq;
+
+    port_posix_tick_stop ();
+    if (port_posix_vars.poller_started_)
+    {
+        if (sizeof(one) != write (port_posix_vars.poller_stop_, &one, sizeof(one)))
+        {
+            // The poller is gone already
+        }
+        pthread_join (port_posix_vars.poller_, NULL);
+        port_posix_vars.poller_started_ = 0;
+    }
+    if (port_posix_vars.epoll_ >= 0)
+    {
+        close (port_posix_vars.epoll_);
+        close (port_posix_vars.poller_stop_);
+        port_posix_vars.epoll_ = -1;
+        port_posix_vars.poller_stop_ = -1;
+    }
+    for (irq = 0; irq < PORT_POSIX_IRQS; irq++)
+    {
+        port_posix_irq_attach (irq, NULL);
+    }
+}
+
+int port_posix_irq_attach (uint8_t irq, port_posix_isr_t isr)
+{
+    struct sigaction action;
+
+    if (irq >= PORT_POSIX_IRQS)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    memset (&action, 0, sizeof(action));
+    // An ISR is not interrupted by another IRQ, as on a single level NVIC
+    action.sa_mask = port_posix_vars.irqs_;
+    action.sa_flags = SA_RESTART;
+    // A detached IRQ is ignored, a late signal must not kill the process
+    action.sa_handler = (NULL == isr) ? SIG_IGN : port_irq_entry;
+    port_posix_lock ();
+    port_posix_vars.isr_[irq] = isr;
+    port_posix_vars.fd_[irq] = -1;
+    port_posix_unlock ();
+
+    return sigaction (PORT_IRQ_SIGNAL(irq), &action, NULL);
+}
+
+int port_posix_irq_attach_fd (uint8_t irq, int fd, port_posix_isr_t isr)
+{
+    struct epoll_event event;
+    sigset_t all;
+    sigset_t old;
+
+    if ((NULL == isr) || (fd < 0))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    if (0 != port_posix_irq_attach (irq, isr))
+    {
+        return -1;
+    }
+    port_posix_vars.fd_[irq] = fd;
+    if (port_posix_vars.epoll_ < 0)
+    {
+        port_posix_vars.epoll_ = epoll_create1 (EPOLL_CLOEXEC);
+        port_posix_vars.poller_stop_ = eventfd (0, EFD_CLOEXEC);
+        if ((port_posix_vars.epoll_ < 0) || (port_posix_vars.poller_stop_ < 0))
+        {
+            return -1;
+        }
+        event.events = EPOLLIN;
+        event.data.u32 = PORT_POSIX_IRQS;
+        epoll_ctl (port_posix_vars.epoll_, EPOLL_CTL_ADD,
+                   port_posix_vars.poller_stop_, &event);
+    }
+    // Edge triggered, every write or expiry raises the IRQ once, whether or
+    // not the handler read the fd already
+    event.events = EPOLLIN | EPOLLET;
+    event.data.u32 = irq;
+    if (0 != epoll_ctl (port_posix_vars.epoll_, EPOLL_CTL_ADD, fd, &event))
+    {
+        return -1;
+    }
+    if (!port_posix_vars.poller_started_)
+    {
+        // The poller inherits the mask, it never takes an IRQ itself
+        sigfillset (&all);
+        pthread_sigmask (SIG_SETMASK, &all, &old);
+        errno = pthread_create (&port_posix_vars.poller_, NULL, port_poller, NULL);
+        pthread_sigmask (SIG_SETMASK, &old, NULL);
+        if (0 != errno)
+        {
+            return -1;
+        }
+        port_posix_vars.poller_started_ = 1;
+    }
+
+    return 0;
+}
+
+void port_posix_irq_raise (uint8_t irq)
+{
+    if (irq < PORT_POSIX_IRQS)
+    {
+        pthread_kill (port_posix_vars.kernel_, PORT_IRQ_SIGNAL(irq));
+    }
+}
+
+int port_posix_tick_start (uint32_t period_us)
+{
+    if (0 == period_us)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    port_posix_tick_stop ();
+    port_posix_vars.tick_fd_ = timerfd_create (CLOCK_MONOTONIC,
+                                               TFD_NONBLOCK | TFD_CLOEXEC);
+    if (port_posix_vars.tick_fd_ < 0)
+    {
+        return -1;
+    }
+    port_posix_vars.tick_ns_ = (uint64_t) period_us * 1000;
+    port_posix_vars.tick_base_ns_ = port_now_ns ();
+    if ((0 != port_posix_irq_attach_fd (PORT_POSIX_TICK_IRQ,
+                                        port_posix_vars.tick_fd_, port_tick_isr))
+            || (0 != port_tick_arm (port_posix_vars.tick_base_ns_
+                                            + port_posix_vars.tick_ns_,
+                                    port_posix_vars.tick_ns_)))
+    {
+        port_posix_tick_stop ();
+        return -1;
+    }
+
+    return 0;
+}
+
+void port_posix_tick_stop (void)
+{
+    if (port_posix_vars.tick_fd_ < 0)
+    {
+        return;
+    }
+    port_posix_irq_attach (PORT_POSIX_TICK_IRQ, NULL);
+    if (port_posix_vars.epoll_ >= 0)
+    {
+        epoll_ctl (port_posix_vars.epoll_, EPOLL_CTL_DEL,
+                   port_posix_vars.tick_fd_, NULL);
+    }
+    close (port_posix_vars.tick_fd_);
+    port_posix_vars.tick_fd_ = -1;
+}
+
+void port_posix_idle (void)
+{
+    sigset_t wait;
+    int irq;
+
+    port_posix_lock ();
+    // Wait with all the IRQ signals unblocked, returns once an ISR ran
+    wait = port_lock_saved;
+    for (irq = 0; irq < PORT_POSIX_IRQS; irq++)
+    {
+        sigdelset (&wait, PORT_IRQ_SIGNAL(irq));
+    }
+    port_posix_vars.sleeps_++;
+    sigsuspend (&wait);
+    port_posix_unlock ();
+}
+
+uint32_t port_posix_irq_count (uint8_t irq)
+{
+    return (irq < PORT_POSIX_IRQS) ? port_posix_vars.irq_count_[irq] : 0;
+}
+
+uint32_t port_posix_sleeps (void)
+{
+    return port_posix_vars.sleeps_;
+}
+
+void port_posix_set_core (uint8_t core)
+{
+#if (nOS_SMP_CORES > 1)
+    port_core = core;
+#endif
+}
+
+#if nOS_STATS || nOS_TRACE || nOS_BUDGET
+uint32_t nOS_port_cycles (void)
+{
+    // One cycle per nanosecond
+    return (uint32_t) port_now_ns ();
+}
+#endif
+
+#if (nOS_SMP_CORES > 1)
+uint8_t nOS_port_core_id (void)
+{
+    return port_core;
+}
+#endif
+
+#if nOS_TICKLESS_IDLE
+nOS_tick_t nOS_port_sleep_until (nOS_tick_t wake_tick)
+{
+    nOS_tick_t ticks = 0;
+    nOS_tick_t elapsed;
+    uint64_t base = port_posix_vars.tick_base_ns_;
+    sigset_t wait;
+    int irq;
+
+    if (nOS_TICK_FOREVER != wake_tick)
+    {
+        ticks = wake_tick - nOS_timer_now ();
+        if (0 == ticks)
+        {
+            return 0;
+        }
+    }
+    // Nothing would ever wake the kernel, do not wait forever
+    for (irq = 0; (irq < PORT_POSIX_IRQS) && (NULL == port_posix_vars.isr_[irq]);
+            irq++)
+    {
+    }
+    if (PORT_POSIX_IRQS == irq)
+    {
+        return 0;
+    }
+    // The tick only wakes the kernel from here on, the port counts the ticks
+    port_posix_vars.sleeping_ = 1;
+    if (port_posix_vars.tick_fd_ >= 0)
+    {
+        port_tick_arm ((nOS_TICK_FOREVER == wake_tick) ?
+                               0 : base + ticks * port_posix_vars.tick_ns_, 0);
+    }
+    // Called with the IRQs locked, a pending IRQ returns at once
+    wait = port_lock_saved;
+    for (irq = 0; irq < PORT_POSIX_IRQS; irq++)
+    {
+        sigdelset (&wait, PORT_IRQ_SIGNAL(irq));
+    }
+    port_posix_vars.sleeps_++;
+    sigsuspend (&wait);
+    port_posix_vars.sleeping_ = 0;
+    if (port_posix_vars.tick_fd_ < 0)
+    {
+        return 0;
+    }
+    // Count the whole ticks slept and restart the tick on the same grid
+    elapsed = (nOS_tick_t) ((port_now_ns () - base) / port_posix_vars.tick_ns_);
+    port_posix_vars.tick_base_ns_ = base + elapsed * port_posix_vars.tick_ns_;
+    port_tick_arm (port_posix_vars.tick_base_ns_ + port_posix_vars.tick_ns_,
+                   port_posix_vars.tick_ns_);
+
+    return elapsed;
+}
+#endif
+
+/* ------------------------------------------------------------- */
+/* Private function */
+/* ------------------------------------------------------------- */
+static void port_irq_entry (int sig)
+{
+    int irq = sig - SIGRTMIN;
+    int saved_errno = errno;
+#if nOS_PREEMPTIVE
+    int lock_depth = port_lock_depth;
+#endif
+    port_posix_isr_t isr;
+    uint64_t count;
+    int fd;
+
+    if ((irq < 0) || (irq >= PORT_POSIX_IRQS))
+    {
+        return;
+    }
+    // A process directed signal (kill -s RTMIN+n) may hit any thread that
+    // does not block it, interrupts belong to the kernel thread
+    if (!pthread_equal (pthread_self (), port_posix_vars.kernel_))
+    {
+        pthread_kill (port_posix_vars.kernel_, sig);
+        return;
+    }
+    isr = port_posix_vars.isr_[irq];
+    fd = port_posix_vars.fd_[irq];
+    if (fd >= 0)
+    {
+        // An earlier raise of the same edge already took the counter
+        if (sizeof(count) != read (fd, &count, sizeof(count)))
+        {
+            errno = saved_errno;
+            return;
+        }
+        port_posix_vars.fd_count_[irq] = count;
+    }
+    port_posix_vars.irq_count_[irq]++;
+    if (NULL != isr)
+    {
+        port_isr_depth++;
+        isr ();
+        port_isr_depth--;
+    }
+#if nOS_PREEMPTIVE
+    // Only a context with the interrupts enabled is preempted, the idle hooks
+    // wait with them locked and run the tasks themselves
+    if (0 == lock_depth)
+    {
+        // The nested tasks may be interrupted in turn
+        pthread_sigmask (SIG_UNBLOCK, &port_posix_vars.irqs_, NULL);
+        nOS_isr_exit ();
+    }
+#endif
+    errno = saved_errno;
+}
+
+static void *port_poller (void *arg)
+{
+    struct epoll_event events[PORT_POSIX_IRQS + 1];
+    int count;
+    int i;
+
+    for (;;)
+    {
+        count = epoll_wait (port_posix_vars.epoll_, events,
+                            PORT_POSIX_IRQS + 1, -1);
+        for (i = 0; i < count; i++)
+        {
+            if (PORT_POSIX_IRQS == events[i].data.u32)
+            {
+                return NULL;
+            }
+            port_posix_irq_raise ((uint8_t) events[i].data.u32);
+        }
+    }
+
+    return NULL;
+}
+
+static void port_tick_isr (void)
+{
+    uint64_t count = port_posix_vars.fd_count_[PORT_POSIX_TICK_IRQ];
+
+    if (port_posix_vars.sleeping_)
+    {
+        // nOS_port_sleep_until counts the ticks of the sleep
+        return;
+    }
+    // A late kernel thread catches up with every expiry
+    while (count--)
+    {
+        port_posix_vars.tick_base_ns_ += port_posix_vars.tick_ns_;
+        nOS_timer_tick ();
+    }
+}
+
+static uint64_t port_now_ns (void)
+{
+    struct timespec now;
+
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * PORT_NS_PER_SEC + (uint64_t) now.tv_nsec;
+}
+
+static int port_tick_arm (uint64_t first_ns, uint64_t period_ns)
+{
+    struct itimerspec spec;
+
+    spec.it_value.tv_sec = (time_t) (first_ns / PORT_NS_PER_SEC);
+    spec.it_value.tv_nsec = (long) (first_ns % PORT_NS_PER_SEC);
+    spec.it_interval.tv_sec = (time_t) (period_ns / PORT_NS_PER_SEC);
+    spec.it_interval.tv_nsec = (long) (period_ns % PORT_NS_PER_SEC);
+
+    return timerfd_settime (port_posix_vars.tick_fd_, TFD_TIMER_ABSTIME,
+                            &spec, NULL);
+}
+
+#endif /* nOS_PORT_POSIX */
@@ -0,0 +1,123 @@
+/**
+ * @file port_posix.h
+ * @author Ehud Frank
+ * @date 17 Oct 2026
+ * @brief A Linux port, the kernel runs in one thread and POSIX real time
+ * signals play the interrupts. Enabled by defining nOS_PORT_POSIX.
+ * IRQ n is the signal SIGRTMIN + n, nOS_INTERRUPTS_LOCK blocks all the IRQ
+ * signals of the kernel thread. An IRQ is raised by another thread (a
+ * simulated peripheral), by a timerfd/eventfd that becomes readable or from
+ * a shell with kill -s RTMIN+n. Its ISR runs in the signal handler on the
+ * kernel thread, preempting the running task as an interrupt would.
+ * The idle hooks block in sigsuspend until the next IRQ.
+ * With nOS_PREEMPTIVE an ISR that interrupted a context with interrupts
+ * enabled ends with nOS_isr_exit, with the IRQs unmasked.
+ */
+
+#ifndef PORT_POSIX_H_
+#define PORT_POSIX_H_
+
+#include "stdint.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The interrupt lock masks the IRQ signals, it nests
+ */
+#define nOS_INTERRUPTS_LOCK()   port_posix_lock ()
+#define nOS_INTERRUPTS_UNLOCK() port_posix_unlock ()
+/**
+ * @brief Non zero while an ISR runs, the tasks it preempted into are not
+ */
+#define nOS_IN_ISR()            port_posix_in_isr ()
+
+/**
+ * @brief The number of IRQs, SIGRTMIN to SIGRTMIN + PORT_POSIX_IRQS - 1
+ */
+#define PORT_POSIX_IRQS         8
+/**
+ * @brief The IRQ of the kernel tick, see port_posix_tick_start
+ */
+#define PORT_POSIX_TICK_IRQ     0
+
+/**
+ * @brief An interrupt service routine
+ */
+typedef void (*port_posix_isr_t) (void);
+
+void port_posix_lock (void);
+void port_posix_unlock (void);
+int port_posix_in_isr (void);
+
+/**
+ * @brief A function to initialise the port, the calling thread becomes the
+ * kernel thread, the IRQs are delivered to it
+ * @return 0 or -1 with errno set
+ */
+int port_posix_init (void);
+/**
+ * @brief A function to stop the tick, detach all the IRQs and join the fd
+ * poller thread
+ */
+void port_posix_deinit (void);
+/**
+ * @brief A function to attach an ISR to an IRQ
+ * @param irq- The IRQ, from 0 to PORT_POSIX_IRQS - 1
+ * @param isr- The ISR, NULL detaches the IRQ
+ * @return 0 or -1 with errno set
+ */
+int port_posix_irq_attach (uint8_t irq, port_posix_isr_t isr);
+/**
+ * @brief A function to attach an ISR to an IRQ raised by an eventfd or a
+ * timerfd, the port reads the fd counter before the ISR is called
+ * @param irq- The IRQ, from 0 to PORT_POSIX_IRQS - 1
+ * @param fd- A non blocking eventfd or timerfd
+ * @param isr- The ISR
+ * @return 0 or -1 with errno set
+ */
+int port_posix_irq_attach_fd (uint8_t irq, int fd, port_posix_isr_t isr);
+/**
+ * @brief A function to raise an IRQ, e.g. from a simulated peripheral thread
+ * @param irq- The IRQ
+ */
+void port_posix_irq_raise (uint8_t irq);
+/**
+ * @brief A function to start the kernel tick, a timerfd on PORT_POSIX_TICK_IRQ
+ * that calls nOS_timer_tick
+ * @param period_us- The tick period in microseconds
+ * @return 0 or -1 with errno set
+ */
+int port_posix_tick_start (uint32_t period_us);
+/**
+ * @brief A function to stop the kernel tick
+ */
+void port_posix_tick_stop (void);
+/**
+ * @brief The idle hook without nOS_TICKLESS_IDLE, blocks until an IRQ was
+ * served. Call it after nOS_schedule returned.
+ * @note A task posted by an ISR that ran between the return of
+ * nOS_schedule and this call waits for the next IRQ, at most one tick while
+ * the tick runs. nOS_TICKLESS_IDLE closes the window.
+ */
+void port_posix_idle (void);
+/**
+ * @return The number of IRQs served since port_posix_init
+ */
+uint32_t port_posix_irq_count (uint8_t irq);
+/**
+ * @return The number of times the idle hooks blocked
+ */
+uint32_t port_posix_sleeps (void);
+/**
+ * @brief A function to set the core index of the calling thread, the
+ * nOS_port_core_id of nOS_SMP_CORES
+ */
+void port_posix_set_core (uint8_t core);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PORT_POSIX_H_ */
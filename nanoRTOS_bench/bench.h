@@ -0,0 +1,183 @@
+/*
+ * bench.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ *
+ * A minimal host benchmark harness: a monotonic nanosecond clock, latency
+ * samples with percentiles and a JSON writer for the results.
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+
+/**
+ * @brief A monotonic clock in nanoseconds
+ */
+static inline uint64_t now_ns (void)
+{
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+/**
+ * @brief A deterministic xorshift32 generator, every run draws the same numbers
+ */
+class Random
+{
+public:
+    explicit Random (uint32_t seed) :
+            state_ (seed ? seed : 1)
+    {
+    }
+    uint32_t next (void)
+    {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 17;
+        state_ ^= state_ << 5;
+        return state_;
+    }
+    uint32_t below (uint32_t limit)
+    {
+        return next () % limit;
+    }
+private:
+    uint32_t state_;
+};
+
+/**
+ * @brief Latency samples in nanoseconds
+ */
+class Samples
+{
+public:
+    void reserve (size_t n)
+    {
+        values_.reserve (n);
+    }
+    void add (double ns)
+    {
+        values_.push_back (ns);
+    }
+    size_t size (void) const
+    {
+        return values_.size ();
+    }
+    /**
+     * @brief The nearest rank percentile, sorts the samples on first use
+     */
+    double percentile (double p)
+    {
+        if (values_.empty ())
+        {
+            return 0;
+        }
+        if (!sorted_)
+        {
+            std::sort (values_.begin (), values_.end ());
+            sorted_ = true;
+        }
+        size_t rank = (size_t) (p / 100.0 * (double) (values_.size () - 1) + 0.5);
+        return values_[rank];
+    }
+    double max (void)
+    {
+        return percentile (100.0);
+    }
+private:
+    std::vector<double> values_;
+    bool sorted_ = false;
+};
+
+/**
+ * @brief The median cost of one now_ns() pair, subtracted from the samples
+ */
+static inline double timer_overhead_ns (void)
+{
+    Samples samples;
+    for (int i = 0; i < 10001; i++)
+    {
+        uint64_t start = now_ns ();
+        samples.add ((double) (now_ns () - start));
+    }
+    return samples.percentile (50);
+}
+
+/**
+ * @brief Writes one JSON document: {"benchmark": ..., "config": {...},
+ * "results": [{...}, ...]}, the results fields are numbers or strings
+ */
+class JsonWriter
+{
+public:
+    JsonWriter (FILE *out, const char *benchmark) :
+            out_ (out)
+    {
+        fprintf (out_, "{\n  \"benchmark\": \"%s\",\n  \"config\": {", benchmark);
+    }
+    void config (const char *key, long value)
+    {
+        fprintf (out_, "%s\n    \"%s\": %ld", config_count_++ ? "," : "", key, value);
+    }
+    void config (const char *key, const char *value)
+    {
+        fprintf (out_, "%s\n    \"%s\": \"%s\"", config_count_++ ? "," : "", key, value);
+    }
+    void begin_result (void)
+    {
+        if (!results_open_)
+        {
+            fprintf (out_, "\n  },\n  \"results\": [");
+            results_open_ = true;
+        }
+        fprintf (out_, "%s\n    {", result_count_++ ? "," : "");
+        field_count_ = 0;
+    }
+    void field (const char *key, const char *value)
+    {
+        fprintf (out_, "%s\"%s\": \"%s\"", field_count_++ ? ", " : "", key, value);
+    }
+    void field (const char *key, double value)
+    {
+        fprintf (out_, "%s\"%s\": %.1f", field_count_++ ? ", " : "", key, value);
+    }
+    void field (const char *key, uint64_t value)
+    {
+        fprintf (out_, "%s\"%s\": %llu", field_count_++ ? ", " : "", key,
+                 (unsigned long long) value);
+    }
+    void end_result (void)
+    {
+        fprintf (out_, "}");
+    }
+    ~JsonWriter ()
+    {
+        if (!results_open_)
+        {
+            fprintf (out_, "\n  },\n  \"results\": [");
+        }
+        fprintf (out_, "\n  ]\n}\n");
+    }
+private:
+    FILE *out_;
+    int config_count_ = 0;
+    int result_count_ = 0;
+    int field_count_ = 0;
+    bool results_open_ = false;
+};
+
+} // namespace bench
+
+#endif /* BENCH_H_ */
@@ -0,0 +1,142 @@
+/*
+ * bench_aging.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ *
+ * Wait of the lower priorities behind a saturated priority 8 stream, a task
+ * that posts itself again until the run ends. Every 4th dispatch on average
+ * the stream posts a task at a random priority 1 to 7, the bench reports the
+ * post to dispatch latency per priority and the posts lost to a full queue.
+ * Without nOS_AGING_CREDITS the lower priorities wait for the end of the
+ * stream, compare with make CONFIG="-DnOS_AGING_CREDITS=8" run.
+ * Usage: bench_aging [--quick] [--dispatches N]
+ */
+
+#include <stdlib.h>
+#include "bench.h"
+
+extern "C"
+{
+#include "nanoRTOS.h"
+}
+
+#define BENCH_SEED          0x6E4F5321u
+#define BENCH_FLOOD_PRIO    8
+#define BENCH_LOW_PRIOS     7
+#define BENCH_IN_FLIGHT     256     // Per priority, more than any queue holds
+
+#if (nOS_SMP_CORES > 1)
+// A single core runs the stream
+extern "C" uint8_t nOS_port_core_id (void)
+{
+    return 0;
+}
+#endif
+
+#ifdef nOS_TASK_TABLE
+#define BENCH_TASK  nOS_TASK_ID(bench_task)
+#else
+#define BENCH_TASK  bench_task
+#endif
+
+// The post times of the tasks in flight, FIFO per priority like the queues
+typedef struct
+{
+    uint64_t posted[BENCH_IN_FLIGHT];
+    uint32_t head;
+    uint32_t tail;
+    uint32_t dropped;
+    bench::Samples samples;
+} bench_level_t;
+
+static bench_level_t bench_levels[BENCH_LOW_PRIOS + 1];
+static bench::Random bench_random (BENCH_SEED);
+static uint32_t bench_flood_left;
+
+/**
+ * @brief The stream (event 0) and the lower priority tasks (event = prio)
+ */
+extern "C" void bench_task (uint8_t event)
+{
+    if (event)
+    {
+        bench_level_t &level = bench_levels[event];
+        level.samples.add ((double) (bench::now_ns ()
+                - level.posted[level.head++ % BENCH_IN_FLIGHT]));
+        return;
+    }
+    if (0 == bench_random.below (4))
+    {
+        uint8_t prio = (uint8_t) (1 + bench_random.below (BENCH_LOW_PRIOS));
+        bench_level_t &level = bench_levels[prio];
+
+        level.posted[level.tail % BENCH_IN_FLIGHT] = bench::now_ns ();
+        if (nOS_OK == nOS_task_enqueue (prio, BENCH_TASK, prio))
+        {
+            level.tail++;
+        }
+        else
+        {
+            level.dropped++;
+        }
+    }
+    if (--bench_flood_left)
+    {
+        nOS_task_enqueue (BENCH_FLOOD_PRIO, BENCH_TASK, 0);
+    }
+}
+
+int main (int argc, char **argv)
+{
+    uint32_t dispatches = 1000000;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (0 == strcmp (argv[i], "--quick"))
+        {
+            dispatches = 100000;
+        }
+        else if ((0 == strcmp (argv[i], "--dispatches")) && (i + 1 < argc))
+        {
+            dispatches = (uint32_t) strtoul (argv[++i], NULL, 0);
+        }
+    }
+    if (0 == dispatches)
+    {
+        dispatches = 1;
+    }
+
+    nOS_start ();
+    for (nOS_prio_t prio = 1; prio <= BENCH_LOW_PRIOS; prio++)
+    {
+        bench_levels[prio].samples.reserve (dispatches / 4);
+    }
+    bench_flood_left = dispatches;
+    nOS_task_enqueue (BENCH_FLOOD_PRIO, BENCH_TASK, 0);
+    nOS_schedule ();
+
+    {
+        bench::JsonWriter json (stdout, "aging");
+        json.config ("aging_credits", (long) nOS_AGING_CREDITS);
+        json.config ("schedule_batch", (long) nOS_SCHEDULE_BATCH);
+        json.config ("dispatches", (long) dispatches);
+        json.config ("seed", (long) BENCH_SEED);
+        json.config ("compiler", __VERSION__);
+        for (nOS_prio_t prio = BENCH_LOW_PRIOS; prio >= 1; prio--)
+        {
+            bench_level_t &level = bench_levels[prio];
+
+            json.begin_result ();
+            json.field ("prio", (uint64_t) prio);
+            json.field ("samples", (uint64_t) level.samples.size ());
+            json.field ("dropped", (uint64_t) level.dropped);
+            json.field ("p50_ns", level.samples.percentile (50));
+            json.field ("p99_ns", level.samples.percentile (99));
+            json.field ("max_ns", level.samples.max ());
+            json.end_result ();
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * bench_preempt.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ *
+ * Latency from an ISR to the priority 8 task it posts while a priority 1 task
+ * keeps the CPU busy, on the POSIX port (the ISR is a timerfd IRQ).
+ * The Makefile builds it twice, bench_preempt_off runs the urgent task once
+ * the busy task returned, bench_preempt_on (nOS_PREEMPTIVE) at the ISR exit.
+ * Usage: bench_preempt_off|on [--quick] [--samples N] [--work US] [--period US]
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+#include "bench.h"
+
+extern "C"
+{
+#include "nanoRTOS.h"
+}
+
+#define BENCH_IRQ           1
+#define BENCH_URGENT_PRIO   8
+#define BENCH_BUSY_PRIO     1
+
+static bench::Samples bench_samples;
+static uint32_t bench_wanted = 2000;
+static uint32_t bench_work_us = 2000;
+static volatile uint64_t bench_isr_ns;
+static volatile int bench_pending;
+
+extern "C" void bench_urgent_task (uint8_t event)
+{
+    bench_samples.add ((double) (bench::now_ns () - bench_isr_ns));
+    bench_pending = 0;
+}
+
+extern "C" void bench_busy_task (uint8_t event)
+{
+    uint64_t end = bench::now_ns () + (uint64_t) bench_work_us * 1000;
+
+    // A long low priority callback, e.g. a flash write
+    while (bench::now_ns () < end)
+    {
+    }
+    if (bench_samples.size () < bench_wanted)
+    {
+        nOS_task_enqueue (BENCH_BUSY_PRIO, bench_busy_task, 0);
+    }
+}
+
+static void bench_isr (void)
+{
+    // One urgent task in flight, a late one would measure the queue
+    if (!bench_pending && (bench_samples.size () < bench_wanted))
+    {
+        bench_pending = 1;
+        bench_isr_ns = bench::now_ns ();
+        nOS_task_enqueue (BENCH_URGENT_PRIO, bench_urgent_task, 0);
+    }
+}
+
+int main (int argc, char **argv)
+{
+    uint32_t period_us = 997;
+    struct itimerspec spec = { };
+    int fd;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (0 == strcmp (argv[i], "--quick"))
+        {
+            bench_wanted = 200;
+        }
+        else if ((0 == strcmp (argv[i], "--samples")) && (i + 1 < argc))
+        {
+            bench_wanted = (uint32_t) strtoul (argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp (argv[i], "--work")) && (i + 1 < argc))
+        {
+            bench_work_us = (uint32_t) strtoul (argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp (argv[i], "--period")) && (i + 1 < argc))
+        {
+            period_us = (uint32_t) strtoul (argv[++i], NULL, 0);
+        }
+    }
+
+    nOS_start ();
+    fd = timerfd_create (CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if ((0 != port_posix_init ())
+            || (0 != port_posix_irq_attach_fd (BENCH_IRQ, fd, bench_isr)))
+    {
+        perror ("bench_preempt");
+        return 1;
+    }
+    // The urgent task runs in the signal handler, it shall not allocate
+    bench_samples.reserve (bench_wanted);
+    // The period is not a multiple of the work, the IRQ hits the busy task
+    // at every phase
+    spec.it_interval.tv_sec = period_us / 1000000;
+    spec.it_interval.tv_nsec = (long) (period_us % 1000000) * 1000;
+    spec.it_value = spec.it_interval;
+    timerfd_settime (fd, 0, &spec, NULL);
+
+    nOS_task_enqueue (BENCH_BUSY_PRIO, bench_busy_task, 0);
+    while (bench_samples.size () < bench_wanted)
+    {
+        nOS_schedule ();
+    }
+    port_posix_deinit ();
+    close (fd);
+
+    {
+        bench::JsonWriter json (stdout, "preempt");
+        json.config ("preemptive", (long) nOS_PREEMPTIVE);
+        json.config ("work_us", (long) bench_work_us);
+        json.config ("period_us", (long) period_us);
+        json.config ("compiler", __VERSION__);
+        json.begin_result ();
+        json.field ("workload", "isr_to_urgent_task");
+        json.field ("samples", (uint64_t) bench_samples.size ());
+        json.field ("p50_ns", bench_samples.percentile (50));
+        json.field ("p99_ns", bench_samples.percentile (99));
+        json.field ("max_ns", bench_samples.max ());
+        json.end_result ();
+    }
+
+    return 0;
+}
@@ -0,0 +1,208 @@
+/*
+ * bench_queue.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ *
+ * In/out throughput of the nanoQueue flavours the kernel can use for its task
+ * queues: the checked int queue (nOS_CREATE_TYPED_QUEUE) and the power of two
+ * queue with narrow masked indices (nOS_CREATE_POW2_QUEUE).
+ * Every round pushes a burst of tasks and pops them back, one operation is one
+ * value in and out. The queues are used as the kernel does with
+ * nOS_TASK_QUEUE_LOCKED and nOS_TASK_QUEUE_POW2: checked for room first.
+ * Usage: bench_queue [--quick] [--rounds N]
+ */
+
+#include <stdlib.h>
+#include "bench.h"
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+extern "C"
+{
+#include "nanoRTOS.h"
+#include "nanoQueue.h"
+
+nOS_CREATE_TYPED_QUEUE(typed_queue, nOS_task_t)
+nOS_INSTALL_QUEUE_APIs(typed_queue, nOS_task_t)
+
+nOS_CREATE_POW2_QUEUE(pow2_queue, nOS_task_t, uint8_t)
+nOS_INSTALL_POW2_QUEUE_APIs(pow2_queue, nOS_task_t, uint8_t)
+}
+
+#define BENCH_SEED          0x6E4F5321u
+#define BENCH_QUEUE_LENGTH  32
+
+static typed_queue_t typed_queue;
+static nOS_task_t typed_queue_buff[BENCH_QUEUE_LENGTH];
+static pow2_queue_t pow2_queue;
+static nOS_task_t pow2_queue_buff[BENCH_QUEUE_LENGTH];
+
+static volatile uint32_t bench_sink;
+
+static uint32_t round_typed (uint32_t burst)
+{
+    nOS_task_t task;
+    uint32_t ops = 0;
+
+    memset (&task, 0, sizeof(task));
+    task.event_ = 1;
+
+    while ((ops < burst) && !typed_queue_is_full (&typed_queue))
+    {
+        typed_queue_in (&typed_queue, &task);
+        ops++;
+    }
+    while (!typed_queue_is_empty (&typed_queue))
+    {
+        typed_queue_out (&typed_queue, &task);
+        bench_sink += task.event_;
+    }
+    return ops;
+}
+
+static uint32_t round_pow2 (uint32_t burst)
+{
+    nOS_task_t task;
+    uint32_t ops = 0;
+
+    memset (&task, 0, sizeof(task));
+    task.event_ = 1;
+
+    while ((ops < burst) && !pow2_queue_is_full (&pow2_queue))
+    {
+        pow2_queue_in (&pow2_queue, &task);
+        ops++;
+    }
+    while (!pow2_queue_is_empty (&pow2_queue))
+    {
+        pow2_queue_out (&pow2_queue, &task);
+        bench_sink += task.event_;
+    }
+    return ops;
+}
+
+typedef struct
+{
+    const char *name;
+    uint32_t (*round) (uint32_t burst);
+    size_t header_size;
+} queue_t;
+
+static const queue_t queues[] =
+{
+{ "typed", round_typed, sizeof(typed_queue_t) },
+{ "pow2", round_pow2, sizeof(pow2_queue_t) } };
+
+typedef struct
+{
+    const char *name;
+    uint32_t fixed_burst; // 0 for a random burst
+} workload_t;
+
+static const workload_t workloads[] =
+{
+{ "single", 1 },
+{ "burst_fill", BENCH_QUEUE_LENGTH },
+{ "mixed", 0 } };
+
+static void run_workload (bench::JsonWriter &json, const queue_t &queue,
+                          const workload_t &workload, uint32_t rounds,
+                          double overhead_ns)
+{
+    bench::Random random (BENCH_SEED);
+    bench::Samples samples;
+    uint64_t ops = 0, start, elapsed;
+    uint32_t round_ops, burst;
+
+    typed_queue_init (&typed_queue, typed_queue_buff, BENCH_QUEUE_LENGTH);
+    pow2_queue_init (&pow2_queue, pow2_queue_buff, BENCH_QUEUE_LENGTH);
+    // Warm up the caches and the branch predictors
+    for (uint32_t i = 0; i < rounds / 10; i++)
+    {
+        queue.round (workload.fixed_burst);
+    }
+
+    // Throughput, the rounds are timed as a whole
+    start = bench::now_ns ();
+    for (uint32_t i = 0; i < rounds; i++)
+    {
+        burst = workload.fixed_burst ?
+                workload.fixed_burst : 1 + random.below (BENCH_QUEUE_LENGTH);
+        ops += queue.round (burst);
+    }
+    elapsed = bench::now_ns () - start;
+
+    // Latency, every round is timed and spread over its operations
+    random = bench::Random (BENCH_SEED);
+    samples.reserve (rounds);
+    for (uint32_t i = 0; i < rounds; i++)
+    {
+        burst = workload.fixed_burst ?
+                workload.fixed_burst : 1 + random.below (BENCH_QUEUE_LENGTH);
+        start = bench::now_ns ();
+        round_ops = queue.round (burst);
+        double ns = (double) (bench::now_ns () - start) - overhead_ns;
+        if (round_ops)
+        {
+            samples.add ((ns > 0 ? ns : 0) / round_ops);
+        }
+    }
+
+    json.begin_result ();
+    json.field ("queue", queue.name);
+    json.field ("workload", workload.name);
+    json.field ("header_bytes", (uint64_t) queue.header_size);
+    json.field ("rounds", (uint64_t) rounds);
+    json.field ("ops", ops);
+    json.field ("ops_per_sec", (double) ops * 1e9 / (double) elapsed);
+    json.field ("ns_per_op", (double) elapsed / (double) ops);
+    json.field ("p50_ns", samples.percentile (50));
+    json.field ("p99_ns", samples.percentile (99));
+    json.field ("max_ns", samples.max ());
+    json.end_result ();
+}
+
+int main (int argc, char **argv)
+{
+    uint32_t rounds = 200000;
+    double overhead_ns;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (0 == strcmp (argv[i], "--quick"))
+        {
+            rounds = 20000;
+        }
+        else if ((0 == strcmp (argv[i], "--rounds")) && (i + 1 < argc))
+        {
+            rounds = (uint32_t) strtoul (argv[++i], NULL, 0);
+        }
+    }
+#ifdef __linux__
+    // Stay on one CPU so the runs are comparable
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(0, &cpus);
+    sched_setaffinity (0, sizeof(cpus), &cpus);
+#endif
+    overhead_ns = bench::timer_overhead_ns ();
+
+    {
+        bench::JsonWriter json (stdout, "queue");
+        json.config ("queue_length", (long) BENCH_QUEUE_LENGTH);
+        json.config ("seed", (long) BENCH_SEED);
+        json.config ("timer_overhead_ns", (long) overhead_ns);
+        json.config ("compiler", __VERSION__);
+        for (const workload_t &workload : workloads)
+        {
+            for (const queue_t &queue : queues)
+            {
+                run_workload (json, queue, workload, rounds, overhead_ns);
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,297 @@
+/*
+ * bench_scheduler.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ *
+ * Enqueue + dispatch throughput and latency of the nanoRTOS scheduler.
+ * Every workload round posts some tasks with nOS_task_enqueue and drains them
+ * with nOS_schedule, one operation is one task posted and dispatched.
+ * Usage: bench_scheduler [--quick] [--rounds N]
+ */
+
+#include <stdlib.h>
+#include "bench.h"
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+extern "C"
+{
+#include "nanoRTOS.h"
+#include "nanoPool.h"
+}
+
+#define BENCH_SEED  0x6E4F5321u
+
+#if (nOS_SMP_CORES > 1)
+// A single core runs the workloads, see bench_smp for the scaling
+extern "C" uint8_t nOS_port_core_id (void)
+{
+    return 0;
+}
+#endif
+
+static volatile uint32_t bench_dispatched;
+
+extern "C" void bench_task (uint8_t event)
+{
+    bench_dispatched += event;
+}
+
+// Also benchmark the task IDs, e.g. CONFIG="-D'nOS_TASK_TABLE(X)=X(bench_task)'"
+#ifdef nOS_TASK_TABLE
+#define BENCH_TASK  nOS_TASK_ID(bench_task)
+#else
+#define BENCH_TASK  bench_task
+#endif
+
+/**
+ * One task at the lowest priority per round
+ */
+static uint32_t round_single_priority (bench::Random &random)
+{
+    nOS_task_enqueue (1, BENCH_TASK, 1);
+    nOS_schedule ();
+    return 1;
+}
+
+/**
+ * One task per priority per round, the scheduler walks all the ready flags
+ */
+static uint32_t round_all_priorities (bench::Random &random)
+{
+    for (nOS_prio_t prio = 1; prio <= nOS_PRIO_COUNT; prio++)
+    {
+        nOS_task_enqueue (prio, BENCH_TASK, 1);
+    }
+    nOS_schedule ();
+    return nOS_PRIO_COUNT;
+}
+
+/**
+ * Fill the lowest priority queue up to its capacity then drain it
+ */
+static uint32_t round_burst_fill (bench::Random &random)
+{
+    uint32_t ops = 0;
+
+    while (nOS_OK == nOS_task_enqueue (1, BENCH_TASK, 1))
+    {
+        ops++;
+    }
+    nOS_schedule ();
+    return ops;
+}
+
+/**
+ * Fill the lowest priority queue with one batch then drain it
+ */
+static uint32_t round_batch_fill (bench::Random &random)
+{
+    static uint8_t events[nOS_PRIO1_TASK_QUEUE_LENGTH];
+
+    nOS_task_enqueue_batch (1, BENCH_TASK, events, nOS_PRIO1_TASK_QUEUE_LENGTH);
+    nOS_schedule ();
+    return nOS_PRIO1_TASK_QUEUE_LENGTH;
+}
+
+#if nOS_TASK_COALESCE
+/**
+ * An interrupt storm posts the same task 16 times before the scheduler runs,
+ * one operation is one post
+ */
+static uint32_t round_coalesced_storm (bench::Random &random)
+{
+    for (int i = 0; i < 16; i++)
+    {
+        nOS_task_enqueue_coalesced (1, BENCH_TASK, 1 << (i & 7), nOS_COALESCE_OR);
+    }
+    nOS_schedule ();
+    return 16;
+}
+#endif
+
+#if nOS_MSG_POOL
+static void bench_msg_task (void *msg)
+{
+    bench_dispatched += ((uint8_t *) msg)[0];
+}
+
+/**
+ * An interrupt fills 8 frames of 48 bytes and posts them as messages, the
+ * frames are freed after dispatch, one operation is one alloc, post and free
+ */
+static uint32_t round_msg_frames (bench::Random &random)
+{
+    uint8_t *frame;
+
+    for (int i = 0; i < 8; i++)
+    {
+        frame = (uint8_t *) nOS_pool_alloc (48);
+        memset (frame, i, 48);
+        nOS_task_post_msg (1, bench_msg_task, frame);
+    }
+    nOS_schedule ();
+    return 8;
+}
+#endif
+
+#ifdef nOS_TOPIC_TABLE
+/**
+ * One publish to all the subscribers of the bench_fanout topic, compare with
+ * all_priorities, one operation is one subscriber posted and dispatched, e.g.
+ * CONFIG="-D'nOS_TOPIC_TABLE(X)=X(bench_fanout, nOS_SUBSCRIBER(1, bench_task)
+ * nOS_SUBSCRIBER(2, bench_task) ... nOS_SUBSCRIBER(8, bench_task))'"
+ */
+static uint32_t round_publish_fanout (bench::Random &random)
+{
+    uint32_t dispatched = bench_dispatched;
+
+    nOS_publish (nOS_TOPIC(bench_fanout), 1);
+    nOS_schedule ();
+    return bench_dispatched - dispatched;
+}
+#endif
+
+/**
+ * A random number of tasks at random priorities, tasks rejected by a full
+ * queue are not counted
+ */
+static uint32_t round_mixed (bench::Random &random)
+{
+    uint32_t ops = 0;
+    uint32_t tasks = 1 + random.below (16);
+
+    while (tasks--)
+    {
+        if (nOS_OK == nOS_task_enqueue (1 + random.below (nOS_PRIO_COUNT), BENCH_TASK, 1))
+        {
+            ops++;
+        }
+    }
+    nOS_schedule ();
+    return ops;
+}
+
+typedef struct
+{
+    const char *name;
+    uint32_t (*round) (bench::Random &random);
+} workload_t;
+
+static const workload_t workloads[] =
+{
+{ "single_priority", round_single_priority },
+{ "all_priorities", round_all_priorities },
+{ "burst_fill", round_burst_fill },
+{ "batch_fill", round_batch_fill },
+#if nOS_TASK_COALESCE
+{ "coalesced_storm", round_coalesced_storm },
+#endif
+#if nOS_MSG_POOL
+{ "msg_frames", round_msg_frames },
+#endif
+#ifdef nOS_TOPIC_TABLE
+{ "publish_fanout", round_publish_fanout },
+#endif
+{ "mixed", round_mixed } };
+
+static void run_workload (bench::JsonWriter &json, const workload_t &workload,
+                          uint32_t rounds, double overhead_ns)
+{
+    bench::Random random (BENCH_SEED);
+    bench::Samples samples;
+    uint64_t ops = 0, start, elapsed;
+    uint32_t round_ops;
+
+    nOS_start ();
+    // Warm up the caches and the branch predictors
+    for (uint32_t i = 0; i < rounds / 10; i++)
+    {
+        workload.round (random);
+    }
+
+    // Throughput, the rounds are timed as a whole
+    random = bench::Random (BENCH_SEED);
+    start = bench::now_ns ();
+    for (uint32_t i = 0; i < rounds; i++)
+    {
+        ops += workload.round (random);
+    }
+    elapsed = bench::now_ns () - start;
+
+    // Latency, every round is timed and spread over its operations
+    random = bench::Random (BENCH_SEED);
+    samples.reserve (rounds);
+    for (uint32_t i = 0; i < rounds; i++)
+    {
+        start = bench::now_ns ();
+        round_ops = workload.round (random);
+        double ns = (double) (bench::now_ns () - start) - overhead_ns;
+        if (round_ops)
+        {
+            samples.add ((ns > 0 ? ns : 0) / round_ops);
+        }
+    }
+
+    json.begin_result ();
+    json.field ("workload", workload.name);
+    json.field ("rounds", (uint64_t) rounds);
+    json.field ("ops", ops);
+    json.field ("ops_per_sec", (double) ops * 1e9 / (double) elapsed);
+    json.field ("ns_per_op", (double) elapsed / (double) ops);
+    json.field ("p50_ns", samples.percentile (50));
+    json.field ("p99_ns", samples.percentile (99));
+    json.field ("max_ns", samples.max ());
+    json.end_result ();
+}
+
+int main (int argc, char **argv)
+{
+    uint32_t rounds = 200000;
+    double overhead_ns;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (0 == strcmp (argv[i], "--quick"))
+        {
+            rounds = 20000;
+        }
+        else if ((0 == strcmp (argv[i], "--rounds")) && (i + 1 < argc))
+        {
+            rounds = (uint32_t) strtoul (argv[++i], NULL, 0);
+        }
+    }
+#ifdef __linux__
+    // Stay on one CPU so the runs are comparable
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(0, &cpus);
+    sched_setaffinity (0, sizeof(cpus), &cpus);
+#endif
+    overhead_ns = bench::timer_overhead_ns ();
+
+    {
+        bench::JsonWriter json (stdout, "scheduler");
+        json.config ("task_queue_impl",
+                     nOS_TASK_QUEUE_IMPL == nOS_TASK_QUEUE_LOCK_FREE ?
+                             "lock_free" :
+                     nOS_TASK_QUEUE_IMPL == nOS_TASK_QUEUE_POW2 ?
+                             "pow2" : "locked");
+        json.config ("stats", (long) nOS_STATS);
+        json.config ("schedule_batch", (long) nOS_SCHEDULE_BATCH);
+        json.config ("coalesce", (long) nOS_TASK_COALESCE);
+        json.config ("msg_pool", (long) nOS_MSG_POOL);
+        json.config ("task_bytes", (long) sizeof(nOS_task_t));
+        json.config ("seed", (long) BENCH_SEED);
+        json.config ("timer_overhead_ns", (long) overhead_ns);
+        json.config ("compiler", __VERSION__);
+        for (const workload_t &workload : workloads)
+        {
+            run_workload (json, workload, rounds, overhead_ns);
+        }
+    }
+
+    return 0;
+}
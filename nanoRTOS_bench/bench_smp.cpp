@@ -0,0 +1,205 @@
+/*
+ * bench_smp.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ *
+ * Throughput scaling of the multi core scheduler (nOS_SMP_CORES) from 1 to
+ * nOS_SMP_CORES cores, threads play the role of the cores.
+ * steal - An interrupt of core 0 posts all the tasks, the other cores only
+ *         get work by stealing it.
+ * local - Every core posts its own tasks and runs them.
+ * Every task busy loops for --work iterations, one operation is one task.
+ * Usage: bench_smp [--quick] [--tasks N] [--work N]
+ * e.g. make CONFIG="-DnOS_SMP_CORES=4" run
+ */
+
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+#include "bench.h"
+
+extern "C"
+{
+#include "nanoRTOS.h"
+#include "nanoAtomic.h"
+}
+
+static uint32_t bench_work = 200;
+static uint32_t bench_dispatched;
+static thread_local uint8_t bench_core;
+static thread_local uint32_t bench_core_dispatched;
+
+#if (nOS_SMP_CORES > 1)
+extern "C" uint8_t nOS_port_core_id (void)
+{
+    return bench_core;
+}
+#endif
+
+extern "C" void bench_task (uint8_t event)
+{
+    volatile uint32_t sink = event;
+
+    for (uint32_t i = 0; i < bench_work; i++)
+    {
+        sink += i;
+    }
+    bench_core_dispatched++;
+    nOS_ATOMIC_FETCH_ADD(&bench_dispatched, 1);
+}
+
+#ifdef nOS_TASK_TABLE
+#define BENCH_TASK  nOS_TASK_ID(bench_task)
+#else
+#define BENCH_TASK  bench_task
+#endif
+
+/**
+ * @brief Posts one task, waits for room while the queue is full
+ */
+static void bench_post (nOS_prio_t prio)
+{
+    while (nOS_OK != nOS_task_enqueue (prio, BENCH_TASK, 1))
+    {
+        std::this_thread::yield ();
+    }
+}
+
+/**
+ * @brief The loop of a core, until all the tasks ran
+ * @param posts- The tasks the core posts itself, 0 for none
+ */
+static void core_loop (uint8_t core, uint32_t total, uint32_t posts,
+                       uint32_t *dispatched)
+{
+    uint32_t before;
+
+    bench_core = core;
+    bench_core_dispatched = 0;
+    while (nOS_ATOMIC_LOAD(&bench_dispatched) < total)
+    {
+        for (int i = 0; (i < 8) && posts; i++, posts--)
+        {
+            bench_post (1 + posts % nOS_PRIO_COUNT);
+        }
+        before = bench_core_dispatched;
+        nOS_schedule ();
+        if (before == bench_core_dispatched)
+        {
+            // Idle, leave the CPU to the others when there are more cores
+            // than CPUs
+            std::this_thread::yield ();
+        }
+    }
+    *dispatched = bench_core_dispatched;
+}
+
+static double run (bench::JsonWriter &json, const char *workload,
+                   uint8_t cores, uint32_t tasks, double base_tps)
+{
+    std::vector<std::thread> threads;
+    std::vector<uint32_t> dispatched (cores);
+    bool steal = (0 == strcmp (workload, "steal"));
+    uint64_t start, elapsed;
+    uint32_t min, max;
+
+    nOS_start ();
+    bench_dispatched = 0;
+    start = bench::now_ns ();
+    for (uint8_t core = 0; core < cores; core++)
+    {
+        uint32_t posts = steal ? 0 : tasks / cores + (core < tasks % cores);
+        threads.emplace_back (core_loop, core, tasks, posts, &dispatched[core]);
+    }
+    if (steal)
+    {
+        // An interrupt of core 0
+        threads.emplace_back ([tasks]()
+        {
+            bench_core = 0;
+            for (uint32_t i = 0; i < tasks; i++)
+            {
+                bench_post (1 + i % nOS_PRIO_COUNT);
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join ();
+    }
+    elapsed = bench::now_ns () - start;
+
+    min = *std::min_element (dispatched.begin (), dispatched.end ());
+    max = *std::max_element (dispatched.begin (), dispatched.end ());
+    double tps = (double) tasks * 1e9 / (double) elapsed;
+    json.begin_result ();
+    json.field ("workload", workload);
+    json.field ("cores", (uint64_t) cores);
+    json.field ("ops", (uint64_t) tasks);
+    json.field ("ops_per_sec", tps);
+    json.field ("ns_per_op", (double) elapsed / (double) tasks);
+    json.field ("speedup", base_tps > 0 ? tps / base_tps : 1.0);
+    json.field ("core_min_ops", (uint64_t) min);
+    json.field ("core_max_ops", (uint64_t) max);
+    json.end_result ();
+
+    return tps;
+}
+
+int main (int argc, char **argv)
+{
+    uint32_t tasks = 400000;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (0 == strcmp (argv[i], "--quick"))
+        {
+            tasks = 40000;
+        }
+        else if ((0 == strcmp (argv[i], "--tasks")) && (i + 1 < argc))
+        {
+            tasks = (uint32_t) strtoul (argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp (argv[i], "--work")) && (i + 1 < argc))
+        {
+            bench_work = (uint32_t) strtoul (argv[++i], NULL, 0);
+        }
+    }
+
+    {
+        bench::JsonWriter json (stdout, "smp");
+        json.config ("smp_cores", (long) nOS_SMP_CORES);
+        json.config ("host_cpus", (long) std::thread::hardware_concurrency ());
+        json.config ("task_queue_impl",
+                     nOS_TASK_QUEUE_IMPL == nOS_TASK_QUEUE_LOCK_FREE ?
+                             "lock_free" :
+                     nOS_TASK_QUEUE_IMPL == nOS_TASK_QUEUE_POW2 ?
+                             "pow2" : "locked");
+        json.config ("schedule_batch", (long) nOS_SCHEDULE_BATCH);
+        json.config ("work", (long) bench_work);
+        json.config ("compiler", __VERSION__);
+        for (const char *workload : { "steal", "local" })
+        {
+#if (nOS_SMP_CORES == 1) && (nOS_TASK_QUEUE_IMPL != nOS_TASK_QUEUE_LOCK_FREE)
+            // The interrupt thread would race the core, the host does not
+            // lock interrupts
+            if (0 == strcmp (workload, "steal"))
+            {
+                continue;
+            }
+#endif
+            double base_tps = 0;
+            for (uint8_t cores = 1; cores <= nOS_SMP_CORES; cores++)
+            {
+                double tps = run (json, workload, cores, tasks, base_tps);
+                if (1 == cores)
+                {
+                    base_tps = tps;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,269 @@
+/*
+ * bench_template.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ *
+ * Enqueue + dispatch cost of the C kernel (nOS_task_enqueue/nOS_schedule of
+ * nanoRTOS.c) against the header only nOS::Scheduler of nanoRTOS.hpp on the
+ * same workloads, one operation is one task posted and dispatched. The
+ * template scheduler has the default queue lengths of nanoConfig.h
+ * (nOS_PRIOx_TASK_QUEUE_LENGTH), the C kernel follows CONFIG.
+ * Usage: bench_template [--quick] [--rounds N]
+ */
+
+#include <stdlib.h>
+#include "bench.h"
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "nanoRTOS.hpp"
+
+#define BENCH_SEED  0x6E4F5321u
+
+#if (nOS_SMP_CORES > 1)
+// A single core runs the workloads
+extern "C" uint8_t nOS_port_core_id (void)
+{
+    return 0;
+}
+#endif
+
+typedef nOS::Config<nOS_PRIO1_TASK_QUEUE_LENGTH, nOS_PRIO2_TASK_QUEUE_LENGTH,
+        nOS_PRIO3_TASK_QUEUE_LENGTH, nOS_PRIO4_TASK_QUEUE_LENGTH,
+        nOS_PRIO5_TASK_QUEUE_LENGTH, nOS_PRIO6_TASK_QUEUE_LENGTH,
+        nOS_PRIO7_TASK_QUEUE_LENGTH, nOS_PRIO8_TASK_QUEUE_LENGTH> bench_config_t;
+
+static nOS::Scheduler<bench_config_t> bench_scheduler;
+static volatile uint32_t bench_dispatched;
+
+extern "C" void bench_task (uint8_t event)
+{
+    bench_dispatched += event;
+}
+
+#ifdef nOS_TASK_TABLE
+#define BENCH_TASK  nOS_TASK_ID(bench_task)
+#else
+#define BENCH_TASK  bench_task
+#endif
+
+/**
+ * One task at the lowest priority per round
+ */
+static uint32_t c_single_priority (bench::Random &random)
+{
+    nOS_task_enqueue (1, BENCH_TASK, 1);
+    nOS_schedule ();
+    return 1;
+}
+
+static uint32_t cpp_single_priority (bench::Random &random)
+{
+    bench_scheduler.enqueue<1> (bench_task, 1);
+    bench_scheduler.schedule ();
+    return 1;
+}
+
+/**
+ * One task per priority per round
+ */
+static uint32_t c_all_priorities (bench::Random &random)
+{
+    for (nOS_prio_t prio = 1; prio <= 8; prio++)
+    {
+        nOS_task_enqueue (prio, BENCH_TASK, 1);
+    }
+    nOS_schedule ();
+    return 8;
+}
+
+static uint32_t cpp_all_priorities (bench::Random &random)
+{
+    for (nOS_prio_t prio = 1; prio <= 8; prio++)
+    {
+        bench_scheduler.enqueue (prio, bench_task, 1);
+    }
+    bench_scheduler.schedule ();
+    return 8;
+}
+
+/**
+ * Fill the lowest priority queue up to its capacity then drain it
+ */
+static uint32_t c_burst_fill (bench::Random &random)
+{
+    uint32_t ops = 0;
+
+    while (nOS_OK == nOS_task_enqueue (1, BENCH_TASK, 1))
+    {
+        ops++;
+    }
+    nOS_schedule ();
+    return ops;
+}
+
+static uint32_t cpp_burst_fill (bench::Random &random)
+{
+    uint32_t ops = 0;
+
+    while (nOS_OK == bench_scheduler.enqueue<1> (bench_task, 1))
+    {
+        ops++;
+    }
+    bench_scheduler.schedule ();
+    return ops;
+}
+
+/**
+ * A random number of tasks at random priorities, the rejected ones are not
+ * counted
+ */
+static uint32_t c_mixed (bench::Random &random)
+{
+    uint32_t ops = 0;
+    uint32_t tasks = 1 + random.below (16);
+
+    while (tasks--)
+    {
+        if (nOS_OK == nOS_task_enqueue (1 + random.below (8), BENCH_TASK, 1))
+        {
+            ops++;
+        }
+    }
+    nOS_schedule ();
+    return ops;
+}
+
+static uint32_t cpp_mixed (bench::Random &random)
+{
+    uint32_t ops = 0;
+    uint32_t tasks = 1 + random.below (16);
+
+    while (tasks--)
+    {
+        if (nOS_OK == bench_scheduler.enqueue (1 + random.below (8), bench_task, 1))
+        {
+            ops++;
+        }
+    }
+    bench_scheduler.schedule ();
+    return ops;
+}
+
+typedef struct
+{
+    const char *name;
+    const char *scheduler;
+    uint32_t (*round) (bench::Random &random);
+} workload_t;
+
+static const workload_t workloads[] =
+{
+{ "single_priority", "c", c_single_priority },
+{ "single_priority", "template", cpp_single_priority },
+{ "all_priorities", "c", c_all_priorities },
+{ "all_priorities", "template", cpp_all_priorities },
+{ "burst_fill", "c", c_burst_fill },
+{ "burst_fill", "template", cpp_burst_fill },
+{ "mixed", "c", c_mixed },
+{ "mixed", "template", cpp_mixed } };
+
+static void run_workload (bench::JsonWriter &json, const workload_t &workload,
+                          uint32_t rounds, double overhead_ns)
+{
+    bench::Random random (BENCH_SEED);
+    bench::Samples samples;
+    uint64_t ops = 0, start, elapsed;
+    uint32_t round_ops;
+
+    nOS_start ();
+    bench_scheduler.start ();
+    // Warm up the caches and the branch predictors
+    for (uint32_t i = 0; i < rounds / 10; i++)
+    {
+        workload.round (random);
+    }
+
+    // Throughput, the rounds are timed as a whole
+    random = bench::Random (BENCH_SEED);
+    start = bench::now_ns ();
+    for (uint32_t i = 0; i < rounds; i++)
+    {
+        ops += workload.round (random);
+    }
+    elapsed = bench::now_ns () - start;
+
+    // Latency, every round is timed and spread over its operations
+    random = bench::Random (BENCH_SEED);
+    samples.reserve (rounds);
+    for (uint32_t i = 0; i < rounds; i++)
+    {
+        start = bench::now_ns ();
+        round_ops = workload.round (random);
+        double ns = (double) (bench::now_ns () - start) - overhead_ns;
+        if (round_ops)
+        {
+            samples.add ((ns > 0 ? ns : 0) / round_ops);
+        }
+    }
+
+    json.begin_result ();
+    json.field ("workload", workload.name);
+    json.field ("scheduler", workload.scheduler);
+    json.field ("rounds", (uint64_t) rounds);
+    json.field ("ops", ops);
+    json.field ("ops_per_sec", (double) ops * 1e9 / (double) elapsed);
+    json.field ("ns_per_op", (double) elapsed / (double) ops);
+    json.field ("p50_ns", samples.percentile (50));
+    json.field ("p99_ns", samples.percentile (99));
+    json.field ("max_ns", samples.max ());
+    json.end_result ();
+}
+
+int main (int argc, char **argv)
+{
+    uint32_t rounds = 200000;
+    double overhead_ns;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (0 == strcmp (argv[i], "--quick"))
+        {
+            rounds = 20000;
+        }
+        else if ((0 == strcmp (argv[i], "--rounds")) && (i + 1 < argc))
+        {
+            rounds = (uint32_t) strtoul (argv[++i], NULL, 0);
+        }
+    }
+#ifdef __linux__
+    // Stay on one CPU so the runs are comparable
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(0, &cpus);
+    sched_setaffinity (0, sizeof(cpus), &cpus);
+#endif
+    overhead_ns = bench::timer_overhead_ns ();
+
+    {
+        bench::JsonWriter json (stdout, "template");
+        json.config ("task_queue_impl",
+                     nOS_TASK_QUEUE_IMPL == nOS_TASK_QUEUE_LOCK_FREE ?
+                             "lock_free" :
+                     nOS_TASK_QUEUE_IMPL == nOS_TASK_QUEUE_POW2 ?
+                             "pow2" : "locked");
+        json.config ("c_task_bytes", (long) sizeof(nOS_task_t));
+        json.config ("template_bytes", (long) sizeof(bench_scheduler));
+        json.config ("seed", (long) BENCH_SEED);
+        json.config ("timer_overhead_ns", (long) overhead_ns);
+        json.config ("compiler", __VERSION__);
+        for (const workload_t &workload : workloads)
+        {
+            run_workload (json, workload, rounds, overhead_ns);
+        }
+    }
+
+    return 0;
+}
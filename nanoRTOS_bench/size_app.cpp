@@ -0,0 +1,48 @@
+/*
+ * size_app.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ *
+ * A minimal application for the code size comparison of make size: a timer
+ * and an ISR post tasks through the C API, served by nanoRTOS.c or, with
+ * SIZE_TEMPLATE, by a nOS::Scheduler through nOS_SCHEDULER_C_API.
+ */
+
+#include "nanoRTOS.hpp"
+
+#if SIZE_TEMPLATE
+static nOS::Scheduler<nOS::Config<nOS_PRIO1_TASK_QUEUE_LENGTH,
+        nOS_PRIO2_TASK_QUEUE_LENGTH, nOS_PRIO3_TASK_QUEUE_LENGTH,
+        nOS_PRIO4_TASK_QUEUE_LENGTH, nOS_PRIO5_TASK_QUEUE_LENGTH,
+        nOS_PRIO6_TASK_QUEUE_LENGTH, nOS_PRIO7_TASK_QUEUE_LENGTH,
+        nOS_PRIO8_TASK_QUEUE_LENGTH> > size_scheduler;
+nOS_SCHEDULER_C_API(size_scheduler)
+#endif
+
+static volatile uint32_t size_sink;
+
+extern "C" void size_task (uint8_t event)
+{
+    size_sink += event;
+}
+
+// Stands in for an ISR of the target
+extern "C" void size_isr (uint8_t byte)
+{
+    nOS_task_enqueue (6, size_task, byte);
+}
+
+int main (void)
+{
+    nOS_start ();
+    nOS_timer_start (1, size_task, 0, 10, 10);
+    for (uint32_t tick = 0; tick < 100; tick++)
+    {
+        size_isr ((uint8_t) tick);
+        nOS_timer_tick ();
+        nOS_schedule ();
+    }
+
+    return (int) (size_sink & 1);
+}
@@ -0,0 +1,265 @@
+/*
+ * posix_demo.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ *
+ * The nanoRTOS on the POSIX port (port/posix), a workstation stand in for
+ * the MCU to profile the scheduler hot paths, e.g. with perf.
+ * IRQ 0 - The 1 ms kernel tick (timerfd).
+ * IRQ 1 - A simulated UART, a peripheral thread writes "bytes" to an eventfd.
+ * IRQ 2 - A user button, kill -s RTMIN+2 <pid> from a shell.
+ * The UART ISR puts a byte per burst in a lock free single producer /
+ * single consumer FIFO (nOS_CREATE_SPSC_QUEUE) and posts the UART task,
+ * which drains it into work tasks. A periodic timer task reports the
+ * counters once a second.
+ * With nOS_TRACE the trace is dumped to a file at the exit, for the decoder of
+ * nanoRTOS_trace, with nOS_QUEUE_PROFILE the queue profile for the tuner of
+ * nanoRTOS_tune.
+ * Usage: posix_demo [--seconds N] [--rate N] [--trace dump.bin]
+ *                   [--profile dump.bin]
+ */
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include "nanoRTOS.h"
+#include "nanoQueue.h"
+#include "nanoTimer.h"
+#include "nanoTrace.h"
+#include "nanoProfile.h"
+
+#define DEMO_TICK_US        1000
+#define DEMO_UART_IRQ       1
+#define DEMO_BUTTON_IRQ     2
+#define DEMO_UART_PRIO      6
+#define DEMO_WORK_PRIO      3
+#define DEMO_REPORT_PRIO    1
+#define DEMO_RX_LENGTH      64
+
+nOS_CREATE_SPSC_QUEUE(demo_rx, uint8_t)
+nOS_INSTALL_SPSC_QUEUE_APIs(demo_rx, uint8_t)
+
+static int demo_uart_fd;
+static volatile int demo_running = 1;
+static uint32_t demo_rate = 10000;       // UART bursts per second
+static uint32_t demo_seconds = 5;
+static uint32_t demo_uart_tasks;
+static uint32_t demo_rx_overruns;
+static demo_rx_t demo_rx;
+static uint8_t demo_rx_buff[DEMO_RX_LENGTH];
+static uint32_t demo_work_tasks;
+static uint32_t demo_buttons;
+static uint32_t demo_reports;
+static const char *demo_trace_path;
+static const char *demo_profile_path;
+
+static void demo_work_task (uint8_t event)
+{
+    volatile uint32_t sink = event;
+    uint32_t i;
+
+    // Some processing of the received bytes
+    for (i = 0; i < 100; i++)
+    {
+        sink += i;
+    }
+    demo_work_tasks++;
+}
+
+static void demo_uart_task (uint8_t event)
+{
+    uint8_t byte;
+
+    // The ISR keeps filling the FIFO meanwhile, with interrupts enabled
+    demo_uart_tasks++;
+    while (nOS_QUEUE_OK == demo_rx_out (&demo_rx, &byte))
+    {
+        nOS_task_enqueue (DEMO_WORK_PRIO, demo_work_task, byte);
+    }
+}
+
+static void demo_report_task (uint8_t event)
+{
+    printf ("%u s: uart tasks %u, work tasks %u, rx overruns %u, buttons %u, "
+            "ticks %u, idle %u\n", ++demo_reports, demo_uart_tasks,
+            demo_work_tasks, demo_rx_overruns, demo_buttons, nOS_timer_now (),
+            port_posix_sleeps ());
+    fflush (stdout);
+    if (demo_reports >= demo_seconds)
+    {
+        demo_running = 0;
+    }
+}
+
+static void demo_uart_isr (void)
+{
+    static uint8_t byte;
+
+    if (nOS_QUEUE_OK != demo_rx_in (&demo_rx, &byte))
+    {
+        demo_rx_overruns++;
+    }
+    byte++;
+    nOS_task_enqueue (DEMO_UART_PRIO, demo_uart_task, 0);
+}
+
+static void demo_button_isr (void)
+{
+    demo_buttons++;
+}
+
+/**
+ * @brief The simulated UART, writes a burst every 1/rate seconds
+ */
+static void *demo_uart (void *arg)
+{
+    uint64_t bytes = 1;
+
+    while (demo_running)
+    {
+        if (sizeof(bytes) != write (demo_uart_fd, &bytes, sizeof(bytes)))
+        {
+            break;
+        }
+        usleep (1000000 / demo_rate);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Writes the trace dump to demo_trace_path
+ */
+static void demo_trace_save (void)
+{
+#if nOS_TRACE
+    static uint8_t dump[nOS_TRACE_DUMP_SIZE];
+    uint32_t size = nOS_trace_dump (dump, sizeof(dump));
+    FILE *file = fopen (demo_trace_path, "wb");
+
+    if ((NULL == file) || (size != fwrite (dump, 1, size, file)))
+    {
+        perror (demo_trace_path);
+    }
+    else
+    {
+        printf ("trace of %u records in %s\n",
+                ((nOS_trace_header_t *) dump)->count_, demo_trace_path);
+    }
+    if (file)
+    {
+        fclose (file);
+    }
+#else
+    fprintf (stderr, "build with -DnOS_TRACE=1 for --trace\n");
+#endif
+}
+
+/**
+ * @brief Writes the queue profile dump to demo_profile_path
+ */
+static void demo_profile_save (void)
+{
+#if nOS_QUEUE_PROFILE
+    static uint8_t dump[nOS_PROFILE_DUMP_SIZE];
+    uint32_t size = nOS_profile_dump (dump, sizeof(dump));
+    FILE *file = fopen (demo_profile_path, "wb");
+
+    if ((NULL == file) || (size != fwrite (dump, 1, size, file)))
+    {
+        perror (demo_profile_path);
+    }
+    else
+    {
+        printf ("queue profile of %u priorities in %s\n",
+                (unsigned) nOS_PRIO_COUNT, demo_profile_path);
+    }
+    if (file)
+    {
+        fclose (file);
+    }
+#else
+    fprintf (stderr, "build with -DnOS_QUEUE_PROFILE=1 for --profile\n");
+#endif
+}
+
+int main (int argc, char **argv)
+{
+    pthread_t uart;
+    sigset_t all;
+    sigset_t old;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if ((0 == strcmp (argv[i], "--seconds")) && (i + 1 < argc))
+        {
+            demo_seconds = (uint32_t) strtoul (argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp (argv[i], "--rate")) && (i + 1 < argc))
+        {
+            demo_rate = (uint32_t) strtoul (argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp (argv[i], "--trace")) && (i + 1 < argc))
+        {
+            demo_trace_path = argv[++i];
+        }
+        else if ((0 == strcmp (argv[i], "--profile")) && (i + 1 < argc))
+        {
+            demo_profile_path = argv[++i];
+        }
+    }
+    if (0 == demo_rate)
+    {
+        demo_rate = 1;
+    }
+
+    nOS_start ();
+    demo_rx_init (&demo_rx, demo_rx_buff, DEMO_RX_LENGTH);
+    demo_uart_fd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if ((0 != port_posix_init ())
+            || (0 != port_posix_irq_attach_fd (DEMO_UART_IRQ, demo_uart_fd,
+                                               demo_uart_isr))
+            || (0 != port_posix_irq_attach (DEMO_BUTTON_IRQ, demo_button_isr))
+            || (0 != port_posix_tick_start (DEMO_TICK_US)))
+    {
+        perror ("posix_demo");
+        return 1;
+    }
+    nOS_timer_start (DEMO_REPORT_PRIO, demo_report_task, 0,
+                     1000000 / DEMO_TICK_US, 1000000 / DEMO_TICK_US);
+    printf ("pid %d, press the button with kill -s RTMIN+%d %d\n",
+            (int) getpid (), DEMO_BUTTON_IRQ, (int) getpid ());
+
+    // The peripheral is not a core, it never takes an IRQ itself
+    sigfillset (&all);
+    pthread_sigmask (SIG_SETMASK, &all, &old);
+    pthread_create (&uart, NULL, demo_uart, NULL);
+    pthread_sigmask (SIG_SETMASK, &old, NULL);
+
+    while (demo_running)
+    {
+        nOS_schedule ();
+#if !nOS_TICKLESS_IDLE
+        port_posix_idle ();
+#endif
+    }
+    pthread_join (uart, NULL);
+    port_posix_deinit ();
+    close (demo_uart_fd);
+    if (demo_trace_path)
+    {
+        demo_trace_save ();
+    }
+    if (demo_profile_path)
+    {
+        demo_profile_save ();
+    }
+
+    return 0;
+}
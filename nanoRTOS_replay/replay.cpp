@@ -0,0 +1,595 @@
+/*
+ * replay.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ *
+ * Deterministic replay of a recorded scheduler workload. The recording is a
+ * trace dump (nOS_trace_dump, nanoTrace.h) of the target or of the POSIX
+ * demo, the replay runs the kernel of this build on the host simulation port
+ * with a virtual cycle counter, so every run of a recording is the same.
+ *
+ * The workload is rebuilt from the records:
+ * - A post made in an ISR (nOS_TRACE_ISR) or outside of any callback is
+ *   external, it is replayed at its recorded time, the ISR posts interrupt
+ *   the callback running then (port_sim_isr), the others wait for the
+ *   scheduler to return as the main loop did.
+ * - A post made by a callback is replayed by the callback, after the same
+ *   number of its own cycles.
+ * - Every callback consumes its recorded own cycles, without the callbacks
+ *   that preempted it.
+ * The posts are matched to their dispatches in FIFO order per priority, the
+ * batch and overflow records carry no size, a batch replays with the events
+ * of its dispatches and an overflowed batch as a single post.
+ *
+ * The report compares the recorded and the replayed dispatch order and the
+ * post to dispatch latency per priority, --strict fails on any difference of
+ * order or drops, e.g. to check that a queue or scheduler change keeps the
+ * behaviour. The virtual clock only moves with the callbacks and the idle
+ * gaps, a replayed latency is the wait behind the other callbacks without
+ * the kernel overhead. A trace of the replay (--trace, with nOS_TRACE) is a
+ * recording of its own, a baseline that replays without any difference on
+ * the same build. Tasks pending when the recording started or ended and
+ * deadline tasks (nOS_task_enqueue_deadline) only keep an approximate order.
+ * Usage: replay [--strict] [--trace replayed.bin] recording.bin
+ */
+
+#include <stdlib.h>
+#include <deque>
+#include "bench.h"
+
+extern "C"
+{
+#include "nanoRTOS.h"
+#include "nanoTrace.h"
+}
+
+#define REPLAY_SLOTS    256     // Tasks in flight, the event is the slot
+
+extern "C" void replay_task (uint8_t event);
+
+#ifdef nOS_TASK_TABLE
+#define REPLAY_TASK     nOS_TASK_ID(replay_task)
+#else
+#define REPLAY_TASK     replay_task
+#endif
+
+// A recorded post, a single task, a batch or a rejected post
+typedef struct
+{
+    uint64_t time;      // The recorded cycles since the first record
+    uint64_t offset;    // The own cycles of the posting callback before it
+    uint16_t prio;
+    uint8_t type;       // nOS_TRACE_ENQUEUE, _ENQUEUE_N or _OVERFLOW
+    uint8_t count;      // The tasks of the post
+    uint32_t first;     // The index of its first task
+} replay_post_t;
+
+// A posted task and what became of it, -1 times if it never happened
+typedef struct
+{
+    uint16_t prio;
+    uint8_t event;
+    bool orphan;        // Posted before the recording started
+    bool dropped;       // Rejected by a full queue when recorded
+    bool replay_dropped;
+    int64_t posted;
+    int64_t started;
+    int64_t replay_posted;
+    int64_t replay_started;
+    uint64_t own;       // The recorded own cycles of its callback
+    std::vector<uint32_t> children; // The posts of its callback
+} replay_task_t;
+
+static std::vector<replay_post_t> replay_posts;
+static std::vector<replay_task_t> replay_tasks;
+// The external posts in recorded order, the ISR posts and the main loop posts
+static std::vector<uint32_t> replay_isr_posts;
+static std::vector<uint32_t> replay_main_posts;
+static size_t replay_isr_next;
+static size_t replay_main_next;
+// The task of every slot in flight and the free slots
+static uint32_t replay_slots[REPLAY_SLOTS];
+static std::vector<uint8_t> replay_free;
+static std::vector<uint32_t> replay_order;
+static uint64_t replay_now;
+static uint32_t replay_cycles_per_us;
+
+/**
+ * @brief A function to rebuild the workload of a recording
+ * @return 0 or -1 if the recording cannot be replayed
+ */
+static int replay_load (const char *path, nOS_trace_header_t *header)
+{
+    // A callback running when recorded, nested ones preempted it
+    typedef struct
+    {
+        uint32_t task;
+        uint64_t started;
+        uint64_t nested;    // The cycles of the callbacks that preempted it
+    } running_t;
+    std::vector<std::deque<uint32_t> > pending;
+    std::vector<running_t> running;
+    std::vector<nOS_trace_record_t> records;
+    FILE *file = fopen (path, "rb");
+    uint64_t time = 0;
+    uint32_t i;
+
+    if ((NULL == file) || (1 != fread (header, sizeof(*header), 1, file)))
+    {
+        perror (path);
+        return -1;
+    }
+    // The dumps are in the byte order of the target, a host of another one
+    // cannot read them
+    if ((nOS_TRACE_MAGIC != header->magic_)
+            || (nOS_TRACE_VERSION != header->version_)
+            || (sizeof(nOS_trace_record_t) != header->record_size_))
+    {
+        fprintf (stderr, "%s: not a version %d trace dump of this byte order\n",
+                 path, nOS_TRACE_VERSION);
+        return -1;
+    }
+    records.resize (header->count_);
+    if (header->count_
+            && (header->count_ != fread (&records[0], sizeof(records[0]),
+                                         header->count_, file)))
+    {
+        fprintf (stderr, "%s: truncated\n", path);
+        return -1;
+    }
+    fclose (file);
+    pending.resize (header->prio_count_ + 1u);
+
+    for (i = 0; i < header->count_; i++)
+    {
+        const nOS_trace_record_t &record = records[i];
+        uint8_t type = record.type_ & ~nOS_TRACE_ISR;
+        bool isr = 0 != (record.type_ & nOS_TRACE_ISR);
+        bool orphan = false;
+
+        if (record.prio_ > header->prio_count_)
+        {
+            fprintf (stderr, "%s: record %u has priority %u\n", path, i,
+                     record.prio_);
+            return -1;
+        }
+        time += i ? (uint32_t) (record.cycles_ - records[i - 1].cycles_) : 0;
+        if ((nOS_TRACE_START == type) && pending[record.prio_].empty ())
+        {
+            // Posted before the first record, the main loop posts it at its
+            // start instead
+            type = nOS_TRACE_ENQUEUE;
+            orphan = true;
+        }
+        switch (type)
+        {
+            case nOS_TRACE_ENQUEUE:
+            case nOS_TRACE_ENQUEUE_N:
+            case nOS_TRACE_OVERFLOW:
+            {
+                replay_post_t post = { time, 0, record.prio_, type, 1,
+                                       (uint32_t) replay_tasks.size () };
+
+                if (nOS_TRACE_ENQUEUE_N == type)
+                {
+                    post.count = record.arg_;
+                }
+                if (!orphan && !isr && !running.empty ())
+                {
+                    running_t &parent = running.back ();
+
+                    post.offset = time - parent.started - parent.nested;
+                    replay_tasks[parent.task].children.push_back (
+                            (uint32_t) replay_posts.size ());
+                }
+                else
+                {
+                    (isr ? replay_isr_posts : replay_main_posts).push_back (
+                            (uint32_t) replay_posts.size ());
+                }
+                replay_tasks.resize (post.first + post.count);
+                for (uint32_t t = post.first; t < post.first + post.count; t++)
+                {
+                    replay_tasks[t].prio = record.prio_;
+                    replay_tasks[t].event = record.arg_;
+                    replay_tasks[t].orphan = orphan;
+                    replay_tasks[t].dropped = (nOS_TRACE_OVERFLOW == type);
+                    replay_tasks[t].posted = (int64_t) time;
+                    replay_tasks[t].started = -1;
+                    replay_tasks[t].replay_posted = -1;
+                    replay_tasks[t].replay_started = -1;
+                    if (nOS_TRACE_OVERFLOW != type)
+                    {
+                        pending[record.prio_].push_back (t);
+                    }
+                }
+                replay_posts.push_back (post);
+                if (!orphan)
+                {
+                    break;
+                }
+            }
+            // no break, an orphan starts at once
+            case nOS_TRACE_START:
+            {
+                running_t run = { pending[record.prio_].front (), time, 0 };
+
+                pending[record.prio_].pop_front ();
+                replay_tasks[run.task].event = record.arg_;
+                replay_tasks[run.task].started = (int64_t) time;
+                running.push_back (run);
+                break;
+            }
+            case nOS_TRACE_END:
+                // The start of the first callback may have been overwritten
+                if (!running.empty ()
+                        && (replay_tasks[running.back ().task].prio == record.prio_))
+                {
+                    running_t run = running.back ();
+
+                    running.pop_back ();
+                    replay_tasks[run.task].own = time - run.started - run.nested;
+                    if (!running.empty ())
+                    {
+                        running.back ().nested += time - run.started;
+                    }
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    // The callbacks still running at the end keep the cycles they had
+    for (size_t r = 0; r < running.size (); r++)
+    {
+        replay_tasks[running[r].task].own = time - running[r].started
+                - running[r].nested;
+    }
+
+    return 0;
+}
+
+static void replay_advance (uint64_t cycles)
+{
+    replay_now += cycles;
+    port_sim_advance_cycles ((uint32_t) cycles);
+}
+
+static void replay_post (uint32_t index)
+{
+    const replay_post_t &post = replay_posts[index];
+    uint8_t events[255];
+    nOS_err_t err;
+    uint32_t i;
+
+    if (replay_free.size () < post.count)
+    {
+        fprintf (stderr, "replay: more than %d tasks in flight\n", REPLAY_SLOTS);
+        exit (1);
+    }
+    for (i = 0; i < post.count; i++)
+    {
+        events[i] = replay_free.back ();
+        replay_free.pop_back ();
+        replay_slots[events[i]] = post.first + i;
+        replay_tasks[post.first + i].replay_posted = (int64_t) replay_now;
+    }
+    if (nOS_TRACE_ENQUEUE_N == post.type)
+    {
+        err = nOS_task_enqueue_batch ((nOS_prio_t) post.prio, REPLAY_TASK,
+                                      events, post.count);
+    }
+    else
+    {
+        err = nOS_task_enqueue ((nOS_prio_t) post.prio, REPLAY_TASK, events[0]);
+    }
+    if (nOS_OK != err)
+    {
+        for (i = post.count; i; i--)
+        {
+            replay_free.push_back (events[i - 1]);
+            replay_tasks[post.first + i - 1].replay_dropped = true;
+        }
+    }
+}
+
+static void replay_isr (void)
+{
+    replay_post (replay_isr_posts[replay_isr_next++]);
+}
+
+/**
+ * @brief Lets a callback run for some of its own cycles, the ISR posts that
+ * fall due meanwhile interrupt it
+ */
+static void replay_run (uint64_t cycles)
+{
+    while (cycles)
+    {
+        uint64_t due;
+
+        if (replay_isr_next >= replay_isr_posts.size ())
+        {
+            replay_advance (cycles);
+            break;
+        }
+        due = replay_posts[replay_isr_posts[replay_isr_next]].time;
+        if (due > replay_now + cycles)
+        {
+            replay_advance (cycles);
+            break;
+        }
+        if (due > replay_now)
+        {
+            cycles -= due - replay_now;
+            replay_advance (due - replay_now);
+        }
+        port_sim_isr (replay_isr);
+    }
+}
+
+/**
+ * @brief The callback of every replayed task, the event is its slot
+ */
+extern "C" void replay_task (uint8_t event)
+{
+    uint32_t index = replay_slots[event];
+    replay_task_t &task = replay_tasks[index];
+    uint64_t own = 0;
+
+    replay_free.push_back (event);
+    replay_order.push_back (index);
+    task.replay_started = (int64_t) replay_now;
+    for (size_t i = 0; i < task.children.size (); i++)
+    {
+        const replay_post_t &post = replay_posts[task.children[i]];
+
+        replay_run (post.offset - own);
+        own = post.offset;
+        replay_post (task.children[i]);
+    }
+    replay_run (task.own - own);
+}
+
+/**
+ * @brief The main loop, the external posts at their time and the scheduler
+ */
+static void replay_main (void)
+{
+    for (;;)
+    {
+        bool isr = replay_isr_next < replay_isr_posts.size ();
+        bool main = replay_main_next < replay_main_posts.size ();
+        uint64_t due;
+
+        if (!isr && !main)
+        {
+            break;
+        }
+        // The earliest one, the ISR first on a tie as it was recorded first
+        // or interrupted the main loop
+        if (isr && (!main || (replay_posts[replay_isr_posts[replay_isr_next]].time
+                <= replay_posts[replay_main_posts[replay_main_next]].time)))
+        {
+            due = replay_posts[replay_isr_posts[replay_isr_next]].time;
+            main = false;
+        }
+        else
+        {
+            due = replay_posts[replay_main_posts[replay_main_next]].time;
+        }
+        // Idle until it is due
+        if (due > replay_now)
+        {
+            replay_advance (due - replay_now);
+        }
+        if (main)
+        {
+            replay_post (replay_main_posts[replay_main_next++]);
+        }
+        else
+        {
+            port_sim_isr (replay_isr);
+        }
+        nOS_schedule ();
+    }
+}
+
+static double replay_us (int64_t cycles)
+{
+    return (double) cycles / replay_cycles_per_us;
+}
+
+#if nOS_TRACE
+static void replay_save_trace (const char *path)
+{
+    static uint8_t dump[nOS_TRACE_DUMP_SIZE];
+    uint32_t size = nOS_trace_dump (dump, sizeof(dump));
+    FILE *file = fopen (path, "wb");
+
+    if ((NULL == file) || (size != fwrite (dump, 1, size, file)))
+    {
+        perror (path);
+    }
+    if (file)
+    {
+        fclose (file);
+    }
+}
+#endif
+
+int main (int argc, char **argv)
+{
+    nOS_trace_header_t header;
+    const char *path = NULL;
+    const char *trace_path = NULL;
+    std::vector<uint32_t> recorded;
+    std::vector<uint32_t> replayed;
+    uint64_t differences = 0;
+    int64_t first_difference = -1;
+    uint64_t drop_differences = 0;
+    bool strict = false;
+    size_t i;
+
+    for (int arg = 1; arg < argc; arg++)
+    {
+        if (0 == strcmp (argv[arg], "--strict"))
+        {
+            strict = true;
+        }
+        else if ((0 == strcmp (argv[arg], "--trace")) && (arg + 1 < argc))
+        {
+            trace_path = argv[++arg];
+        }
+        else
+        {
+            path = argv[arg];
+        }
+    }
+    if (NULL == path)
+    {
+        fprintf (stderr, "usage: %s [--strict] [--trace replayed.bin] recording.bin\n",
+                 argv[0]);
+        return 2;
+    }
+    if (0 != replay_load (path, &header))
+    {
+        return 1;
+    }
+    replay_cycles_per_us = header.cycles_per_us_ ? header.cycles_per_us_ : 1;
+
+    port_sim_reset ();
+    nOS_start ();
+    for (i = REPLAY_SLOTS; i; i--)
+    {
+        replay_free.push_back ((uint8_t) (i - 1));
+    }
+    replay_main ();
+#if nOS_TRACE
+    if (trace_path)
+    {
+        replay_save_trace (trace_path);
+    }
+#else
+    if (trace_path)
+    {
+        fprintf (stderr, "replay: build with CONFIG=-DnOS_TRACE=1 for --trace\n");
+    }
+#endif
+
+    // The order of the tasks dispatched in both
+    for (i = 0; i < replay_tasks.size (); i++)
+    {
+        if (replay_tasks[i].dropped != replay_tasks[i].replay_dropped)
+        {
+            drop_differences++;
+        }
+    }
+    for (i = 0; i < replay_order.size (); i++)
+    {
+        if (replay_tasks[replay_order[i]].started >= 0)
+        {
+            replayed.push_back (replay_order[i]);
+        }
+    }
+    for (i = 0; i < replay_tasks.size (); i++)
+    {
+        if ((replay_tasks[i].started >= 0) && (replay_tasks[i].replay_started >= 0))
+        {
+            recorded.push_back ((uint32_t) i);
+        }
+    }
+    std::stable_sort (recorded.begin (), recorded.end (),
+                      [] (uint32_t a, uint32_t b)
+                      {
+                          return replay_tasks[a].started < replay_tasks[b].started;
+                      });
+    for (i = 0; (i < recorded.size ()) && (i < replayed.size ()); i++)
+    {
+        if (recorded[i] != replayed[i])
+        {
+            differences++;
+            if (first_difference < 0)
+            {
+                first_difference = (int64_t) i;
+            }
+        }
+    }
+
+    {
+        bench::JsonWriter json (stdout, "replay");
+        json.config ("recording", path);
+        json.config ("records", (long) header.count_);
+        json.config ("lost", (long) header.lost_);
+        json.config ("cycles_per_us", (long) replay_cycles_per_us);
+        json.config ("task_queue_impl", (long) nOS_TASK_QUEUE_IMPL);
+        json.config ("preemptive", (long) nOS_PREEMPTIVE);
+        json.config ("aging_credits", (long) nOS_AGING_CREDITS);
+        json.config ("schedule_batch", (long) nOS_SCHEDULE_BATCH);
+        json.config ("compiler", __VERSION__);
+
+        json.begin_result ();
+        json.field ("scope", "all");
+        json.field ("tasks", (uint64_t) replay_tasks.size ());
+        json.field ("compared", (uint64_t) recorded.size ());
+        json.field ("order_differences", (uint64_t) differences);
+        json.field ("first_difference", (double) first_difference);
+        json.field ("drop_differences", (uint64_t) drop_differences);
+        json.end_result ();
+
+        for (nOS_prio_t prio = (nOS_prio_t) header.prio_count_; prio >= 1; prio--)
+        {
+            bench::Samples recorded_wait;
+            bench::Samples replayed_wait;
+            uint64_t posted = 0;
+            uint64_t dropped = 0;
+            uint64_t replay_dropped = 0;
+
+            for (i = 0; i < replay_tasks.size (); i++)
+            {
+                const replay_task_t &task = replay_tasks[i];
+
+                if (task.prio != prio)
+                {
+                    continue;
+                }
+                posted++;
+                dropped += task.dropped;
+                replay_dropped += task.replay_dropped;
+                if (task.orphan)
+                {
+                    continue;
+                }
+                if (task.started >= 0)
+                {
+                    recorded_wait.add (replay_us (task.started - task.posted));
+                }
+                if (task.replay_started >= 0)
+                {
+                    replayed_wait.add (replay_us (task.replay_started
+                            - task.replay_posted));
+                }
+            }
+            if (0 == posted)
+            {
+                continue;
+            }
+            json.begin_result ();
+            json.field ("scope", "prio");
+            json.field ("prio", (uint64_t) prio);
+            json.field ("posted", posted);
+            json.field ("recorded_dispatches", (uint64_t) recorded_wait.size ());
+            json.field ("replayed_dispatches", (uint64_t) replayed_wait.size ());
+            json.field ("recorded_dropped", dropped);
+            json.field ("replayed_dropped", replay_dropped);
+            json.field ("recorded_p50_us", recorded_wait.percentile (50));
+            json.field ("replayed_p50_us", replayed_wait.percentile (50));
+            json.field ("recorded_max_us", recorded_wait.max ());
+            json.field ("replayed_max_us", replayed_wait.max ());
+            json.end_result ();
+        }
+    }
+
+    return (strict && (differences || drop_differences)) ? 1 : 0;
+}
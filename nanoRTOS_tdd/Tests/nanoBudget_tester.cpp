@@ -0,0 +1,173 @@
+/*
+ * nanoBudget_tester.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ */
+
+#include <iostream>
+#include "string.h"
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+extern "C"
+{
+#include "nanoRTOS.h"
+#include "nanoBudget.h"
+#include "nanoPort.h"
+}
+
+#if nOS_BUDGET
+static nOS_task_callback_t overrun_callback;
+static nOS_prio_t overrun_prio;
+static uint32_t overrun_cycles;
+static uint32_t overrun_budget;
+static int overrun_count;
+
+void nOS_budget_overrun (nOS_task_callback_t callback, nOS_prio_t prio,
+                         uint32_t cycles, uint32_t budget)
+{
+    overrun_callback = callback;
+    overrun_prio = prio;
+    overrun_cycles = cycles;
+    overrun_budget = budget;
+    overrun_count++;
+}
+#endif
+
+#if nOS_BUDGET && defined(nOS_PORT_HOST_SIM) && !defined(nOS_TASK_TABLE)
+// The tasks run as many cycles as their event
+static void budget_task_a (uint8_t event)
+{
+    port_sim_advance_cycles (event);
+}
+
+static void budget_task_b (uint8_t event)
+{
+    port_sim_advance_cycles (event);
+}
+
+static void budget_task_c (uint8_t event)
+{
+    port_sim_advance_cycles (event);
+}
+
+static void budget_outer_task (uint8_t event)
+{
+    port_sim_advance_cycles (5);
+    nOS_task_enqueue (6, budget_task_a, 100);
+    // The nested run is left out of this one
+    nOS_schedule ();
+    port_sim_advance_cycles (5);
+}
+
+TEST_GROUP(nanoBudget)
+{
+    void setup ()
+    {
+        overrun_callback = NULL;
+        overrun_count = 0;
+        port_sim_reset ();
+        nOS_start ();
+    }
+    void teardown ()
+    {
+        port_sim_reset ();
+    }
+};
+
+/**
+ * Every callback is measured, its longest and average run
+ */
+TEST(nanoBudget, test_max_and_average)
+{
+    UT_PRINT("test_max_and_average");
+    nOS_budget_stats_t stats;
+
+    LONGS_EQUAL(nOS_BUDGET_ERR, nOS_budget_get (budget_task_a, &stats));
+    nOS_task_enqueue (2, budget_task_a, 10);
+    nOS_task_enqueue (4, budget_task_a, 30);
+    nOS_schedule ();
+    LONGS_EQUAL(nOS_OK, nOS_budget_get (budget_task_a, &stats));
+    POINTERS_EQUAL((void *) budget_task_a, (void *) stats.callback_);
+    LONGS_EQUAL(0, stats.budget_);
+    LONGS_EQUAL(30, stats.max_);
+    LONGS_EQUAL(20, stats.avg_);
+    LONGS_EQUAL(2, stats.count_);
+    LONGS_EQUAL(0, stats.overruns_);
+    LONGS_EQUAL(4, stats.prio_);
+    LONGS_EQUAL(0, overrun_count);
+}
+
+/**
+ * A run longer than the budget calls the overrun hook, a reset keeps the budget
+ */
+TEST(nanoBudget, test_overrun_hook)
+{
+    UT_PRINT("test_overrun_hook");
+    nOS_budget_stats_t stats;
+
+    LONGS_EQUAL(nOS_TASK_ERR, nOS_budget_set (NULL, 15));
+    LONGS_EQUAL(nOS_OK, nOS_budget_set (budget_task_b, 15));
+    nOS_task_enqueue (3, budget_task_b, 15);
+    nOS_task_enqueue (3, budget_task_b, 20);
+    nOS_schedule ();
+    LONGS_EQUAL(1, overrun_count);
+    POINTERS_EQUAL((void *) budget_task_b, (void *) overrun_callback);
+    LONGS_EQUAL(3, overrun_prio);
+    LONGS_EQUAL(20, overrun_cycles);
+    LONGS_EQUAL(15, overrun_budget);
+
+    nOS_budget_reset ();
+    nOS_budget_get (budget_task_b, &stats);
+    LONGS_EQUAL(15, stats.budget_);
+    LONGS_EQUAL(0, stats.count_);
+    LONGS_EQUAL(0, stats.overruns_);
+}
+
+/**
+ * A task run nested in another one is not counted in the outer run
+ */
+TEST(nanoBudget, test_nested_run_left_out)
+{
+    UT_PRINT("test_nested_run_left_out");
+    nOS_budget_stats_t stats;
+
+    nOS_task_enqueue (2, budget_outer_task, 0);
+    nOS_schedule ();
+    nOS_budget_get (budget_outer_task, &stats);
+    LONGS_EQUAL(10, stats.max_);
+    nOS_budget_get (budget_task_a, &stats);
+    LONGS_EQUAL(100, stats.max_);
+}
+
+/**
+ * The report lists the most overruns first, then the longest run
+ */
+TEST(nanoBudget, test_report_worst_offenders)
+{
+    UT_PRINT("test_report_worst_offenders");
+    nOS_budget_stats_t worst[2];
+
+    nOS_budget_set (budget_task_c, 5);
+    nOS_task_enqueue (1, budget_task_a, 50);
+    nOS_task_enqueue (1, budget_task_b, 40);
+    nOS_task_enqueue (1, budget_task_c, 6);
+    nOS_schedule ();
+    LONGS_EQUAL(2, nOS_budget_report (worst, 2));
+    POINTERS_EQUAL((void *) budget_task_c, (void *) worst[0].callback_);
+    LONGS_EQUAL(1, worst[0].overruns_);
+    POINTERS_EQUAL((void *) budget_task_a, (void *) worst[1].callback_);
+    LONGS_EQUAL(0, nOS_budget_untracked ());
+}
+#endif
+
+TEST_GROUP(nanoBudget_tester)
+{
+};
+
+TEST(nanoBudget_tester, nanoBudget_tester)
+{
+    std::cout << std::endl << std::endl
+            << "************************ BUDGET TESTER ************************";
+}
@@ -0,0 +1,431 @@
+/*
+ * nanoCoro_tester.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ */
+
+#include <iostream>
+#include "string.h"
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+#include "nanoCoro.hpp"
+
+#if nOS_CORO && !defined(nOS_TASK_TABLE)
+#define CORO_ACK    0xAC
+
+typedef struct
+{
+    nOS_coro_t coro_;
+    uint8_t i_;
+    uint8_t log_[16];
+    uint8_t count_;
+} test_coro_t;
+
+static test_coro_t coro_a, coro_b;
+static uint8_t coro_order[16];
+static uint8_t coro_order_count;
+
+static void run_ticks (nOS_tick_t ticks)
+{
+    while (ticks--)
+    {
+        nOS_timer_tick ();
+        nOS_schedule ();
+    }
+}
+
+static void fill_task (uint8_t event)
+{
+}
+
+#define CORO_SLOTS_ENTRY(length) nOS_TASK_QUEUE_SLOTS(length),
+static const uint16_t coro_slots[nOS_PRIO_COUNT] =
+{ nOS_TASK_QUEUE_LENGTHS(CORO_SLOTS_ENTRY) };
+
+/**
+ * @brief Fills the queue of a priority, a post more than its slots at most
+ * @return 1 once a post was rejected, 0 if the overflow policy of the
+ * priority keeps taking tasks (then the full queue tests are skipped)
+ */
+static int coro_fill (nOS_prio_t prio)
+{
+    for (int i = 0; i <= coro_slots[prio - 1]; i++)
+    {
+        if (nOS_OK != nOS_task_enqueue (prio, fill_task, 0))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static void coro_log (nOS_coro_t *coro, uint8_t value)
+{
+    test_coro_t *test = (test_coro_t *) coro;
+
+    test->log_[test->count_++ & 0x0F] = value;
+}
+
+// Receives three events and ends
+static void three_events_flow (nOS_coro_t *coro)
+{
+    test_coro_t *test = (test_coro_t *) coro;
+
+    nOS_CORO_BEGIN(coro);
+    for (test->i_ = 0; test->i_ < 3; test->i_++)
+    {
+        nOS_CORO_AWAIT_EVENT(coro);
+        coro_log (coro, coro->event_);
+    }
+    nOS_CORO_END(coro);
+}
+
+// Sends a ping up to three times, each waits 5 ticks for the ack
+static void ping_flow (nOS_coro_t *coro)
+{
+    test_coro_t *test = (test_coro_t *) coro;
+
+    nOS_CORO_BEGIN(coro);
+    for (test->i_ = 0; test->i_ < 3; test->i_++)
+    {
+        nOS_CORO_AWAIT_EVENT_FOR(coro, 5);
+        coro_log (coro, coro->wake_);
+        if ((nOS_CORO_WAKE_EVENT == coro->wake_) && (CORO_ACK == coro->event_))
+        {
+            break;
+        }
+    }
+    nOS_CORO_END(coro);
+}
+
+// Sleeps, then takes the events posted meanwhile without waiting
+static void sleep_flow (nOS_coro_t *coro)
+{
+    nOS_CORO_BEGIN(coro);
+    nOS_CORO_SLEEP(coro, 3);
+    coro_log (coro, coro->wake_);
+    nOS_CORO_AWAIT_EVENT(coro);
+    coro_log (coro, coro->event_);
+    nOS_CORO_AWAIT_MSG(coro);
+    coro_log (coro, *(uint8_t *) coro->msg_);
+    nOS_CORO_END(coro);
+}
+
+// Yields three times, logging its own event in the common order
+static void yield_flow (nOS_coro_t *coro)
+{
+    test_coro_t *test = (test_coro_t *) coro;
+
+    nOS_CORO_BEGIN(coro);
+    for (test->i_ = 0; test->i_ < 3; test->i_++)
+    {
+        coro_order[coro_order_count++ & 0x0F] = (coro == &coro_a.coro_) ? 'a' : 'b';
+        nOS_CORO_YIELD(coro);
+    }
+    nOS_CORO_END(coro);
+}
+
+static void forever_flow (nOS_coro_t *coro)
+{
+    nOS_CORO_BEGIN(coro);
+    for (;;)
+    {
+        nOS_CORO_AWAIT_EVENT_FOR(coro, 2);
+        coro_log (coro, coro->wake_);
+    }
+    nOS_CORO_END(coro);
+}
+
+TEST_GROUP(nanoCoro)
+{
+    void setup ()
+    {
+        nOS_start ();
+        memset (&coro_a, 0, sizeof(coro_a));
+        memset (&coro_b, 0, sizeof(coro_b));
+        memset (coro_order, 0, sizeof(coro_order));
+        coro_order_count = 0;
+    }
+    void teardown ()
+    {
+
+    }
+};
+
+/**
+ * The events posted before the coroutine awaits them are kept in order, the
+ * coroutine ends at nOS_CORO_END
+ */
+TEST(nanoCoro, test_await_events)
+{
+    UT_PRINT("test_await_events");
+    const uint8_t expected[] = { 1, 2, 3 };
+
+    CHECK_EQUAL(nOS_TASK_ERR, nOS_coro_start (&coro_a.coro_, 1, NULL));
+    CHECK_EQUAL(nOS_PRIORITY_ERR, nOS_coro_start (&coro_a.coro_, 0, three_events_flow));
+    CHECK_EQUAL(nOS_CORO_ERR, nOS_coro_post (&coro_a.coro_, 1));
+    CHECK_EQUAL(nOS_OK, nOS_coro_start (&coro_a.coro_, 2, three_events_flow));
+    CHECK_EQUAL(nOS_CORO_ERR, nOS_coro_start (&coro_a.coro_, 2, three_events_flow));
+    CHECK_EQUAL(nOS_OK, nOS_coro_post (&coro_a.coro_, 1));
+    nOS_schedule ();
+    LONGS_EQUAL(1, coro_a.count_);
+    CHECK_EQUAL(nOS_OK, nOS_coro_post (&coro_a.coro_, 2));
+    CHECK_EQUAL(nOS_OK, nOS_coro_post (&coro_a.coro_, 3));
+    CHECK(nOS_coro_running (&coro_a.coro_));
+    nOS_schedule ();
+    MEMCMP_EQUAL(expected, coro_a.log_, sizeof(expected));
+    CHECK(!nOS_coro_running (&coro_a.coro_));
+    CHECK_EQUAL(nOS_CORO_ERR, nOS_coro_post (&coro_a.coro_, 4));
+}
+
+/**
+ * A full mailbox rejects the post, a coroutine holds a single message
+ */
+TEST(nanoCoro, test_mailbox_full)
+{
+    UT_PRINT("test_mailbox_full");
+    uint8_t payload = 7;
+
+    nOS_coro_start (&coro_a.coro_, 1, sleep_flow);
+    nOS_schedule ();
+    for (int i = 0; i < nOS_CORO_EVENTS; i++)
+    {
+        CHECK_EQUAL(nOS_OK, nOS_coro_post (&coro_a.coro_, (uint8_t) i));
+    }
+    CHECK_EQUAL(nOS_TASK_QUEUE_ERR, nOS_coro_post (&coro_a.coro_, 9));
+    CHECK_EQUAL(nOS_OK, nOS_coro_post_msg (&coro_a.coro_, &payload));
+    CHECK_EQUAL(nOS_TASK_QUEUE_ERR, nOS_coro_post_msg (&coro_a.coro_, &payload));
+    nOS_coro_kill (&coro_a.coro_);
+    CHECK_EQUAL(nOS_CORO_ERR, nOS_coro_kill (&coro_a.coro_));
+}
+
+/**
+ * An await with a timeout resumes on whichever comes first, a timeout that
+ * was cancelled does not resume the next wait
+ */
+TEST(nanoCoro, test_timeout_and_retry)
+{
+    UT_PRINT("test_timeout_and_retry");
+    const uint8_t expected[] = { nOS_CORO_WAKE_TIMEOUT, nOS_CORO_WAKE_EVENT,
+            nOS_CORO_WAKE_EVENT };
+
+    nOS_coro_start (&coro_a.coro_, 3, ping_flow);
+    nOS_schedule ();
+    run_ticks (4);
+    LONGS_EQUAL(0, coro_a.count_);
+    run_ticks (1);
+    LONGS_EQUAL(1, coro_a.count_);
+    // Not the ack, the retry goes on waiting for it
+    run_ticks (2);
+    nOS_coro_post (&coro_a.coro_, 0x55);
+    nOS_schedule ();
+    LONGS_EQUAL(2, coro_a.count_);
+    run_ticks (4);
+    nOS_coro_post (&coro_a.coro_, CORO_ACK);
+    nOS_schedule ();
+    LONGS_EQUAL(sizeof(expected), coro_a.count_);
+    MEMCMP_EQUAL(expected, coro_a.log_, sizeof(expected));
+    CHECK(!nOS_coro_running (&coro_a.coro_));
+    run_ticks (10);
+    LONGS_EQUAL(sizeof(expected), coro_a.count_);
+}
+
+/**
+ * A timeout that finds the task queue of the coroutine full still resumes it,
+ * on a later tick
+ */
+TEST(nanoCoro, test_timeout_queue_full)
+{
+    UT_PRINT("test_timeout_queue_full");
+    uint32_t failures = nOS_timer_post_failures ();
+
+    nOS_coro_start (&coro_a.coro_, 3, ping_flow);
+    nOS_schedule ();
+    run_ticks (4);
+    if (!coro_fill (3))
+    {
+        return;
+    }
+    nOS_timer_tick ();
+    nOS_schedule ();
+    LONGS_EQUAL(failures + 1, nOS_timer_post_failures ());
+    LONGS_EQUAL(0, coro_a.count_);
+    run_ticks (1);
+    LONGS_EQUAL(1, coro_a.count_);
+    LONGS_EQUAL(nOS_CORO_WAKE_TIMEOUT, coro_a.log_[0]);
+    nOS_coro_kill (&coro_a.coro_);
+}
+
+/**
+ * A sleep is not cut short by the posts, they are taken after it
+ */
+TEST(nanoCoro, test_sleep_keeps_posts)
+{
+    UT_PRINT("test_sleep_keeps_posts");
+    uint8_t payload = 42;
+    const uint8_t expected[] = { nOS_CORO_WAKE_TIMEOUT, 9, 42 };
+
+    nOS_coro_start (&coro_a.coro_, 1, sleep_flow);
+    nOS_schedule ();
+    nOS_coro_post (&coro_a.coro_, 9);
+    nOS_coro_post_msg (&coro_a.coro_, &payload);
+    nOS_schedule ();
+    run_ticks (2);
+    LONGS_EQUAL(0, coro_a.count_);
+    run_ticks (1);
+    MEMCMP_EQUAL(expected, coro_a.log_, sizeof(expected));
+    CHECK(!nOS_coro_running (&coro_a.coro_));
+}
+
+/**
+ * The coroutines of a priority take turns at their yields
+ */
+TEST(nanoCoro, test_yield_round_robin)
+{
+    UT_PRINT("test_yield_round_robin");
+    const uint8_t expected[] = { 'a', 'b', 'a', 'b', 'a', 'b' };
+
+    nOS_coro_start (&coro_a.coro_, 2, yield_flow);
+    nOS_coro_start (&coro_b.coro_, 2, yield_flow);
+    nOS_schedule ();
+    LONGS_EQUAL(sizeof(expected), coro_order_count);
+    MEMCMP_EQUAL(expected, coro_order, sizeof(expected));
+    CHECK(!nOS_coro_running (&coro_a.coro_));
+    CHECK(!nOS_coro_running (&coro_b.coro_));
+}
+
+/**
+ * All the slots can run at once, a killed coroutine frees its slot and its
+ * timer
+ */
+TEST(nanoCoro, test_slots_and_kill)
+{
+    UT_PRINT("test_slots_and_kill");
+    static test_coro_t coros[nOS_CORO_SLOTS];
+
+    memset (coros, 0, sizeof(coros));
+    for (int i = 0; i < nOS_CORO_SLOTS; i++)
+    {
+        CHECK_EQUAL(nOS_OK, nOS_coro_start (&coros[i].coro_, 1, three_events_flow));
+        nOS_schedule ();
+    }
+    CHECK_EQUAL(nOS_CORO_ERR, nOS_coro_start (&coro_a.coro_, 1, forever_flow));
+    CHECK_EQUAL(nOS_OK, nOS_coro_kill (&coros[3].coro_));
+    CHECK_EQUAL(nOS_OK, nOS_coro_start (&coro_a.coro_, 1, forever_flow));
+    nOS_schedule ();
+    run_ticks (2);
+    LONGS_EQUAL(1, coro_a.count_);
+    nOS_coro_kill (&coro_a.coro_);
+    run_ticks (4);
+    LONGS_EQUAL(1, coro_a.count_);
+    // The flows in the other slots were kept
+    nOS_coro_post (&coros[0].coro_, 5);
+    nOS_schedule ();
+    LONGS_EQUAL(5, coros[0].log_[0]);
+    for (int i = 0; i < nOS_CORO_SLOTS; i++)
+    {
+        nOS_coro_kill (&coros[i].coro_);
+    }
+}
+
+#if defined(__cpp_impl_coroutine)
+static nOS::Coro cpp_coro;
+static uint8_t cpp_log[8];
+static int cpp_count;
+
+// The locals stay in the frame across the awaits
+static nOS::Task cpp_ping_flow (uint8_t retries)
+{
+    for (uint8_t tries = 0; tries < retries; tries++)
+    {
+        nOS::Wake wake = co_await nOS::event_for (5);
+        cpp_log[cpp_count++ & 0x07] = wake ? wake.event : tries;
+        if (wake && (CORO_ACK == wake.event))
+        {
+            break;
+        }
+    }
+    nOS::Wake wake = co_await nOS::msg ();
+    cpp_log[cpp_count++ & 0x07] = *(uint8_t *) wake.msg;
+    co_await nOS::sleep (2);
+    cpp_log[cpp_count++ & 0x07] = 0xEE;
+}
+
+static nOS::Task cpp_forever_flow (void)
+{
+    for (;;)
+    {
+        co_await nOS::event ();
+        cpp_log[cpp_count++ & 0x07] = 1;
+    }
+}
+
+TEST_GROUP(nanoCoro_cpp)
+{
+    void setup ()
+    {
+        nOS_start ();
+        memset (cpp_log, 0, sizeof(cpp_log));
+        cpp_count = 0;
+    }
+    void teardown ()
+    {
+
+    }
+};
+
+/**
+ * A C++ flow awaits timeouts, events, messages and sleeps and ends by
+ * returning
+ */
+TEST(nanoCoro_cpp, test_cpp_flow)
+{
+    UT_PRINT("test_cpp_flow");
+    uint8_t payload = 0x42;
+    const uint8_t expected[] = { 0, CORO_ACK, 0x42, 0xEE };
+
+    CHECK_EQUAL(nOS_OK, cpp_coro.start (4, cpp_ping_flow (3)));
+    CHECK_EQUAL(nOS_CORO_ERR, cpp_coro.start (4, cpp_ping_flow (3)));
+    nOS_schedule ();
+    run_ticks (5);
+    LONGS_EQUAL(1, cpp_count);
+    cpp_coro.post (CORO_ACK);
+    cpp_coro.post_msg (&payload);
+    nOS_schedule ();
+    LONGS_EQUAL(3, cpp_count);
+    run_ticks (2);
+    MEMCMP_EQUAL(expected, cpp_log, sizeof(expected));
+    CHECK(!cpp_coro.running ());
+    CHECK_EQUAL(nOS_CORO_ERR, cpp_coro.post (1));
+}
+
+/**
+ * A flow that never returns is ended by kill
+ */
+TEST(nanoCoro_cpp, test_cpp_kill)
+{
+    UT_PRINT("test_cpp_kill");
+    cpp_coro.start (4, cpp_forever_flow ());
+    nOS_schedule ();
+    cpp_coro.post (1);
+    nOS_schedule ();
+    LONGS_EQUAL(1, cpp_count);
+    CHECK_EQUAL(nOS_OK, cpp_coro.kill ());
+    CHECK_EQUAL(nOS_CORO_ERR, cpp_coro.kill ());
+    CHECK_EQUAL(nOS_CORO_ERR, cpp_coro.post (1));
+}
+#endif
+#endif
+
+TEST_GROUP(nanoCoro_tester)
+{
+};
+
+TEST(nanoCoro_tester, nanoCoro_tester)
+{
+    std::cout << std::endl << std::endl
+            << "************************ CORO TESTER ************************";
+}
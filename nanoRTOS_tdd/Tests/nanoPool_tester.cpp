@@ -0,0 +1,306 @@
+/*
+ * nanoPool_tester.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ */
+
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "string.h"
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+extern "C"
+{
+#include "nanoRTOS.h"
+#include "nanoPool.h"
+}
+
+#if nOS_MSG_POOL && !defined(nOS_TASK_TABLE)
+#define POOL_STRESS_THREADS 4
+#define POOL_STRESS_ROUNDS  100000
+
+static uint32_t msg_task_calls;
+static uint32_t msg_task_sum;
+static void *msg_task_msg;
+
+static void msg_task (void *msg)
+{
+    msg_task_calls++;
+    msg_task_msg = msg;
+    msg_task_sum += ((uint32_t *) msg)[0];
+}
+
+static void msg_forward_task (void *msg)
+{
+    // Hand the block over to the next task instead of releasing it
+    ((uint32_t *) msg)[0]++;
+    nOS_task_post_msg (2, msg_task, msg);
+}
+
+static void *msg_nested_taken;
+
+static void msg_nested_task (void *msg)
+{
+    // Hand the block over, its dispatch runs and frees it before this returns
+    nOS_task_post_msg (5, msg_task, msg);
+    nOS_schedule ();
+    // Somebody else gets the block meanwhile
+    msg_nested_taken = nOS_pool_alloc (1);
+}
+
+static void fill_task (uint8_t event)
+{
+}
+
+#define POOL_SLOTS_ENTRY(length) nOS_TASK_QUEUE_SLOTS(length),
+static const uint16_t pool_slots[nOS_PRIO_COUNT] =
+{ nOS_TASK_QUEUE_LENGTHS(POOL_SLOTS_ENTRY) };
+
+/**
+ * @brief Fills the queue of a priority, a post more than its slots at most
+ * @return 1 once a post was rejected, 0 if the overflow policy of the
+ * priority keeps taking tasks (then the full queue tests are skipped)
+ */
+static int pool_fill (nOS_prio_t prio)
+{
+    for (int i = 0; i <= pool_slots[prio - 1]; i++)
+    {
+        if (nOS_OK != nOS_task_enqueue (prio, fill_task, 0))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static uint16_t pool_used (uint8_t pool_class)
+{
+    nOS_pool_stats_t stats;
+
+    nOS_pool_stats_get (pool_class, &stats);
+    return stats.used_;
+}
+
+TEST_GROUP(nanoPool)
+{
+    void setup ()
+    {
+        msg_task_calls = 0;
+        msg_task_sum = 0;
+        msg_task_msg = NULL;
+        msg_nested_taken = NULL;
+        nOS_start ();
+    }
+    void teardown ()
+    {
+
+    }
+};
+
+/**
+ * A block comes from the smallest class it fits in, then from the larger
+ * classes once that class is empty
+ */
+TEST(nanoPool, test_alloc_smallest_class_then_larger)
+{
+    UT_PRINT("test_alloc_smallest_class_then_larger");
+    nOS_pool_stats_t small, large;
+    void *msg;
+
+    nOS_pool_stats_get (0, &small);
+    for (int i = 0; i < small.blocks_; i++)
+    {
+        msg = nOS_pool_alloc (small.block_size_);
+        CHECK_TRUE(NULL != msg);
+        LONGS_EQUAL(0, (uintptr_t) msg & 7);
+    }
+    LONGS_EQUAL(small.blocks_, pool_used (0));
+    LONGS_EQUAL(0, pool_used (1));
+    // Spills over to the next class
+    CHECK_TRUE(NULL != nOS_pool_alloc (1));
+    LONGS_EQUAL(1, pool_used (1));
+
+    nOS_pool_stats_get (0, &small);
+    LONGS_EQUAL(1, small.failures_);
+    LONGS_EQUAL(small.blocks_, small.high_water_);
+
+    nOS_pool_stats_get (nOS_POOL_CLASS_COUNT - 1, &large);
+    CHECK_TRUE(NULL == nOS_pool_alloc (large.block_size_ + 1));
+    LONGS_EQUAL(nOS_POOL_ERR, nOS_pool_stats_get (nOS_POOL_CLASS_COUNT, &large));
+}
+
+/**
+ * Freed blocks are reused, pointers that are not pool blocks are rejected
+ */
+TEST(nanoPool, test_free_and_reuse)
+{
+    UT_PRINT("test_free_and_reuse");
+    uint32_t not_a_block;
+    nOS_pool_stats_t stats;
+    uint8_t *msg = (uint8_t *) nOS_pool_alloc (4);
+    uint8_t *other;
+
+    LONGS_EQUAL(nOS_OK, nOS_pool_free (msg));
+    LONGS_EQUAL(0, pool_used (0));
+    POINTERS_EQUAL(msg, nOS_pool_alloc (4));
+
+    LONGS_EQUAL(nOS_POOL_ERR, nOS_pool_free (&not_a_block));
+    LONGS_EQUAL(nOS_POOL_ERR, nOS_pool_free (msg + 1));
+    LONGS_EQUAL(nOS_POOL_ERR, nOS_pool_free (NULL));
+    // A second free is rejected and the block is not handed out twice
+    LONGS_EQUAL(nOS_OK, nOS_pool_free (msg));
+    LONGS_EQUAL(nOS_POOL_ERR, nOS_pool_free (msg));
+    LONGS_EQUAL(0, pool_used (0));
+    LONGS_EQUAL(nOS_POOL_ERR, nOS_task_post_msg (3, msg_task, msg));
+    POINTERS_EQUAL(msg, nOS_pool_alloc (4));
+    other = (uint8_t *) nOS_pool_alloc (4);
+    CHECK_TRUE(msg != other);
+    LONGS_EQUAL(2, pool_used (0));
+    nOS_pool_free (other);
+
+    nOS_pool_free (msg);
+    nOS_pool_stats_reset ();
+    nOS_pool_stats_get (0, &stats);
+    LONGS_EQUAL(0, stats.high_water_);
+    LONGS_EQUAL(0, stats.failures_);
+}
+
+/**
+ * The callback receives the block itself and the block is freed once the
+ * callback returned
+ */
+TEST(nanoPool, test_post_msg_zero_copy)
+{
+    UT_PRINT("test_post_msg_zero_copy");
+    uint32_t *msg = (uint32_t *) nOS_pool_alloc (sizeof(uint32_t));
+
+    msg[0] = 0x12345678;
+    LONGS_EQUAL(nOS_OK, nOS_task_post_msg (3, msg_task, msg));
+    LONGS_EQUAL(1, pool_used (0));
+    nOS_schedule ();
+    LONGS_EQUAL(1, msg_task_calls);
+    POINTERS_EQUAL(msg, msg_task_msg);
+    LONGS_EQUAL(0x12345678, msg_task_sum);
+    LONGS_EQUAL(0, pool_used (0));
+}
+
+/**
+ * A callback posting its block again hands it over, the last task frees it
+ */
+TEST(nanoPool, test_post_msg_forward)
+{
+    UT_PRINT("test_post_msg_forward");
+    uint32_t *msg = (uint32_t *) nOS_pool_alloc (sizeof(uint32_t));
+
+    msg[0] = 1;
+    nOS_task_post_msg (5, msg_forward_task, msg);
+    nOS_schedule ();
+    LONGS_EQUAL(1, msg_task_calls);
+    LONGS_EQUAL(2, msg_task_sum);
+    LONGS_EQUAL(0, pool_used (0));
+}
+
+/**
+ * A block handed over by its callback is not freed again when the callback
+ * returns, even though its new task already ran and freed it
+ */
+TEST(nanoPool, test_post_msg_forward_nested)
+{
+    UT_PRINT("test_post_msg_forward_nested");
+    uint32_t *msg = (uint32_t *) nOS_pool_alloc (sizeof(uint32_t));
+
+    msg[0] = 7;
+    nOS_task_post_msg (2, msg_nested_task, msg);
+    nOS_schedule ();
+    LONGS_EQUAL(1, msg_task_calls);
+    LONGS_EQUAL(7, msg_task_sum);
+    // The block was reused, it is still taken
+    POINTERS_EQUAL(msg, msg_nested_taken);
+    LONGS_EQUAL(1, pool_used (0));
+    CHECK_TRUE(msg != nOS_pool_alloc (1));
+    LONGS_EQUAL(nOS_OK, nOS_pool_free (msg));
+    LONGS_EQUAL(nOS_POOL_ERR, nOS_pool_free (msg));
+}
+
+/**
+ * A rejected post leaves the block with the caller
+ */
+TEST(nanoPool, test_post_msg_errors)
+{
+    UT_PRINT("test_post_msg_errors");
+    uint32_t not_a_block;
+    void *msg = nOS_pool_alloc (1);
+
+    LONGS_EQUAL(nOS_POOL_ERR, nOS_task_post_msg (1, msg_task, &not_a_block));
+    LONGS_EQUAL(nOS_TASK_ERR, nOS_task_post_msg (1, NULL, msg));
+    LONGS_EQUAL(nOS_PRIORITY_ERR, nOS_task_post_msg (0, msg_task, msg));
+    if (!pool_fill (8))
+    {
+        return;
+    }
+    LONGS_EQUAL(nOS_TASK_QUEUE_ERR, nOS_task_post_msg (8, msg_task, msg));
+    nOS_schedule ();
+    LONGS_EQUAL(0, msg_task_calls);
+    LONGS_EQUAL(1, pool_used (0));
+    LONGS_EQUAL(nOS_OK, nOS_pool_free (msg));
+}
+
+/**
+ * Threads racing on the same class never get the same block twice
+ */
+TEST(nanoPool, test_alloc_free_stress)
+{
+    UT_PRINT("test_alloc_free_stress");
+    std::vector<std::thread> threads;
+    uint32_t errors[POOL_STRESS_THREADS] = { 0 };
+
+    for (uint32_t t = 0; t < POOL_STRESS_THREADS; t++)
+    {
+        threads.emplace_back ([t, &errors]()
+        {
+            for (uint32_t i = 0; i < POOL_STRESS_ROUNDS; i++)
+            {
+                volatile uint32_t *msg = (volatile uint32_t *) nOS_pool_alloc (1);
+                if (NULL == msg)
+                {
+                    continue;
+                }
+                msg[0] = t;
+                msg[1] = i;
+                std::this_thread::yield ();
+                if ((msg[0] != t) || (msg[1] != i))
+                {
+                    errors[t]++;
+                }
+                nOS_pool_free ((void *) msg);
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join ();
+    }
+    for (uint32_t t = 0; t < POOL_STRESS_THREADS; t++)
+    {
+        LONGS_EQUAL(0, errors[t]);
+    }
+    for (uint8_t c = 0; c < nOS_POOL_CLASS_COUNT; c++)
+    {
+        LONGS_EQUAL(0, pool_used (c));
+    }
+}
+#endif
+
+TEST_GROUP(nanoPool_tester)
+{
+};
+
+TEST(nanoPool_tester, nanoPool_tester)
+{
+    std::cout << std::endl << std::endl
+            << "************************ POOL TESTER ************************";
+}
@@ -0,0 +1,210 @@
+/*
+ * nanoPort_posix_tester.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ *
+ * POSIX port tests, the test thread is the kernel thread.
+ */
+
+#include <iostream>
+#include <thread>
+#include "string.h"
+#include "unistd.h"
+#include "sys/eventfd.h"
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+extern "C"
+{
+#include "nanoRTOS.h"
+#include "nanoTimer.h"
+}
+
+#if defined(nOS_PORT_POSIX) && !defined(nOS_TASK_TABLE)
+#define POSIX_TEST_IRQ      1
+#define POSIX_TEST_FD_IRQ   2
+#define POSIX_WAIT_LOOPS    1000
+
+static volatile uint32_t posix_isr_calls;
+static volatile uint32_t posix_task_calls;
+
+static void posix_task (uint8_t event)
+{
+    posix_task_calls++;
+}
+
+static void posix_last_task (uint8_t event)
+{
+    posix_task_calls++;
+    // The last task, nothing shall wake the tickless idle anymore
+    port_posix_tick_stop ();
+}
+
+static void posix_isr (void)
+{
+    posix_isr_calls++;
+    nOS_task_enqueue (3, posix_task, 0);
+}
+
+TEST_GROUP(nanoPort_posix)
+{
+    void setup ()
+    {
+        posix_isr_calls = 0;
+        posix_task_calls = 0;
+        nOS_start ();
+        LONGS_EQUAL(0, port_posix_init ());
+    }
+    void teardown ()
+    {
+        port_posix_deinit ();
+    }
+};
+
+/**
+ * An IRQ raised while the interrupts are locked runs once they are unlocked,
+ * its ISR posts a task as an MCU interrupt would
+ */
+TEST(nanoPort_posix, test_lock_defers_irq)
+{
+    UT_PRINT("test_lock_defers_irq");
+
+    LONGS_EQUAL(0, port_posix_irq_attach (POSIX_TEST_IRQ, posix_isr));
+    nOS_INTERRUPTS_LOCK();
+    nOS_INTERRUPTS_LOCK();
+    port_posix_irq_raise (POSIX_TEST_IRQ);
+    nOS_INTERRUPTS_UNLOCK();
+    LONGS_EQUAL(0, posix_isr_calls);
+    nOS_INTERRUPTS_UNLOCK();
+    LONGS_EQUAL(1, posix_isr_calls);
+    LONGS_EQUAL(1, port_posix_irq_count (POSIX_TEST_IRQ));
+    // Nothing shall wake the tickless idle once the task ran
+    port_posix_irq_attach (POSIX_TEST_IRQ, NULL);
+    nOS_schedule ();
+    LONGS_EQUAL(1, posix_task_calls);
+}
+
+/**
+ * A write to an eventfd by another thread wakes the idle kernel and runs the
+ * ISR of the fd, several writes before the ISR ran are one IRQ
+ */
+TEST(nanoPort_posix, test_eventfd_irq_wakes_idle)
+{
+    UT_PRINT("test_eventfd_irq_wakes_idle");
+    int fd = eventfd (0, EFD_NONBLOCK);
+    uint64_t one = 1;
+    int loops = 0;
+
+    LONGS_EQUAL(0, port_posix_irq_attach_fd (POSIX_TEST_FD_IRQ, fd, posix_isr));
+    nOS_INTERRUPTS_LOCK();
+    std::thread peripheral ([fd, one]()
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            LONGS_EQUAL(sizeof(one), write (fd, &one, sizeof(one)));
+        }
+    });
+    peripheral.join ();
+    // Give the poller the time to raise all the edges it saw
+    usleep (10000);
+    nOS_INTERRUPTS_UNLOCK();
+    while ((0 == posix_isr_calls) && (loops++ < POSIX_WAIT_LOOPS))
+    {
+        port_posix_idle ();
+    }
+    LONGS_EQUAL(1, posix_isr_calls);
+    // Nothing shall wake the tickless idle once the task ran
+    port_posix_irq_attach (POSIX_TEST_FD_IRQ, NULL);
+    nOS_schedule ();
+    LONGS_EQUAL(1, posix_task_calls);
+    close (fd);
+}
+
+/**
+ * The timerfd tick drives the kernel timers
+ */
+TEST(nanoPort_posix, test_tick_expires_timer)
+{
+    UT_PRINT("test_tick_expires_timer");
+    nOS_tick_t start = nOS_timer_now ();
+    int loops = 0;
+
+    LONGS_EQUAL(0, port_posix_tick_start (1000));
+    CHECK_TRUE(nOS_TIMER_INVALID != nOS_timer_start (4, posix_last_task, 0, 5, 0));
+    while ((0 == posix_task_calls) && (loops++ < POSIX_WAIT_LOOPS))
+    {
+#if !nOS_TICKLESS_IDLE
+        port_posix_idle ();
+#endif
+        nOS_schedule ();
+    }
+    LONGS_EQUAL(1, posix_task_calls);
+    CHECK_TRUE(nOS_timer_now () - start >= 5);
+    CHECK_TRUE(port_posix_irq_count (PORT_POSIX_TICK_IRQ) > 0);
+}
+
+#if nOS_PREEMPTIVE
+static uint32_t posix_seen_by_low;
+
+static void posix_low_task (uint8_t event)
+{
+    // The signal is delivered to the kernel thread before the raise returns
+    port_posix_irq_raise (POSIX_TEST_IRQ);
+    posix_seen_by_low = posix_task_calls;
+    // Nothing shall wake the tickless idle once the task ran
+    port_posix_irq_attach (POSIX_TEST_IRQ, NULL);
+}
+
+/**
+ * The task an ISR posted runs at the ISR exit, in the middle of the lower
+ * priority task the signal interrupted
+ */
+TEST(nanoPort_posix, test_signal_preempts_task)
+{
+    UT_PRINT("test_signal_preempts_task");
+
+    posix_seen_by_low = 0;
+    LONGS_EQUAL(0, port_posix_irq_attach (POSIX_TEST_IRQ, posix_isr));
+    nOS_task_enqueue (1, posix_low_task, 0);
+    nOS_schedule ();
+    LONGS_EQUAL(1, posix_isr_calls);
+    LONGS_EQUAL(1, posix_seen_by_low);
+    LONGS_EQUAL(1, posix_task_calls);
+}
+#endif
+
+#if nOS_TICKLESS_IDLE
+/**
+ * The kernel sleeps through the ticks up to the next timer and still counts
+ * them
+ */
+TEST(nanoPort_posix, test_tickless_sleep)
+{
+    UT_PRINT("test_tickless_sleep");
+    nOS_tick_t start = nOS_timer_now ();
+    int loops = 0;
+
+    LONGS_EQUAL(0, port_posix_tick_start (1000));
+    nOS_timer_start (4, posix_last_task, 0, 50, 0);
+    while ((0 == posix_task_calls) && (loops++ < POSIX_WAIT_LOOPS))
+    {
+        nOS_schedule ();
+    }
+    LONGS_EQUAL(1, posix_task_calls);
+    CHECK_TRUE(nOS_timer_now () - start >= 50);
+    // A few wake ups rather than one per tick
+    CHECK_TRUE(port_posix_sleeps () < 10);
+}
+#endif
+#endif
+
+TEST_GROUP(nanoPort_posix_tester)
+{
+};
+
+TEST(nanoPort_posix_tester, nanoPort_posix_tester)
+{
+    std::cout << std::endl << std::endl
+            << "************************ POSIX PORT TESTER ************************";
+}
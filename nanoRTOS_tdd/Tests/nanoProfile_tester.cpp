@@ -0,0 +1,126 @@
+/*
+ * nanoProfile_tester.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ */
+
+#include <iostream>
+#include "string.h"
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+extern "C"
+{
+#include "nanoRTOS.h"
+#include "nanoProfile.h"
+}
+
+#if nOS_QUEUE_PROFILE && !defined(nOS_TASK_TABLE)
+#define PROFILE_SLOTS_ENTRY(length) nOS_TASK_QUEUE_SLOTS(length),
+static const uint16_t profile_slots[nOS_PRIO_COUNT] =
+{ nOS_TASK_QUEUE_LENGTHS(PROFILE_SLOTS_ENTRY) };
+
+static void profile_task (uint8_t event)
+{
+}
+
+TEST_GROUP(nanoProfile)
+{
+    void setup ()
+    {
+        nOS_start ();
+    }
+    void teardown ()
+    {
+
+    }
+};
+
+/**
+ * The peak is the most tasks queued at once, the posts are all counted
+ */
+TEST(nanoProfile, test_peak_and_posts)
+{
+    UT_PRINT("test_peak_and_posts");
+    const uint8_t batch[] = { 1, 2, 3 };
+    nOS_profile_entry_t entry;
+
+    CHECK_EQUAL(nOS_PRIORITY_ERR, nOS_profile_get (0, &entry));
+    CHECK_EQUAL(nOS_PRIORITY_ERR, nOS_profile_get (nOS_PRIO_COUNT + 1, &entry));
+    nOS_task_enqueue (1, profile_task, 0);
+    nOS_task_enqueue (1, profile_task, 0);
+    nOS_schedule ();
+    nOS_task_enqueue_batch (1, profile_task, batch, sizeof(batch));
+    nOS_task_enqueue (1, profile_task, 0);
+    nOS_schedule ();
+    nOS_task_enqueue (1, profile_task, 0);
+    nOS_schedule ();
+    CHECK_EQUAL(nOS_OK, nOS_profile_get (1, &entry));
+    LONGS_EQUAL(profile_slots[0], entry.capacity_);
+    LONGS_EQUAL(4, entry.peak_);
+    LONGS_EQUAL(7, entry.enqueued_);
+    LONGS_EQUAL(0, entry.overflows_);
+}
+
+/**
+ * A full queue is flagged, its peak is its capacity
+ */
+TEST(nanoProfile, test_overflow_flagged)
+{
+    UT_PRINT("test_overflow_flagged");
+    nOS_prio_t prio = nOS_PRIO_COUNT;
+    nOS_profile_entry_t entry;
+
+    for (int i = 0; i <= profile_slots[prio - 1]; i++)
+    {
+        nOS_task_enqueue (prio, profile_task, 0);
+    }
+    nOS_profile_get (prio, &entry);
+    LONGS_EQUAL(profile_slots[prio - 1], entry.peak_);
+    CHECK(entry.overflows_ >= 1);
+    nOS_schedule ();
+
+    // A reset keeps the capacity
+    nOS_profile_reset ();
+    nOS_profile_get (prio, &entry);
+    LONGS_EQUAL(profile_slots[prio - 1], entry.capacity_);
+    LONGS_EQUAL(0, entry.peak_);
+    LONGS_EQUAL(0, entry.overflows_);
+}
+
+/**
+ * The dump is the header and an entry per priority
+ */
+TEST(nanoProfile, test_dump_layout)
+{
+    UT_PRINT("test_dump_layout");
+    static uint8_t dump[nOS_PROFILE_DUMP_SIZE];
+    nOS_profile_header_t header;
+    nOS_profile_entry_t entry;
+
+    nOS_task_enqueue (2, profile_task, 0);
+    LONGS_EQUAL(0, nOS_profile_dump (dump, sizeof(dump) - 1));
+    LONGS_EQUAL(sizeof(dump), nOS_profile_dump (dump, sizeof(dump)));
+    memcpy (&header, dump, sizeof(header));
+    LONGS_EQUAL(nOS_PROFILE_MAGIC, header.magic_);
+    LONGS_EQUAL(nOS_PROFILE_VERSION, header.version_);
+    LONGS_EQUAL(sizeof(nOS_profile_entry_t), header.entry_size_);
+    LONGS_EQUAL(nOS_PRIO_COUNT, header.prio_count_);
+    LONGS_EQUAL(nOS_TASK_QUEUE_IMPL, header.queue_impl_);
+    memcpy (&entry, dump + sizeof(header) + sizeof(entry), sizeof(entry));
+    LONGS_EQUAL(profile_slots[1], entry.capacity_);
+    LONGS_EQUAL(1, entry.peak_);
+    nOS_schedule ();
+}
+#endif
+
+TEST_GROUP(nanoProfile_tester)
+{
+};
+
+TEST(nanoProfile_tester, nanoProfile_tester)
+{
+    std::cout << std::endl << std::endl
+            << "************************ PROFILE TESTER ************************";
+}
@@ -34,6 +34,14 @@ extern "C"
 
     struct_queue_t struct_queue;
     test_t *struct_queue_buff[SIZE_OF_QUEUE];
+
+#define SIZE_OF_POW2_QUEUE    4
+
+    nOS_CREATE_POW2_QUEUE(pow2_queue, int, uint8_t)
+    nOS_INSTALL_POW2_QUEUE_APIs(pow2_queue, int, uint8_t)
+
+    pow2_queue_t pow2_queue;
+    int pow2_queue_buff[128];
 }
 
 TEST_GROUP(test_queue)
@@ -148,6 +156,112 @@ TEST(test_queue,test_queue_circular_fill)
     LONGS_EQUAL(3, intiger_queue_buff[0]);
 }
 
+TEST(test_queue,test_queue_full_in_overwrites_oldest)
+{
+    int num_in, num_out = 0;
+    UT_PRINT("test_queue_full_in_overwrites_oldest");
+
+    for (num_in = 1; num_in <= SIZE_OF_QUEUE; num_in++)
+    {
+        LONGS_EQUAL(nOS_QUEUE_OK, intiger_queue_in (&intiger_queue, &num_in));
+    }
+    num_in = 4;
+    LONGS_EQUAL(nOS_QUEUE_OVERFLOWED, intiger_queue_in (&intiger_queue, &num_in));
+    CHECK_TRUE(intiger_queue_is_full (&intiger_queue));
+
+    // 1 was dropped, the others come out in order
+    for (num_in = 2; num_in <= 4; num_in++)
+    {
+        LONGS_EQUAL(nOS_QUEUE_OK, intiger_queue_out (&intiger_queue, &num_out));
+        LONGS_EQUAL(num_in, num_out);
+    }
+    CHECK_TRUE(intiger_queue_is_empty (&intiger_queue));
+}
+
+TEST(test_queue,test_pow2_queue_capacity)
+{
+    UT_PRINT("test_pow2_queue_capacity");
+
+    LONGS_EQUAL(nOS_QUEUE_BAD_CAPACITY,
+                pow2_queue_init (&pow2_queue, pow2_queue_buff, 3));
+    LONGS_EQUAL(nOS_QUEUE_BAD_CAPACITY,
+                pow2_queue_init (&pow2_queue, pow2_queue_buff, 256));
+    LONGS_EQUAL(nOS_QUEUE_OK,
+                pow2_queue_init (&pow2_queue, pow2_queue_buff, 128));
+    LONGS_EQUAL(128, pow2_queue_capacity (&pow2_queue));
+}
+
+TEST(test_queue,test_pow2_queue_wraps_free_running_indices)
+{
+    int num_in = 0, num_out = 0;
+    UT_PRINT("test_pow2_queue_wraps_free_running_indices");
+
+    LONGS_EQUAL(nOS_QUEUE_OK, pow2_queue_init (&pow2_queue, pow2_queue_buff,
+                                               SIZE_OF_POW2_QUEUE));
+    // Run the 8 bit indices around a few times, one value short of full
+    for (int i = 0; i < 1000; i++)
+    {
+        while (!pow2_queue_is_full (&pow2_queue))
+        {
+            pow2_queue_in (&pow2_queue, &num_in);
+            num_in++;
+        }
+        LONGS_EQUAL(SIZE_OF_POW2_QUEUE, pow2_queue_count (&pow2_queue));
+        pow2_queue_out (&pow2_queue, &num_out);
+        LONGS_EQUAL(num_in - SIZE_OF_POW2_QUEUE, num_out);
+    }
+    while (!pow2_queue_is_empty (&pow2_queue))
+    {
+        pow2_queue_out (&pow2_queue, &num_out);
+    }
+    LONGS_EQUAL(num_in - 1, num_out);
+    LONGS_EQUAL(0, pow2_queue_count (&pow2_queue));
+}
+
+TEST(test_queue,test_queue_bulk_in_out_wraps)
+{
+    int num_in[SIZE_OF_QUEUE] = { 1, 2, 3 }, num_out[SIZE_OF_QUEUE] = { 0 };
+    int n;
+    UT_PRINT("test_queue_bulk_in_out_wraps");
+
+    LONGS_EQUAL(nOS_QUEUE_OK, intiger_queue_in (&intiger_queue, &num_in[0]));
+    LONGS_EQUAL(nOS_QUEUE_OK, intiger_queue_out (&intiger_queue, &num_out[0]));
+    // Nothing is written when the values do not all fit
+    LONGS_EQUAL(nOS_QUEUE_OVERFLOWED, intiger_queue_in_n (&intiger_queue, num_in,
+                                                          SIZE_OF_QUEUE + 1));
+    CHECK_TRUE(intiger_queue_is_empty (&intiger_queue));
+    // Two segments, [1] and [2] then [0]
+    LONGS_EQUAL(nOS_QUEUE_OK, intiger_queue_in_n (&intiger_queue, num_in,
+                                                  SIZE_OF_QUEUE));
+    LONGS_EQUAL(1, intiger_queue_buff[1]);
+    LONGS_EQUAL(3, intiger_queue_buff[0]);
+    n = SIZE_OF_QUEUE + 1;
+    LONGS_EQUAL(nOS_QUEUE_OK, intiger_queue_out_n (&intiger_queue, num_out, &n));
+    LONGS_EQUAL(SIZE_OF_QUEUE, n);
+    MEMCMP_EQUAL(num_in, num_out, sizeof(num_in));
+    LONGS_EQUAL(nOS_QUEUE_EMPTY, intiger_queue_out_n (&intiger_queue, num_out, &n));
+    LONGS_EQUAL(0, n);
+}
+
+TEST(test_queue,test_pow2_queue_bulk_in_out_wraps)
+{
+    int num_in[SIZE_OF_POW2_QUEUE] = { 1, 2, 3, 4 };
+    int num_out[SIZE_OF_POW2_QUEUE] = { 0 };
+    UT_PRINT("test_pow2_queue_bulk_in_out_wraps");
+
+    pow2_queue_init (&pow2_queue, pow2_queue_buff, SIZE_OF_POW2_QUEUE);
+    for (int i = 0; i < 300; i++)
+    {
+        pow2_queue_in_n (&pow2_queue, num_in, 3);
+        pow2_queue_out_n (&pow2_queue, num_out, 3);
+    }
+    pow2_queue_in_n (&pow2_queue, num_in, SIZE_OF_POW2_QUEUE);
+    CHECK_TRUE(pow2_queue_is_full (&pow2_queue));
+    pow2_queue_out_n (&pow2_queue, num_out, SIZE_OF_POW2_QUEUE);
+    MEMCMP_EQUAL(num_in, num_out, sizeof(num_in));
+    CHECK_TRUE(pow2_queue_is_empty (&pow2_queue));
+}
+
 TEST(test_queue, test_queue_tester)
 {
     std::cout << std::endl << std::endl
@@ -0,0 +1,117 @@
+/*
+ * nanoRTOS_aging_tester.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ *
+ * Aging tests, a priority 8 task that posts itself again floods the
+ * scheduler while lower priorities wait.
+ */
+
+#include <iostream>
+#include "string.h"
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+extern "C"
+{
+#include "nanoRTOS.h"
+}
+
+#if nOS_AGING_CREDITS && !defined(nOS_TASK_TABLE)
+#define AGING_FLOOD     (4 * (nOS_AGING_CREDITS + 1) + 4)
+
+static uint8_t aging_log[AGING_FLOOD + 8];
+static int aging_count;
+static int aging_flood_left;
+
+static void aging_task (uint8_t event)
+{
+    aging_log[aging_count++] = event;
+}
+
+static void aging_flood_task (uint8_t event)
+{
+    aging_log[aging_count++] = event;
+    if (--aging_flood_left > 0)
+    {
+        nOS_task_enqueue (8, aging_flood_task, 8);
+    }
+}
+
+/**
+ * @return The position of the first dispatch of prio in the log, -1 if none
+ */
+static int aging_position (uint8_t prio)
+{
+    for (int i = 0; i < aging_count; i++)
+    {
+        if (aging_log[i] == prio)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+TEST_GROUP(nanoRTOS_aging)
+{
+    void setup ()
+    {
+        memset (aging_log, 0, sizeof(aging_log));
+        aging_count = 0;
+        aging_flood_left = AGING_FLOOD;
+        nOS_start ();
+    }
+    void teardown ()
+    {
+
+    }
+};
+
+/**
+ * A waiting low priority task runs once the flood spent its credits
+ */
+TEST(nanoRTOS_aging, test_low_priority_runs_after_credits)
+{
+    UT_PRINT("test_low_priority_runs_after_credits");
+
+    nOS_task_enqueue (1, aging_task, 1);
+    nOS_task_enqueue (8, aging_flood_task, 8);
+    nOS_schedule ();
+    LONGS_EQUAL(AGING_FLOOD + 1, aging_count);
+    LONGS_EQUAL(nOS_AGING_CREDITS, aging_position (1));
+    for (int i = 0; i < nOS_AGING_CREDITS; i++)
+    {
+        LONGS_EQUAL(8, aging_log[i]);
+    }
+}
+
+/**
+ * The waiting priorities take their aging turns in round robin
+ */
+TEST(nanoRTOS_aging, test_waiting_priorities_round_robin)
+{
+    UT_PRINT("test_waiting_priorities_round_robin");
+
+    nOS_task_enqueue (3, aging_task, 3);
+    nOS_task_enqueue (1, aging_task, 1);
+    nOS_task_enqueue (2, aging_task, 2);
+    nOS_task_enqueue (8, aging_flood_task, 8);
+    nOS_schedule ();
+    LONGS_EQUAL(AGING_FLOOD + 3, aging_count);
+    LONGS_EQUAL(nOS_AGING_CREDITS, aging_position (1));
+    LONGS_EQUAL(2 * nOS_AGING_CREDITS + 1, aging_position (2));
+    LONGS_EQUAL(3 * nOS_AGING_CREDITS + 2, aging_position (3));
+}
+#endif
+
+TEST_GROUP(nanoRTOS_aging_tester)
+{
+};
+
+TEST(nanoRTOS_aging_tester, nanoRTOS_aging_tester)
+{
+    std::cout << std::endl << std::endl
+            << "************************ AGING TESTER ************************";
+}
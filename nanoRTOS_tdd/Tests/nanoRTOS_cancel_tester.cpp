@@ -0,0 +1,180 @@
+/*
+ * nanoRTOS_cancel_tester.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ */
+
+#include <iostream>
+#include "string.h"
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+extern "C"
+{
+#include "nanoRTOS.h"
+}
+
+#if nOS_TASK_CANCEL && !defined(nOS_TASK_TABLE)
+#define CANCEL_SLOTS_ENTRY(length) nOS_TASK_QUEUE_SLOTS(length),
+static const uint16_t cancel_slots[nOS_PRIO_COUNT] =
+{ nOS_TASK_QUEUE_LENGTHS(CANCEL_SLOTS_ENTRY) };
+
+static uint8_t cancel_log[256];
+static int cancel_count;
+
+static void cancel_task (uint8_t event)
+{
+    cancel_log[cancel_count++ & 0xFF] = event;
+}
+
+TEST_GROUP(nanoRTOS_cancel)
+{
+    void setup ()
+    {
+        memset (cancel_log, 0, sizeof(cancel_log));
+        cancel_count = 0;
+        nOS_start ();
+    }
+    void teardown ()
+    {
+
+    }
+};
+
+/**
+ * A cancelled task is skipped, the tasks around it still run in order
+ */
+TEST(nanoRTOS_cancel, test_cancelled_task_skipped)
+{
+    UT_PRINT("test_cancelled_task_skipped");
+    const uint8_t batch[] = { 1, 2 };
+    const uint8_t expected[] = { 1, 2, 3, 5 };
+    nOS_task_handle_t handles[3];
+
+    CHECK_EQUAL(nOS_OK, nOS_task_enqueue_batch (3, cancel_task, batch, sizeof(batch)));
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        CHECK_EQUAL(nOS_OK, nOS_task_enqueue_handle (3, cancel_task, 3 + i, &handles[i]));
+    }
+    CHECK_EQUAL(nOS_OK, nOS_task_cancel (handles[1]));
+    nOS_schedule ();
+    LONGS_EQUAL(sizeof(expected), cancel_count);
+    MEMCMP_EQUAL(expected, cancel_log, sizeof(expected));
+    // The task already ran
+    CHECK_EQUAL(nOS_TASK_ERR, nOS_task_cancel (handles[0]));
+}
+
+/**
+ * A handle cancels once, a zeroed or out of range handle never
+ */
+TEST(nanoRTOS_cancel, test_invalid_handles)
+{
+    UT_PRINT("test_invalid_handles");
+    nOS_task_handle_t handle;
+
+    CHECK_EQUAL(nOS_TASK_ERR, nOS_task_enqueue_handle (3, cancel_task, 1, NULL));
+    CHECK_EQUAL(nOS_PRIORITY_ERR, nOS_task_enqueue_handle (0, cancel_task, 1, &handle));
+    CHECK_EQUAL(nOS_OK, nOS_task_enqueue_handle (3, cancel_task, 1, &handle));
+    CHECK_EQUAL(nOS_OK, nOS_task_cancel (handle));
+    CHECK_EQUAL(nOS_TASK_ERR, nOS_task_cancel (handle));
+    memset (&handle, 0, sizeof(handle));
+    CHECK_EQUAL(nOS_TASK_ERR, nOS_task_cancel (handle));
+    handle.slot_ = 0xFFFF;
+    handle.gen_ = 1;
+    CHECK_EQUAL(nOS_TASK_ERR, nOS_task_cancel (handle));
+    nOS_schedule ();
+    LONGS_EQUAL(0, cancel_count);
+}
+
+/**
+ * The handles hold across the wrap of the ring, a handle of a task that ran
+ * does not cancel the task that reuses its slot
+ */
+TEST(nanoRTOS_cancel, test_cancel_across_ring_wrap)
+{
+    UT_PRINT("test_cancel_across_ring_wrap");
+    nOS_task_handle_t handles[128];
+    nOS_task_handle_t first;
+    int slots = cancel_slots[0] < 128 ? cancel_slots[0] : 128;
+    int expected = 0;
+
+    // Move the ring off its first slot
+    nOS_task_enqueue_handle (1, cancel_task, 0xFF, &first);
+    nOS_schedule ();
+    cancel_count = 0;
+    for (int i = 0; i < slots; i++)
+    {
+        CHECK_EQUAL(nOS_OK, nOS_task_enqueue_handle (1, cancel_task, (uint8_t) i, &handles[i]));
+    }
+    CHECK_EQUAL(nOS_TASK_ERR, nOS_task_cancel (first));
+    for (int i = 1; i < slots; i += 2)
+    {
+        CHECK_EQUAL(nOS_OK, nOS_task_cancel (handles[i]));
+    }
+    nOS_schedule ();
+    LONGS_EQUAL((slots + 1) / 2, cancel_count);
+    for (int i = 0; i < cancel_count; i++)
+    {
+        LONGS_EQUAL(expected, cancel_log[i]);
+        expected += 2;
+    }
+}
+
+#if nOS_OVERFLOW_POLICY && (nOS_TASK_QUEUE_IMPL != nOS_TASK_QUEUE_LOCK_FREE)
+#define CANCEL_POLICY_ENTRY(policy) (policy),
+static const uint8_t cancel_policies[nOS_PRIO_COUNT] =
+{ nOS_TASK_OVERFLOW_POLICIES(CANCEL_POLICY_ENTRY) };
+
+/**
+ * A post to a full drop oldest queue whose oldest task was cancelled takes
+ * the free slot, no task is dropped or counted as dropped
+ */
+TEST(nanoRTOS_cancel, test_drop_oldest_cancelled)
+{
+    UT_PRINT("test_drop_oldest_cancelled");
+    nOS_task_handle_t oldest;
+    nOS_prio_t prio = 0;
+    int slots;
+
+    for (nOS_prio_t p = nOS_PRIO_COUNT; p >= 1; p--)
+    {
+        if ((nOS_OVERFLOW_DROP_OLDEST == cancel_policies[p - 1])
+                && (cancel_slots[p - 1] < 250))
+        {
+            prio = p;
+            break;
+        }
+    }
+    if (0 == prio)
+    {
+        return;
+    }
+    slots = cancel_slots[prio - 1];
+    CHECK_EQUAL(nOS_OK, nOS_task_enqueue_handle (prio, cancel_task, 0, &oldest));
+    for (int i = 1; i < slots; i++)
+    {
+        CHECK_EQUAL(nOS_OK, nOS_task_enqueue (prio, cancel_task, (uint8_t) i));
+    }
+    CHECK_EQUAL(nOS_OK, nOS_task_cancel (oldest));
+    CHECK_EQUAL(nOS_OK, nOS_task_enqueue (prio, cancel_task, (uint8_t) slots));
+    LONGS_EQUAL(0, nOS_task_overflows (prio, nOS_OVERFLOW_DROP_OLDEST));
+    nOS_schedule ();
+    LONGS_EQUAL(slots, cancel_count);
+    for (int i = 0; i < slots; i++)
+    {
+        LONGS_EQUAL(i + 1, cancel_log[i]);
+    }
+}
+#endif
+#endif
+
+TEST_GROUP(nanoRTOS_cancel_tester)
+{
+};
+
+TEST(nanoRTOS_cancel_tester, nanoRTOS_cancel_tester)
+{
+    std::cout << std::endl << std::endl
+            << "************************ CANCEL TESTER ************************";
+}
@@ -0,0 +1,170 @@
+/*
+ * nanoRTOS_cpp_tester.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ */
+
+#include <iostream>
+#include "string.h"
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+#include "nanoRTOS.hpp"
+
+typedef nOS::Config<3, 2, 1> cpp_config_t;
+static nOS::Scheduler<cpp_config_t> cpp_scheduler;
+
+static uint8_t cpp_log[64];
+static int cpp_count;
+
+static void cpp_task (uint8_t event)
+{
+    cpp_log[cpp_count++ & 0x3F] = event;
+}
+
+// Posts at the highest priority and runs it from within the task
+static void cpp_nesting_task (uint8_t event)
+{
+    cpp_log[cpp_count++ & 0x3F] = event;
+    cpp_scheduler.enqueue<3> (cpp_task, event + 1);
+    cpp_scheduler.enqueue<1> (cpp_task, event + 2);
+    cpp_scheduler.schedule ();
+}
+
+TEST_GROUP(nanoRTOS_cpp)
+{
+    void setup ()
+    {
+        memset (cpp_log, 0, sizeof(cpp_log));
+        cpp_count = 0;
+        cpp_scheduler.start ();
+    }
+    void teardown ()
+    {
+
+    }
+};
+
+/**
+ * The configuration rounds the lengths up and lays the queues out at compile
+ * time
+ */
+TEST(nanoRTOS_cpp, test_config_layout)
+{
+    UT_PRINT("test_config_layout");
+    typedef nOS::Config<28, 24, 20, 16, 12, 8, 4, 2> config_t;
+
+    LONGS_EQUAL(8, config_t::prio_count);
+    LONGS_EQUAL(32 + 32 + 32 + 16 + 16 + 8 + 4 + 2, config_t::total);
+    LONGS_EQUAL(96, config_t::offsets::values[3]);
+    LONGS_EQUAL(4, cpp_config_t::slots[0]);
+    LONGS_EQUAL(8, (nOS::Queue<int, 5>::capacity));
+}
+
+/**
+ * The queue keeps the FIFO order across many wraps of its indices
+ */
+TEST(nanoRTOS_cpp, test_queue_fifo_and_wrap)
+{
+    UT_PRINT("test_queue_fifo_and_wrap");
+    nOS::Queue<uint16_t, 4> queue;
+    uint16_t values[4];
+    uint16_t value;
+    uint16_t next = 0;
+
+    CHECK(queue.empty ());
+    CHECK(!queue.pop (value));
+    POINTERS_EQUAL(NULL, queue.front ());
+    for (int round = 0; round < 300; round++)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            CHECK(queue.push ((uint16_t) (round * 3 + i)));
+        }
+        CHECK(queue.pop (value));
+        LONGS_EQUAL(next++, value);
+        LONGS_EQUAL(2, queue.pop_n (values, 2));
+        LONGS_EQUAL(next++, values[0]);
+        LONGS_EQUAL(next++, values[1]);
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        CHECK(queue.push ((uint16_t) i));
+    }
+    CHECK(queue.full ());
+    CHECK(!queue.push (9));
+    LONGS_EQUAL(0, *queue.front ());
+    queue.clear ();
+    CHECK(queue.empty ());
+    LONGS_EQUAL(0, queue.count ());
+}
+
+/**
+ * The highest priority runs first, a priority runs in FIFO order
+ */
+TEST(nanoRTOS_cpp, test_scheduler_priority_order)
+{
+    UT_PRINT("test_scheduler_priority_order");
+    const uint8_t expected[] = { 5, 3, 4, 1, 2 };
+
+    CHECK_EQUAL(nOS_OK, cpp_scheduler.enqueue (1, cpp_task, 1));
+    CHECK_EQUAL(nOS_OK, cpp_scheduler.enqueue (2, cpp_task, 3));
+    CHECK_EQUAL(nOS_OK, cpp_scheduler.enqueue (1, cpp_task, 2));
+    CHECK_EQUAL(nOS_OK, cpp_scheduler.enqueue (2, cpp_task, 4));
+    CHECK_EQUAL(nOS_OK, cpp_scheduler.enqueue<3> (cpp_task, 5));
+    LONGS_EQUAL(2, cpp_scheduler.count (1));
+    cpp_scheduler.schedule ();
+    LONGS_EQUAL(sizeof(expected), cpp_count);
+    MEMCMP_EQUAL(expected, cpp_log, sizeof(expected));
+    LONGS_EQUAL(0, cpp_scheduler.count (1));
+}
+
+/**
+ * The posts fail as the C API does
+ */
+TEST(nanoRTOS_cpp, test_scheduler_errors)
+{
+    UT_PRINT("test_scheduler_errors");
+    const uint8_t events[] = { 1, 2, 3 };
+
+    CHECK_EQUAL(nOS_TASK_ERR, cpp_scheduler.enqueue (1, NULL, 0));
+    CHECK_EQUAL(nOS_PRIORITY_ERR, cpp_scheduler.enqueue (0, cpp_task, 0));
+    CHECK_EQUAL(nOS_PRIORITY_ERR, cpp_scheduler.enqueue (4, cpp_task, 0));
+    // Priority 3 holds a single task
+    CHECK_EQUAL(nOS_OK, cpp_scheduler.enqueue (3, cpp_task, 0));
+    CHECK_EQUAL(nOS_TASK_QUEUE_ERR, cpp_scheduler.enqueue (3, cpp_task, 0));
+    // A batch is queued all or none
+    CHECK_EQUAL(nOS_OK, cpp_scheduler.enqueue_batch (2, cpp_task, events, 2));
+    CHECK_EQUAL(nOS_TASK_QUEUE_ERR, cpp_scheduler.enqueue_batch (2, cpp_task, events, 1));
+    CHECK_EQUAL(nOS_TASK_QUEUE_ERR, cpp_scheduler.enqueue_batch (1, cpp_task, events, 5));
+    CHECK_EQUAL(nOS_OK, cpp_scheduler.enqueue_batch (1, cpp_task, events, 0));
+    CHECK_EQUAL(nOS_TASK_ERR, cpp_scheduler.enqueue_batch (1, cpp_task, NULL, 1));
+    LONGS_EQUAL(0, cpp_scheduler.count (1));
+    cpp_scheduler.schedule ();
+    LONGS_EQUAL(3, cpp_count);
+}
+
+/**
+ * A task that calls schedule only runs the priorities above its own
+ */
+TEST(nanoRTOS_cpp, test_scheduler_nested)
+{
+    UT_PRINT("test_scheduler_nested");
+    const uint8_t expected[] = { 10, 11, 12 };
+
+    cpp_scheduler.enqueue (2, cpp_nesting_task, 10);
+    cpp_scheduler.schedule ();
+    LONGS_EQUAL(sizeof(expected), cpp_count);
+    MEMCMP_EQUAL(expected, cpp_log, sizeof(expected));
+}
+
+TEST_GROUP(nanoRTOS_cpp_tester)
+{
+};
+
+TEST(nanoRTOS_cpp_tester, nanoRTOS_cpp_tester)
+{
+    std::cout << std::endl << std::endl
+            << "************************ C++ TESTER ************************";
+}
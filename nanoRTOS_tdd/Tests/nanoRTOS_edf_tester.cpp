@@ -0,0 +1,233 @@
+/*
+ * nanoRTOS_edf_tester.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ *
+ * Earliest deadline first tests, they run at the priority with the longest
+ * deadline heap of nOS_TASK_DEADLINE_LENGTHS, it shall hold 4 tasks at least.
+ */
+
+#include <iostream>
+#include "string.h"
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+extern "C"
+{
+#include "nanoRTOS.h"
+#include "nanoTimer.h"
+}
+
+#if nOS_EDF && !defined(nOS_TASK_TABLE)
+#define EDF_LENGTH_ENTRY(length) (length),
+static const uint16_t edf_lengths[nOS_PRIO_COUNT] =
+{ nOS_TASK_DEADLINE_LENGTHS(EDF_LENGTH_ENTRY) };
+
+static uint8_t edf_log[16];
+static int edf_count;
+static nOS_prio_t edf_prio;    // The priority the tests post to
+static nOS_prio_t fifo_prio;   // A priority without a heap, 0 if none
+
+static void edf_task (uint8_t event)
+{
+    edf_log[edf_count++] = event;
+}
+
+static uint32_t edf_chain_posts;
+static nOS_tick_t edf_chain_deadline;
+
+// Posts itself again ahead of the tasks waiting in the heap, the last one
+// posts the event 2 at edf_chain_deadline
+static void edf_chain_task (uint8_t event)
+{
+    if (0 == edf_chain_posts)
+    {
+        return;
+    }
+    if (0 == --edf_chain_posts)
+    {
+        nOS_task_enqueue_deadline (edf_prio, edf_task, 2, edf_chain_deadline);
+    }
+    else
+    {
+        nOS_task_enqueue_deadline (edf_prio, edf_chain_task, 0, nOS_timer_now ());
+    }
+}
+
+TEST_GROUP(nanoRTOS_edf)
+{
+    void setup ()
+    {
+        memset (edf_log, 0, sizeof(edf_log));
+        edf_count = 0;
+        edf_prio = nOS_PRIO_COUNT;
+        fifo_prio = 0;
+        for (nOS_prio_t prio = nOS_PRIO_COUNT; prio >= 1; prio--)
+        {
+            if (edf_lengths[prio - 1] > edf_lengths[edf_prio - 1])
+            {
+                edf_prio = prio;
+            }
+            if (0 == edf_lengths[prio - 1])
+            {
+                fifo_prio = prio;
+            }
+        }
+        nOS_start ();
+    }
+    void teardown ()
+    {
+
+    }
+};
+
+/**
+ * The tasks run by their deadline, not in their post order
+ */
+TEST(nanoRTOS_edf, test_earliest_deadline_first)
+{
+    UT_PRINT("test_earliest_deadline_first");
+    const uint8_t expected[] = { 1, 2, 3 };
+    nOS_tick_t now = nOS_timer_now ();
+
+    CHECK_EQUAL(nOS_OK, nOS_task_enqueue_deadline (edf_prio, edf_task, 3, now + 30));
+    CHECK_EQUAL(nOS_OK, nOS_task_enqueue_deadline (edf_prio, edf_task, 1, now + 10));
+    CHECK_EQUAL(nOS_OK, nOS_task_enqueue_deadline (edf_prio, edf_task, 2, now + 20));
+    nOS_schedule ();
+    LONGS_EQUAL(3, edf_count);
+    MEMCMP_EQUAL(expected, edf_log, sizeof(expected));
+    LONGS_EQUAL(0, nOS_task_deadline_misses (edf_prio));
+}
+
+/**
+ * The tasks of the same deadline run in their post order, also when the
+ * deadline tick wraps
+ */
+TEST(nanoRTOS_edf, test_same_deadline_in_post_order)
+{
+    UT_PRINT("test_same_deadline_in_post_order");
+    const uint8_t expected[] = { 1, 2, 3, 9 };
+
+    // 0xFFFFFFF0 is before 5 once the tick wraps
+    nOS_task_enqueue_deadline (edf_prio, edf_task, 9, 5);
+    for (uint8_t i = 1; i <= 3; i++)
+    {
+        CHECK_EQUAL(nOS_OK, nOS_task_enqueue_deadline (edf_prio, edf_task, i, 0xFFFFFFF0));
+    }
+    nOS_schedule ();
+    LONGS_EQUAL(4, edf_count);
+    MEMCMP_EQUAL(expected, edf_log, sizeof(expected));
+}
+
+/**
+ * A task keeps its turn among the tasks of its deadline however many posts
+ * ran while it waited
+ */
+TEST(nanoRTOS_edf, test_same_deadline_after_many_posts)
+{
+    UT_PRINT("test_same_deadline_after_many_posts");
+    const uint8_t expected[] = { 1, 2 };
+
+    // The chain keeps a batch of tasks ahead of the waiting one
+    if (edf_lengths[edf_prio - 1] < nOS_SCHEDULE_BATCH + 2)
+    {
+        return;
+    }
+    // More than 32768 posts between the two tasks of the deadline
+    edf_chain_deadline = nOS_timer_now () + 100;
+    edf_chain_posts = 40000;
+    nOS_task_enqueue_deadline (edf_prio, edf_task, 1, edf_chain_deadline);
+    for (int i = 0; i < nOS_SCHEDULE_BATCH; i++)
+    {
+        nOS_task_enqueue_deadline (edf_prio, edf_chain_task, 0, nOS_timer_now ());
+    }
+    nOS_schedule ();
+    LONGS_EQUAL(0, edf_chain_posts);
+    LONGS_EQUAL(2, edf_count);
+    MEMCMP_EQUAL(expected, edf_log, sizeof(expected));
+}
+
+/**
+ * The deadline tasks run ahead of the tasks of their priority posted without a
+ * deadline, a higher priority still runs first
+ */
+TEST(nanoRTOS_edf, test_deadline_before_fifo_tasks)
+{
+    UT_PRINT("test_deadline_before_fifo_tasks");
+
+    nOS_task_enqueue (edf_prio, edf_task, 7);
+    nOS_task_enqueue_deadline (edf_prio, edf_task, 1, nOS_timer_now () + 100);
+    if (edf_prio < nOS_PRIO_COUNT)
+    {
+        nOS_task_enqueue (edf_prio + 1, edf_task, 8);
+    }
+    nOS_schedule ();
+    if (edf_prio < nOS_PRIO_COUNT)
+    {
+        LONGS_EQUAL(3, edf_count);
+        LONGS_EQUAL(8, edf_log[0]);
+        LONGS_EQUAL(1, edf_log[1]);
+        LONGS_EQUAL(7, edf_log[2]);
+    }
+    else
+    {
+        LONGS_EQUAL(2, edf_count);
+        LONGS_EQUAL(1, edf_log[0]);
+        LONGS_EQUAL(7, edf_log[1]);
+    }
+}
+
+/**
+ * A task dispatched after its deadline tick counts as a miss
+ */
+TEST(nanoRTOS_edf, test_deadline_misses)
+{
+    UT_PRINT("test_deadline_misses");
+    nOS_tick_t now = nOS_timer_now ();
+
+    nOS_task_enqueue_deadline (edf_prio, edf_task, 1, now + 1);
+    nOS_task_enqueue_deadline (edf_prio, edf_task, 2, now + 3);
+    nOS_timer_tick ();
+    nOS_timer_tick ();
+    nOS_schedule ();
+    LONGS_EQUAL(2, edf_count);
+    LONGS_EQUAL(1, nOS_task_deadline_misses (edf_prio));
+    // The counters restart with the kernel
+    nOS_start ();
+    LONGS_EQUAL(0, nOS_task_deadline_misses (edf_prio));
+}
+
+/**
+ * Check the inputs, a priority without a heap and a full heap
+ */
+TEST(nanoRTOS_edf, test_deadline_errors)
+{
+    UT_PRINT("test_deadline_errors");
+
+    CHECK_EQUAL(nOS_PRIORITY_ERR, nOS_task_enqueue_deadline (0, edf_task, 1, 0));
+    CHECK_EQUAL(nOS_PRIORITY_ERR,
+                nOS_task_enqueue_deadline (nOS_PRIO_COUNT + 1, edf_task, 1, 0));
+    if (0 != fifo_prio)
+    {
+        CHECK_EQUAL(nOS_PRIORITY_ERR,
+                    nOS_task_enqueue_deadline (fifo_prio, edf_task, 1, 0));
+    }
+    for (uint16_t i = 0; i < edf_lengths[edf_prio - 1]; i++)
+    {
+        CHECK_EQUAL(nOS_OK, nOS_task_enqueue_deadline (edf_prio, edf_task, 1, i));
+    }
+    CHECK_EQUAL(nOS_TASK_QUEUE_ERR,
+                nOS_task_enqueue_deadline (edf_prio, edf_task, 1, 0));
+}
+#endif
+
+TEST_GROUP(nanoRTOS_edf_tester)
+{
+};
+
+TEST(nanoRTOS_edf_tester, nanoRTOS_edf_tester)
+{
+    std::cout << std::endl << std::endl
+            << "************************ EDF TESTER ************************";
+}
@@ -0,0 +1,216 @@
+/*
+ * nanoRTOS_overflow_tester.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ *
+ * Overflow policy tests, each runs at the highest priority of its policy in
+ * nOS_TASK_OVERFLOW_POLICIES and passes when no priority has the policy.
+ */
+
+#include <iostream>
+#include "string.h"
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+extern "C"
+{
+#include "nanoRTOS.h"
+}
+
+#if nOS_OVERFLOW_POLICY && !defined(nOS_TASK_TABLE)
+#define OVERFLOW_POLICY_ENTRY(policy) (policy),
+static const uint8_t overflow_policies[nOS_PRIO_COUNT] =
+{ nOS_TASK_OVERFLOW_POLICIES(OVERFLOW_POLICY_ENTRY) };
+#define OVERFLOW_SLOTS_ENTRY(length) nOS_TASK_QUEUE_SLOTS(length),
+static const uint16_t overflow_slots[nOS_PRIO_COUNT] =
+{ nOS_TASK_QUEUE_LENGTHS(OVERFLOW_SLOTS_ENTRY) };
+
+static uint8_t overflow_log[256];
+static int overflow_count;
+
+static void overflow_task (uint8_t event)
+{
+    overflow_log[overflow_count++ & 0xFF] = event;
+}
+
+/**
+ * @brief Finds the priority to test a policy at
+ * @return The highest priority of the policy with a queue the log can hold, 0
+ * if there is none
+ */
+static nOS_prio_t overflow_prio (uint8_t policy)
+{
+    for (nOS_prio_t prio = nOS_PRIO_COUNT; prio >= 1; prio--)
+    {
+        if ((policy == overflow_policies[prio - 1]) && (overflow_slots[prio - 1] < 250))
+        {
+            return prio;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Fills the queue of a priority with the events 0, 1, 2...
+ */
+static void overflow_fill (nOS_prio_t prio)
+{
+    for (int i = 0; i < overflow_slots[prio - 1]; i++)
+    {
+        CHECK_EQUAL(nOS_OK, nOS_task_enqueue (prio, overflow_task, (uint8_t) i));
+    }
+}
+
+#if nOS_BACK_PRESSURE_USED
+static nOS_prio_t pressure_prio;
+static nOS_task_ref_t pressure_callback;
+static uint8_t pressure_event;
+static int pressure_count;
+
+void nOS_task_back_pressure (nOS_prio_t prio, nOS_task_ref_t callback,
+                             uint8_t event)
+{
+    pressure_prio = prio;
+    pressure_callback = callback;
+    pressure_event = event;
+    pressure_count++;
+}
+#endif
+
+TEST_GROUP(nanoRTOS_overflow)
+{
+    void setup ()
+    {
+        memset (overflow_log, 0, sizeof(overflow_log));
+        overflow_count = 0;
+        nOS_start ();
+    }
+    void teardown ()
+    {
+
+    }
+};
+
+/**
+ * A rejected post leaves the queue as it was, rejected batches are counted too
+ */
+TEST(nanoRTOS_overflow, test_reject_newest)
+{
+    UT_PRINT("test_reject_newest");
+    static const uint8_t events[256] = { 0 };
+    nOS_prio_t prio = overflow_prio (nOS_OVERFLOW_REJECT);
+
+    if (0 == prio)
+    {
+        return;
+    }
+    overflow_fill (prio);
+    CHECK_EQUAL(nOS_TASK_QUEUE_ERR, nOS_task_enqueue (prio, overflow_task, 0xAA));
+    CHECK_EQUAL(nOS_TASK_QUEUE_ERR, nOS_task_enqueue_batch (prio, overflow_task, events, 1));
+    LONGS_EQUAL(2, nOS_task_overflows (prio, nOS_OVERFLOW_REJECT));
+    LONGS_EQUAL(0, nOS_task_overflows (prio, nOS_OVERFLOW_DROP_OLDEST));
+    nOS_schedule ();
+    LONGS_EQUAL(overflow_slots[prio - 1], overflow_count);
+    LONGS_EQUAL(0, overflow_log[0]);
+    LONGS_EQUAL(overflow_slots[prio - 1] - 1, overflow_log[overflow_count - 1]);
+}
+
+/**
+ * The newest tasks replace the oldest ones, which are counted as dropped
+ */
+TEST(nanoRTOS_overflow, test_drop_oldest_keeps_newest)
+{
+    UT_PRINT("test_drop_oldest_keeps_newest");
+    nOS_prio_t prio = overflow_prio (nOS_OVERFLOW_DROP_OLDEST);
+    int slots;
+
+    if (0 == prio)
+    {
+        return;
+    }
+    slots = overflow_slots[prio - 1];
+    overflow_fill (prio);
+    CHECK_EQUAL(nOS_OK, nOS_task_enqueue (prio, overflow_task, (uint8_t) slots));
+    CHECK_EQUAL(nOS_OK, nOS_task_enqueue (prio, overflow_task, (uint8_t) (slots + 1)));
+    LONGS_EQUAL(2, nOS_task_overflows (prio, nOS_OVERFLOW_DROP_OLDEST));
+    LONGS_EQUAL(0, nOS_task_overflows (prio, nOS_OVERFLOW_REJECT));
+    nOS_schedule ();
+    LONGS_EQUAL(slots, overflow_count);
+    for (int i = 0; i < slots; i++)
+    {
+        LONGS_EQUAL(i + 2, overflow_log[i]);
+    }
+}
+
+/**
+ * A task that does not fit runs at the next lower priority, after the tasks of
+ * its own priority
+ */
+TEST(nanoRTOS_overflow, test_spill_to_lower_priority)
+{
+    UT_PRINT("test_spill_to_lower_priority");
+    nOS_prio_t prio = overflow_prio (nOS_OVERFLOW_SPILL);
+
+    if (prio < 2)
+    {
+        return;
+    }
+    overflow_fill (prio);
+    CHECK_EQUAL(nOS_OK, nOS_task_enqueue (prio, overflow_task, 0xAA));
+    LONGS_EQUAL(1, nOS_task_overflows (prio, nOS_OVERFLOW_SPILL));
+    LONGS_EQUAL(0, nOS_task_overflows (prio - 1, nOS_OVERFLOW_SPILL));
+    nOS_schedule ();
+    LONGS_EQUAL(overflow_slots[prio - 1] + 1, overflow_count);
+    LONGS_EQUAL(0xAA, overflow_log[overflow_count - 1]);
+}
+
+#if nOS_BACK_PRESSURE_USED
+/**
+ * A rejected post calls the back pressure hook with the rejected task
+ */
+TEST(nanoRTOS_overflow, test_back_pressure_hook)
+{
+    UT_PRINT("test_back_pressure_hook");
+    nOS_prio_t prio = overflow_prio (nOS_OVERFLOW_BACK_PRESSURE);
+
+    if (0 == prio)
+    {
+        return;
+    }
+    pressure_count = 0;
+    overflow_fill (prio);
+    LONGS_EQUAL(0, pressure_count);
+    CHECK_EQUAL(nOS_TASK_QUEUE_ERR, nOS_task_enqueue (prio, overflow_task, 0x55));
+    LONGS_EQUAL(1, pressure_count);
+    LONGS_EQUAL(prio, pressure_prio);
+    POINTERS_EQUAL((void *) overflow_task, (void *) pressure_callback);
+    LONGS_EQUAL(0x55, pressure_event);
+    LONGS_EQUAL(1, nOS_task_overflows (prio, nOS_OVERFLOW_BACK_PRESSURE));
+    nOS_schedule ();
+    LONGS_EQUAL(overflow_slots[prio - 1], overflow_count);
+}
+#endif
+
+/**
+ * The counters reject the invalid inputs
+ */
+TEST(nanoRTOS_overflow, test_overflows_invalid_input)
+{
+    UT_PRINT("test_overflows_invalid_input");
+
+    LONGS_EQUAL(0, nOS_task_overflows (0, nOS_OVERFLOW_REJECT));
+    LONGS_EQUAL(0, nOS_task_overflows (1, nOS_OVERFLOW_POLICY_COUNT));
+}
+#endif
+
+TEST_GROUP(nanoRTOS_overflow_tester)
+{
+};
+
+TEST(nanoRTOS_overflow_tester, nanoRTOS_overflow_tester)
+{
+    std::cout << std::endl << std::endl
+            << "************************ OVERFLOW TESTER ************************";
+}
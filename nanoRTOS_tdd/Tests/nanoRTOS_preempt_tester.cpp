@@ -0,0 +1,158 @@
+/*
+ * nanoRTOS_preempt_tester.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ *
+ * Run to completion preemption tests, an "ISR" is a post followed by
+ * nOS_isr_exit as the port would call it.
+ */
+
+#include <iostream>
+#include "string.h"
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+extern "C"
+{
+#include "nanoRTOS.h"
+}
+
+#if nOS_PREEMPTIVE && !defined(nOS_TASK_TABLE)
+// Every task logs its event at its start and its event + 100 at its end
+static int preempt_log[16];
+static int preempt_count;
+
+static void preempt_mark (int mark)
+{
+    preempt_log[preempt_count++] = mark;
+}
+
+static void preempt_task (uint8_t event)
+{
+    preempt_mark (event);
+}
+
+// Interrupted by an ISR posting a priority 8 task
+static void preempt_low_task (uint8_t event)
+{
+    preempt_mark (event);
+    nOS_task_enqueue (8, preempt_task, 8);
+    nOS_isr_exit ();
+    preempt_mark (event + 100);
+}
+
+// Interrupted by an ISR posting tasks of its own and a lower priority
+static void preempt_no_task (uint8_t event)
+{
+    preempt_mark (event);
+    nOS_task_enqueue (4, preempt_task, 4);
+    nOS_task_enqueue (3, preempt_task, 3);
+    nOS_isr_exit ();
+    preempt_mark (event + 100);
+}
+
+// Priority 5, interrupted by an ISR posting priority 8 and 3 tasks
+static void preempt_mid_task (uint8_t event)
+{
+    preempt_mark (event);
+    nOS_task_enqueue (8, preempt_task, 8);
+    nOS_task_enqueue (3, preempt_task, 3);
+    nOS_isr_exit ();
+    preempt_mark (event + 100);
+}
+
+// Priority 2, interrupted by an ISR posting the priority 5 task
+static void preempt_outer_task (uint8_t event)
+{
+    preempt_mark (event);
+    nOS_task_enqueue (5, preempt_mid_task, 5);
+    nOS_isr_exit ();
+    preempt_mark (event + 100);
+}
+
+TEST_GROUP(nanoRTOS_preempt)
+{
+    void setup ()
+    {
+        memset (preempt_log, 0, sizeof(preempt_log));
+        preempt_count = 0;
+        nOS_start ();
+    }
+    void teardown ()
+    {
+
+    }
+};
+
+/**
+ * A higher priority task posted by an ISR runs at the ISR exit, before the
+ * interrupted task returns
+ */
+TEST(nanoRTOS_preempt, test_isr_preempts_lower_task)
+{
+    UT_PRINT("test_isr_preempts_lower_task");
+    const int expected[] = { 2, 8, 102 };
+
+    nOS_task_enqueue (2, preempt_low_task, 2);
+    nOS_schedule ();
+    LONGS_EQUAL(3, preempt_count);
+    MEMCMP_EQUAL(expected, preempt_log, sizeof(expected));
+}
+
+/**
+ * Tasks of the same or a lower priority wait for the interrupted task
+ */
+TEST(nanoRTOS_preempt, test_isr_no_preempt_same_or_lower)
+{
+    UT_PRINT("test_isr_no_preempt_same_or_lower");
+    const int expected[] = { 4, 104, 4, 3 };
+
+    nOS_task_enqueue (4, preempt_no_task, 4);
+    nOS_schedule ();
+    LONGS_EQUAL(4, preempt_count);
+    MEMCMP_EQUAL(expected, preempt_log, sizeof(expected));
+}
+
+/**
+ * Preemptions nest, each level only runs the priorities above the task it
+ * interrupted and the interrupted priority is restored afterwards
+ */
+TEST(nanoRTOS_preempt, test_nested_preemption)
+{
+    UT_PRINT("test_nested_preemption");
+    const int expected[] = { 2, 5, 8, 105, 3, 102 };
+
+    nOS_task_enqueue (2, preempt_outer_task, 2);
+    nOS_schedule ();
+    LONGS_EQUAL(6, preempt_count);
+    MEMCMP_EQUAL(expected, preempt_log, sizeof(expected));
+}
+
+/**
+ * An ISR that interrupted the idle loop runs all the pending tasks
+ */
+TEST(nanoRTOS_preempt, test_isr_exit_when_idle)
+{
+    UT_PRINT("test_isr_exit_when_idle");
+    const int expected[] = { 5, 1 };
+
+    nOS_task_enqueue (1, preempt_task, 1);
+    nOS_task_enqueue (5, preempt_task, 5);
+    nOS_isr_exit ();
+    LONGS_EQUAL(2, preempt_count);
+    MEMCMP_EQUAL(expected, preempt_log, sizeof(expected));
+    nOS_schedule ();
+    LONGS_EQUAL(2, preempt_count);
+}
+#endif
+
+TEST_GROUP(nanoRTOS_preempt_tester)
+{
+};
+
+TEST(nanoRTOS_preempt_tester, nanoRTOS_preempt_tester)
+{
+    std::cout << std::endl << std::endl
+            << "************************ PREEMPT TESTER ************************";
+}
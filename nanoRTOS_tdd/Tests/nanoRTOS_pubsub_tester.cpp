@@ -0,0 +1,160 @@
+/*
+ * nanoRTOS_pubsub_tester.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ *
+ * Publish/subscribe tests, they expect this topic table:
+ * -D'nOS_TOPIC_TABLE(X)=X(alarm, nOS_SUBSCRIBER(5, pubsub_task_a)
+ *     nOS_SUBSCRIBER(3, pubsub_task_b) nOS_SUBSCRIBER(8, pubsub_task_c))
+ *     X(tick, nOS_SUBSCRIBER(3, pubsub_task_b))'
+ */
+
+#include <iostream>
+#include "string.h"
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+extern "C"
+{
+#include "nanoRTOS.h"
+}
+
+#if defined(nOS_TOPIC_TABLE) && !defined(nOS_TASK_TABLE)
+// Every subscriber logs its letter and the event
+static char pubsub_log[16];
+static uint8_t pubsub_events[16];
+static int pubsub_count;
+
+static void pubsub_mark (char subscriber, uint8_t event)
+{
+    pubsub_log[pubsub_count] = subscriber;
+    pubsub_events[pubsub_count++] = event;
+}
+
+void pubsub_task_a (uint8_t event)
+{
+    pubsub_mark ('a', event);
+}
+
+void pubsub_task_b (uint8_t event)
+{
+    pubsub_mark ('b', event);
+}
+
+void pubsub_task_c (uint8_t event)
+{
+    pubsub_mark ('c', event);
+}
+
+static void pubsub_filler (uint8_t event)
+{
+}
+
+#define PUBSUB_SLOTS_ENTRY(length) nOS_TASK_QUEUE_SLOTS(length),
+static const uint16_t pubsub_slots[nOS_PRIO_COUNT] =
+{ nOS_TASK_QUEUE_LENGTHS(PUBSUB_SLOTS_ENTRY) };
+
+/**
+ * @brief Fills the queue of a priority, a post more than its slots at most
+ * @return 1 once a post was rejected, 0 if the overflow policy of the
+ * priority keeps taking tasks (then the full queue tests are skipped)
+ */
+static int pubsub_fill (nOS_prio_t prio)
+{
+    for (int i = 0; i <= pubsub_slots[prio - 1]; i++)
+    {
+        if (nOS_OK != nOS_task_enqueue (prio, pubsub_filler, 0))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+TEST_GROUP(nanoRTOS_pubsub)
+{
+    void setup ()
+    {
+        memset (pubsub_log, 0, sizeof(pubsub_log));
+        memset (pubsub_events, 0, sizeof(pubsub_events));
+        pubsub_count = 0;
+        nOS_start ();
+    }
+    void teardown ()
+    {
+
+    }
+};
+
+/**
+ * A publish posts the event to every subscriber of the topic, they run by
+ * their priority
+ */
+TEST(nanoRTOS_pubsub, test_publish_posts_all_subscribers)
+{
+    UT_PRINT("test_publish_posts_all_subscribers");
+    const uint8_t events[] = { 7, 7, 7 };
+
+    CHECK_EQUAL(nOS_OK, nOS_publish (nOS_TOPIC(alarm), 7));
+    nOS_schedule ();
+    LONGS_EQUAL(3, pubsub_count);
+    STRCMP_EQUAL("cab", pubsub_log);
+    MEMCMP_EQUAL(events, pubsub_events, sizeof(events));
+}
+
+/**
+ * Only the subscribers of the published topic get the event
+ */
+TEST(nanoRTOS_pubsub, test_publish_per_topic)
+{
+    UT_PRINT("test_publish_per_topic");
+
+    CHECK_EQUAL(nOS_OK, nOS_publish (nOS_TOPIC(tick), 1));
+    CHECK_EQUAL(nOS_OK, nOS_publish (nOS_TOPIC(tick), 2));
+    nOS_schedule ();
+    STRCMP_EQUAL("bb", pubsub_log);
+    LONGS_EQUAL(1, pubsub_events[0]);
+    LONGS_EQUAL(2, pubsub_events[1]);
+}
+
+/**
+ * A full subscriber queue fails the publish, the other subscribers still get
+ * the event
+ */
+TEST(nanoRTOS_pubsub, test_publish_full_subscriber_queue)
+{
+    UT_PRINT("test_publish_full_subscriber_queue");
+
+    if (!pubsub_fill (8))
+    {
+        return;
+    }
+    CHECK_EQUAL(nOS_TASK_QUEUE_ERR, nOS_publish (nOS_TOPIC(alarm), 3));
+    nOS_schedule ();
+    STRCMP_EQUAL("ab", pubsub_log);
+}
+
+/**
+ * Check the inputs
+ */
+TEST(nanoRTOS_pubsub, test_publish_errors)
+{
+    UT_PRINT("test_publish_errors");
+
+    CHECK_EQUAL(nOS_TOPIC_ERR, nOS_publish ((nOS_topic_t) nOS_TOPIC_COUNT, 1));
+    nOS_schedule ();
+    LONGS_EQUAL(0, pubsub_count);
+}
+#endif
+
+TEST_GROUP(nanoRTOS_pubsub_tester)
+{
+};
+
+TEST(nanoRTOS_pubsub_tester, nanoRTOS_pubsub_tester)
+{
+    std::cout << std::endl << std::endl
+            << "************************ PUBSUB TESTER ************************";
+}
@@ -0,0 +1,221 @@
+/*
+ * nanoRTOS_smp_tester.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ *
+ * Multi core scheduler tests, threads play the role of the cores.
+ */
+
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "string.h"
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+extern "C"
+{
+#include "nanoRTOS.h"
+#include "nanoAtomic.h"
+}
+
+// The POSIX port brings its own core hook (port_posix_set_core)
+#if (nOS_SMP_CORES > 1) && !defined(nOS_PORT_POSIX)
+#define SMP_TASKS_PER_PRODUCER  20000
+#define SMP_PRODUCERS           2
+
+// The core of the calling thread, the test port of nOS_CORE_ID
+static thread_local uint8_t smp_core;
+
+extern "C" uint8_t nOS_port_core_id (void)
+{
+    return smp_core;
+}
+#endif
+
+#if (nOS_SMP_CORES > 1) && !defined(nOS_PORT_POSIX)\
+        && !defined(nOS_TASK_TABLE)
+static int smp_order[16];
+static uint8_t smp_order_core[16];
+static int smp_order_count;
+
+static void smp_order_task (uint8_t event)
+{
+    smp_order_core[smp_order_count] = smp_core;
+    smp_order[smp_order_count++] = event;
+}
+
+TEST_GROUP(nanoRTOS_smp)
+{
+    void setup ()
+    {
+        smp_core = 0;
+        smp_order_count = 0;
+        nOS_start ();
+    }
+    void teardown ()
+    {
+        smp_core = 0;
+    }
+};
+
+/**
+ * An idle core steals the tasks posted on a busy core
+ */
+TEST(nanoRTOS_smp, test_idle_core_steals)
+{
+    UT_PRINT("test_idle_core_steals");
+
+    nOS_task_enqueue (3, smp_order_task, 1);
+    nOS_task_enqueue (3, smp_order_task, 2);
+    smp_core = 1;
+    nOS_schedule ();
+    LONGS_EQUAL(2, smp_order_count);
+    LONGS_EQUAL(1, smp_order[0]);
+    LONGS_EQUAL(2, smp_order[1]);
+    LONGS_EQUAL(1, smp_order_core[0]);
+    smp_core = 0;
+    nOS_schedule ();
+    LONGS_EQUAL(2, smp_order_count);
+}
+
+/**
+ * A core runs a higher priority task of another core before its own lower
+ * priority tasks
+ */
+TEST(nanoRTOS_smp, test_global_priority_order)
+{
+    UT_PRINT("test_global_priority_order");
+
+    smp_core = 1;
+    nOS_task_enqueue (2, smp_order_task, 2);
+    smp_core = 0;
+    nOS_task_enqueue (5, smp_order_task, 5);
+    nOS_task_enqueue (1, smp_order_task, 1);
+    smp_core = 1;
+    nOS_schedule ();
+    LONGS_EQUAL(3, smp_order_count);
+    LONGS_EQUAL(5, smp_order[0]);
+    LONGS_EQUAL(2, smp_order[1]);
+    LONGS_EQUAL(1, smp_order[2]);
+}
+
+/**
+ * A task posted for a core is not stolen, nor are the tasks behind it
+ */
+TEST(nanoRTOS_smp, test_pinned_task_not_stolen)
+{
+    UT_PRINT("test_pinned_task_not_stolen");
+
+    smp_core = 1;
+    LONGS_EQUAL(nOS_OK, nOS_task_enqueue_core (4, smp_order_task, 1, 0));
+    nOS_task_enqueue_core (4, smp_order_task, 2, nOS_CORE_ANY);
+    LONGS_EQUAL(nOS_CORE_ERR, nOS_task_enqueue_core (4, smp_order_task, 3,
+                                                     nOS_SMP_CORES));
+    // The second task went to core 1, the first one waits for core 0
+    nOS_schedule ();
+    LONGS_EQUAL(1, smp_order_count);
+    LONGS_EQUAL(2, smp_order[0]);
+    smp_core = 0;
+    nOS_schedule ();
+    LONGS_EQUAL(2, smp_order_count);
+    LONGS_EQUAL(1, smp_order[1]);
+    LONGS_EQUAL(0, smp_order_core[1]);
+}
+
+static uint32_t smp_dispatched[SMP_PRODUCERS + 1];
+static uint32_t smp_wrong_core;
+
+static void smp_count_task (uint8_t event)
+{
+    if ((event >= SMP_PRODUCERS) && (smp_core != event - SMP_PRODUCERS))
+    {
+        nOS_ATOMIC_FETCH_ADD(&smp_wrong_core, 1);
+    }
+    nOS_ATOMIC_FETCH_ADD(&smp_dispatched[event < SMP_PRODUCERS ? event : SMP_PRODUCERS], 1);
+}
+
+/**
+ * All the cores schedule while producers post, every task runs exactly once
+ * and the pinned tasks run on their core
+ */
+TEST(nanoRTOS_smp, test_cores_stress)
+{
+    UT_PRINT("test_cores_stress");
+    std::vector<std::thread> threads;
+    uint32_t total = SMP_PRODUCERS * SMP_TASKS_PER_PRODUCER * 2;
+    volatile int done = 0;
+
+    memset (smp_dispatched, 0, sizeof(smp_dispatched));
+    smp_wrong_core = 0;
+    for (uint8_t core = 0; core < nOS_SMP_CORES; core++)
+    {
+        threads.emplace_back ([core, &done]()
+        {
+            smp_core = core;
+            while (!done)
+            {
+                nOS_schedule ();
+                // Let the producers run on hosts with fewer CPUs than cores
+                std::this_thread::yield ();
+            }
+            nOS_schedule ();
+        });
+    }
+    for (uint8_t p = 0; p < SMP_PRODUCERS; p++)
+    {
+        threads.emplace_back ([p]()
+        {
+            // Producer p interrupts core p
+            smp_core = p % nOS_SMP_CORES;
+            for (uint32_t i = 0; i < SMP_TASKS_PER_PRODUCER; i++)
+            {
+                uint8_t core = (uint8_t) (i % nOS_SMP_CORES);
+                while (nOS_OK != nOS_task_enqueue (1 + i % nOS_PRIO_COUNT,
+                                                   smp_count_task, p))
+                {
+                    std::this_thread::yield ();
+                }
+                while (nOS_OK != nOS_task_enqueue_core (1 + i % nOS_PRIO_COUNT,
+                                                        smp_count_task,
+                                                        SMP_PRODUCERS + core,
+                                                        core))
+                {
+                    std::this_thread::yield ();
+                }
+            }
+        });
+    }
+    for (uint8_t p = 0; p < SMP_PRODUCERS; p++)
+    {
+        threads[nOS_SMP_CORES + p].join ();
+    }
+    while (smp_dispatched[0] + smp_dispatched[1] + smp_dispatched[2] < total)
+    {
+        std::this_thread::yield ();
+    }
+    done = 1;
+    for (uint8_t core = 0; core < nOS_SMP_CORES; core++)
+    {
+        threads[core].join ();
+    }
+    for (uint8_t p = 0; p < SMP_PRODUCERS; p++)
+    {
+        LONGS_EQUAL(SMP_TASKS_PER_PRODUCER, smp_dispatched[p]);
+    }
+    LONGS_EQUAL(SMP_PRODUCERS * SMP_TASKS_PER_PRODUCER,
+                smp_dispatched[SMP_PRODUCERS]);
+    LONGS_EQUAL(0, smp_wrong_core);
+}
+#endif
+
+TEST_GROUP(nanoRTOS_smp_tester)
+{
+};
+
+TEST(nanoRTOS_smp_tester, nanoRTOS_smp_tester)
+{
+    std::cout << std::endl << std::endl
+            << "************************ SMP TESTER ************************";
+}
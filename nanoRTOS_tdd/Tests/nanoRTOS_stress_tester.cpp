@@ -0,0 +1,263 @@
+/*
+ * nanoRTOS_stress_tester.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ *
+ * Host side concurrency stress tests, threads play the role of ISRs posting
+ * while the scheduler dispatches.
+ */
+
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "string.h"
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+extern "C"
+{
+#include "nanoRTOS.h"
+#include "nanoQueue.h"
+
+    nOS_CREATE_SPSC_QUEUE(spsc_queue, uint32_t)
+    nOS_INSTALL_SPSC_QUEUE_APIs(spsc_queue, uint32_t)
+
+    nOS_CREATE_MPSC_QUEUE(mpsc_queue, uint32_t)
+    nOS_INSTALL_MPSC_QUEUE_APIs(mpsc_queue, uint32_t)
+}
+
+#define STRESS_PRODUCERS    4
+#define STRESS_EVENTS       200000
+#define STRESS_QUEUE_LENGTH 7 // Deliberately not a power of two
+#define STRESS_BATCH        4
+#define STRESS_BATCH_PRODUCER 2 // Posts batches, to the lowest priority
+
+static spsc_queue_t spsc_queue;
+static uint32_t spsc_queue_buff[STRESS_QUEUE_LENGTH];
+static mpsc_queue_t mpsc_queue;
+static mpsc_queue_slot_t mpsc_queue_buff[STRESS_QUEUE_LENGTH];
+
+TEST_GROUP(lock_free_queue)
+{
+    void setup ()
+    {
+        spsc_queue_init (&spsc_queue, spsc_queue_buff, STRESS_QUEUE_LENGTH);
+        mpsc_queue_init (&mpsc_queue, mpsc_queue_buff, STRESS_QUEUE_LENGTH);
+    }
+    void teardown ()
+    {
+
+    }
+};
+
+TEST(lock_free_queue, test_spsc_queue_full_and_empty)
+{
+    uint32_t value = 0;
+    UT_PRINT("test_spsc_queue_full_and_empty");
+
+    CHECK_TRUE(spsc_queue_is_empty (&spsc_queue));
+    for (uint32_t i = 0; i < STRESS_QUEUE_LENGTH; i++)
+    {
+        LONGS_EQUAL(nOS_QUEUE_OK, spsc_queue_in (&spsc_queue, &i));
+    }
+    CHECK_TRUE(spsc_queue_is_full (&spsc_queue));
+    LONGS_EQUAL(nOS_QUEUE_OVERFLOWED, spsc_queue_in (&spsc_queue, &value));
+    for (uint32_t i = 0; i < STRESS_QUEUE_LENGTH; i++)
+    {
+        LONGS_EQUAL(nOS_QUEUE_OK, spsc_queue_out (&spsc_queue, &value));
+        LONGS_EQUAL(i, value);
+    }
+    LONGS_EQUAL(nOS_QUEUE_EMPTY, spsc_queue_out (&spsc_queue, &value));
+}
+
+TEST(lock_free_queue, test_spsc_queue_stress)
+{
+    UT_PRINT("test_spsc_queue_stress");
+    uint32_t expected = 0, value;
+
+    std::thread producer ([]()
+    {
+        for (uint32_t i = 0; i < STRESS_EVENTS; i++)
+        {
+            while (nOS_QUEUE_OK != spsc_queue_in (&spsc_queue, &i))
+            {
+                std::this_thread::yield ();
+            }
+        }
+    });
+    while (expected < STRESS_EVENTS)
+    {
+        if (nOS_QUEUE_OK == spsc_queue_out (&spsc_queue, &value))
+        {
+            // No value can be lost, duplicated or reordered
+            if (value != expected)
+            {
+                break;
+            }
+            expected++;
+        }
+        else
+        {
+            std::this_thread::yield ();
+        }
+    }
+    producer.join ();
+    LONGS_EQUAL(STRESS_EVENTS, expected);
+    CHECK_TRUE(spsc_queue_is_empty (&spsc_queue));
+}
+
+TEST(lock_free_queue, test_mpsc_queue_stress)
+{
+    UT_PRINT("test_mpsc_queue_stress");
+    std::vector<std::thread> producers;
+    uint32_t expected[STRESS_PRODUCERS] = { 0 };
+    uint32_t received = 0, value, producer;
+    int ordered = 1;
+
+    for (uint32_t p = 0; p < STRESS_PRODUCERS; p++)
+    {
+        producers.push_back (std::thread ([p]()
+        {
+            for (uint32_t i = 0; i < STRESS_EVENTS; i++)
+            {
+                uint32_t value = (p << 24) | i;
+                while (nOS_QUEUE_OK != mpsc_queue_in (&mpsc_queue, &value))
+                {
+                    std::this_thread::yield ();
+                }
+            }
+        }));
+    }
+    while (received < STRESS_PRODUCERS * STRESS_EVENTS)
+    {
+        if (nOS_QUEUE_OK == mpsc_queue_out (&mpsc_queue, &value))
+        {
+            // Each producer values shall come out in order and exactly once
+            producer = value >> 24;
+            if ((value & 0xFFFFFF) != expected[producer])
+            {
+                ordered = 0;
+            }
+            expected[producer]++;
+            received++;
+        }
+        else
+        {
+            std::this_thread::yield ();
+        }
+    }
+    for (auto &thread : producers)
+    {
+        thread.join ();
+    }
+    CHECK_TRUE(ordered);
+    for (uint32_t p = 0; p < STRESS_PRODUCERS; p++)
+    {
+        LONGS_EQUAL(STRESS_EVENTS, expected[p]);
+    }
+    CHECK_TRUE(mpsc_queue_is_empty (&mpsc_queue));
+}
+
+#if (nOS_TASK_QUEUE_IMPL == nOS_TASK_QUEUE_LOCK_FREE)\
+        && !defined(nOS_TASK_TABLE)
+/**
+ * Every producer posts its own callback with an incrementing event, the
+ * callbacks verify that no event was lost or duplicated.
+ */
+static uint32_t stress_received[STRESS_PRODUCERS];
+static uint32_t stress_errors;
+
+template<int PRODUCER>
+static void stress_task (uint8_t event)
+{
+    if (event != (uint8_t) stress_received[PRODUCER])
+    {
+        stress_errors++;
+    }
+    stress_received[PRODUCER]++;
+}
+
+static const nOS_task_callback_t stress_tasks[STRESS_PRODUCERS] =
+{ stress_task<0>, stress_task<1>, stress_task<2>, stress_task<3> };
+
+TEST_GROUP(nanoRTOS_stress)
+{
+    void setup ()
+    {
+        memset (stress_received, 0, sizeof(stress_received));
+        stress_errors = 0;
+        nOS_start ();
+    }
+    void teardown ()
+    {
+
+    }
+};
+
+TEST(nanoRTOS_stress, test_concurrent_enqueue_while_scheduling)
+{
+    UT_PRINT("test_concurrent_enqueue_while_scheduling");
+    std::vector<std::thread> producers;
+    uint32_t total = 0;
+
+    for (int p = 0; p < STRESS_PRODUCERS; p++)
+    {
+        producers.push_back (std::thread ([p]()
+        {
+            // Two producers share each priority queue
+            nOS_prio_t prio = (p % 2) ? nOS_PRIO_COUNT : 1;
+            uint8_t events[STRESS_BATCH];
+            for (uint32_t i = 0; i < STRESS_EVENTS; i += STRESS_BATCH)
+            {
+                if (STRESS_BATCH_PRODUCER == p)
+                {
+                    for (uint32_t e = 0; e < STRESS_BATCH; e++)
+                    {
+                        events[e] = (uint8_t) (i + e);
+                    }
+                    while (nOS_OK != nOS_task_enqueue_batch (prio, stress_tasks[p],
+                                                             events, STRESS_BATCH))
+                    {
+                        std::this_thread::yield ();
+                    }
+                    continue;
+                }
+                for (uint32_t e = i; e < i + STRESS_BATCH; e++)
+                {
+                    while (nOS_OK != nOS_task_enqueue (prio, stress_tasks[p], (uint8_t) e))
+                    {
+                        std::this_thread::yield ();
+                    }
+                }
+            }
+        }));
+    }
+    while (total < STRESS_PRODUCERS * STRESS_EVENTS)
+    {
+        nOS_schedule ();
+        total = 0;
+        for (int p = 0; p < STRESS_PRODUCERS; p++)
+        {
+            total += stress_received[p];
+        }
+        std::this_thread::yield ();
+    }
+    for (auto &thread : producers)
+    {
+        thread.join ();
+    }
+    nOS_schedule ();
+    LONGS_EQUAL(0, stress_errors);
+    for (int p = 0; p < STRESS_PRODUCERS; p++)
+    {
+        LONGS_EQUAL(STRESS_EVENTS, stress_received[p]);
+    }
+}
+#endif
+
+TEST(lock_free_queue, nanoRTOS_stress_tester)
+{
+    std::cout << std::endl << std::endl
+            << "************************ STRESS TESTER ************************";
+}
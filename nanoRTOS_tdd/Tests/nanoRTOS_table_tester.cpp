@@ -0,0 +1,134 @@
+/*
+ * nanoRTOS_table_tester.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ */
+
+#include <iostream>
+#include "string.h"
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+extern "C"
+{
+#include "nanoRTOS.h"
+}
+
+/*
+ * Runs in a build with the task table of these tests, e.g.
+ * -D'nOS_TASK_TABLE(X)=X(table_task_a) X(table_task_b)'
+ */
+#ifdef nOS_TASK_TABLE
+#define TABLE_LOG_LENGTH    16
+
+// The tasks dispatched, 'a' or 'b' and the event of each
+static uint8_t table_log[TABLE_LOG_LENGTH][2];
+static uint16_t table_log_count;
+
+static void table_log_task (uint8_t task, uint8_t event)
+{
+    if (table_log_count < TABLE_LOG_LENGTH)
+    {
+        table_log[table_log_count][0] = task;
+        table_log[table_log_count][1] = event;
+    }
+    table_log_count++;
+}
+
+// Listed in the table, so declared by nanoRTOS.h
+void table_task_a (uint8_t event)
+{
+    table_log_task ('a', event);
+}
+
+void table_task_b (uint8_t event)
+{
+    table_log_task ('b', event);
+}
+
+TEST_GROUP(nanoRTOS_table)
+{
+    void setup ()
+    {
+        memset (table_log, 0, sizeof(table_log));
+        table_log_count = 0;
+        nOS_start ();
+    }
+    void teardown ()
+    {
+
+    }
+};
+
+/**
+ * A task posted by its ID calls the callback listed for the ID
+ */
+TEST(nanoRTOS_table, test_post_by_id)
+{
+    UT_PRINT("test_post_by_id");
+    const uint8_t events[] = { 5, 6 };
+
+    LONGS_EQUAL(nOS_OK, nOS_task_enqueue (3, nOS_TASK_ID(table_task_b), 0x42));
+    LONGS_EQUAL(nOS_OK, nOS_task_enqueue_batch (3, nOS_TASK_ID(table_task_a),
+                                                events, 2));
+    nOS_schedule ();
+    LONGS_EQUAL(3, table_log_count);
+    LONGS_EQUAL('b', table_log[0][0]);
+    LONGS_EQUAL(0x42, table_log[0][1]);
+    LONGS_EQUAL('a', table_log[1][0]);
+    LONGS_EQUAL(5, table_log[1][1]);
+    LONGS_EQUAL('a', table_log[2][0]);
+    LONGS_EQUAL(6, table_log[2][1]);
+}
+
+/**
+ * An ID past the table is rejected, the IDs of the kernel tasks above it
+ * included, and nothing is queued
+ */
+TEST(nanoRTOS_table, test_id_out_of_range)
+{
+    UT_PRINT("test_id_out_of_range");
+    const uint8_t events[] = { 1, 2 };
+
+    LONGS_EQUAL(nOS_TASK_ERR,
+                nOS_task_enqueue (3, (nOS_task_ref_t) nOS_TASK_COUNT, 0));
+    LONGS_EQUAL(nOS_TASK_ERR,
+                nOS_task_enqueue (3, (nOS_task_ref_t) (nOS_TASK_COUNT + 1), 0));
+    LONGS_EQUAL(nOS_TASK_ERR, nOS_task_enqueue (3, (nOS_task_ref_t) 0xFF, 0));
+    LONGS_EQUAL(nOS_TASK_ERR,
+                nOS_task_enqueue_batch (3, (nOS_task_ref_t) nOS_TASK_COUNT,
+                                        events, 2));
+    nOS_schedule ();
+    LONGS_EQUAL(0, table_log_count);
+}
+
+/**
+ * The IDs are dispatched as the callbacks are, the higher priority first and
+ * in the order posted within a priority
+ */
+TEST(nanoRTOS_table, test_dispatch_order)
+{
+    UT_PRINT("test_dispatch_order");
+    const uint8_t expected[][2] = { { 'b', 3 }, { 'a', 4 }, { 'a', 1 },
+            { 'b', 2 } };
+
+    nOS_task_enqueue (2, nOS_TASK_ID(table_task_a), 1);
+    nOS_task_enqueue (2, nOS_TASK_ID(table_task_b), 2);
+    nOS_task_enqueue (6, nOS_TASK_ID(table_task_b), 3);
+    nOS_task_enqueue (6, nOS_TASK_ID(table_task_a), 4);
+    nOS_schedule ();
+    LONGS_EQUAL(4, table_log_count);
+    MEMCMP_EQUAL(expected, table_log, sizeof(expected));
+}
+#endif
+
+TEST_GROUP(nanoRTOS_table_tester)
+{
+};
+
+TEST(nanoRTOS_table_tester, nanoRTOS_table_tester)
+{
+    std::cout << std::endl << std::endl
+            << "************************ TASK TABLE TESTER ************************";
+}
@@ -15,6 +15,8 @@ extern "C"
 #include "nanoRTOS.h"
 }
 
+// The tasks are posted by callback, see nanoRTOS_table_tester.cpp for the IDs
+#ifndef nOS_TASK_TABLE
 typedef struct
 {
     uint8_t task1;
@@ -37,12 +39,23 @@ void test_task5 (uint8_t event);
 void test_task6 (uint8_t event);
 void test_task7 (uint8_t event);
 void test_task8 (uint8_t event);
+void test_order_task (uint8_t event);
+void test_batch_task (uint8_t event);
+
+// The priorities in the order they were dispatched
+static nOS_prio_t dispatch_order[nOS_PRIO_COUNT];
+static uint16_t dispatch_count;
+// The events of test_batch_task in the order they were dispatched
+static uint8_t batch_events[64];
+static uint16_t batch_count;
 
 TEST_GROUP(nanoRTOS)
 {
     void setup ()
     {
         memset (&task_counters, 0, sizeof(task_counters));
+        dispatch_count = 0;
+        batch_count = 0;
         nOS_start ();
     }
     void teardown ()
@@ -104,7 +117,36 @@ TEST(nanoRTOS, test_enqueue_check_priority_out_of_bounds)
     UT_PRINT("test_enqueue_check_priority_out_of_bounds");
 
     CHECK_EQUAL(nOS_PRIORITY_ERR, nOS_task_enqueue (0, test_task1, 1));
-    CHECK_EQUAL(nOS_PRIORITY_ERR, nOS_task_enqueue (9, test_task1, 1));
+    CHECK_EQUAL(nOS_PRIORITY_ERR, nOS_task_enqueue (nOS_PRIO_COUNT + 1,
+                                                    test_task1, 1));
+}
+
+/**
+ * Queue one task per priority in a scrambled order and check that the
+ * scheduler dispatches them from the highest to the lowest priority
+ */
+TEST(nanoRTOS, test_dispatch_from_highest_priority)
+{
+    UT_PRINT("test_dispatch_from_highest_priority");
+    nOS_prio_t prio;
+
+    for (uint16_t i = 0; i < nOS_PRIO_COUNT; i++)
+    {
+        // The odd priorities first then the even ones
+        prio = (nOS_prio_t) ((i < (nOS_PRIO_COUNT + 1) / 2) ? (2 * i + 1)
+                : (2 * (i - (nOS_PRIO_COUNT + 1) / 2) + 2));
+        CHECK_EQUAL(nOS_OK, nOS_task_enqueue (prio, test_order_task,
+                                              (uint8_t) (prio - 1)));
+    }
+    nOS_schedule ();
+    CHECK_EQUAL(nOS_PRIO_COUNT, dispatch_count);
+#if (nOS_AGING_CREDITS == 0) || (nOS_AGING_CREDITS >= nOS_PRIO_COUNT)
+    // Fewer aging credits let the waiting low priorities take turns
+    for (uint16_t i = 0; i < nOS_PRIO_COUNT; i++)
+    {
+        CHECK_EQUAL(nOS_PRIO_COUNT - i, dispatch_order[i]);
+    }
+#endif
 }
 
 /**
@@ -118,6 +160,105 @@ TEST(nanoRTOS, test_enqueue_check_full_task_queue_full)
     CHECK_EQUAL(nOS_OK, nOS_task_enqueue (8, test_task8, 1));
     CHECK_EQUAL(nOS_TASK_QUEUE_ERR, nOS_task_enqueue (8, test_task8, 1));
 }
+/**
+ * Queue a batch longer than a chunk, it wraps around the queue end and all
+ * the events are dispatched in order
+ */
+TEST(nanoRTOS, test_enqueue_batch_in_order)
+{
+    UT_PRINT("test_enqueue_batch_in_order");
+    uint8_t events[nOS_PRIO1_TASK_QUEUE_LENGTH];
+
+    for (int i = 0; i < nOS_PRIO1_TASK_QUEUE_LENGTH; i++)
+    {
+        events[i] = (uint8_t) i;
+    }
+    // Move the queue ends away from the container start
+    CHECK_EQUAL(nOS_OK, nOS_task_enqueue_batch (1, test_batch_task, events, 5));
+    nOS_schedule ();
+    batch_count = 0;
+    CHECK_EQUAL(nOS_OK, nOS_task_enqueue_batch (1, test_batch_task, events,
+                                                nOS_PRIO1_TASK_QUEUE_LENGTH));
+    nOS_schedule ();
+    CHECK_EQUAL(nOS_PRIO1_TASK_QUEUE_LENGTH, batch_count);
+    MEMCMP_EQUAL(events, batch_events, nOS_PRIO1_TASK_QUEUE_LENGTH);
+}
+
+/**
+ * A batch that does not fit is rejected as a whole
+ */
+TEST(nanoRTOS, test_enqueue_batch_errors)
+{
+    UT_PRINT("test_enqueue_batch_errors");
+    uint8_t events[3] = { 1, 2, 3 };
+
+    CHECK_EQUAL(nOS_TASK_ERR, nOS_task_enqueue_batch (8, test_batch_task, NULL, 3));
+    CHECK_EQUAL(nOS_TASK_ERR, nOS_task_enqueue_batch (8, NULL, events, 3));
+    CHECK_EQUAL(nOS_PRIORITY_ERR, nOS_task_enqueue_batch (0, test_batch_task,
+                                                          events, 3));
+    CHECK_EQUAL(nOS_OK, nOS_task_enqueue (8, test_task8, 1));
+    CHECK_EQUAL(nOS_TASK_QUEUE_ERR, nOS_task_enqueue_batch (8, test_batch_task,
+                                                            events, 2));
+    nOS_schedule ();
+    CHECK_EQUAL(1, task_counters.task8);
+    CHECK_EQUAL(0, batch_count);
+}
+
+#if nOS_TASK_COALESCE
+/**
+ * Posts of a pending task with the same event do not take queue slots, the
+ * task runs once per event
+ */
+TEST(nanoRTOS, test_coalesce_merge)
+{
+    UT_PRINT("test_coalesce_merge");
+
+    for (int i = 0; i < 10; i++)
+    {
+        CHECK_EQUAL(nOS_OK, nOS_task_enqueue_coalesced (8, test_batch_task, 1,
+                                                        nOS_COALESCE_MERGE));
+    }
+    CHECK_EQUAL(nOS_OK, nOS_task_enqueue_coalesced (8, test_batch_task, 2,
+                                                    nOS_COALESCE_MERGE));
+    // Both slots of the priority 8 queue are taken
+    CHECK_EQUAL(nOS_TASK_QUEUE_ERR, nOS_task_enqueue (8, test_task8, 1));
+    nOS_schedule ();
+    CHECK_EQUAL(2, batch_count);
+    CHECK_EQUAL(1, batch_events[0]);
+    CHECK_EQUAL(2, batch_events[1]);
+
+    // Once dispatched the task is queued again
+    CHECK_EQUAL(nOS_OK, nOS_task_enqueue_coalesced (8, test_batch_task, 1,
+                                                    nOS_COALESCE_MERGE));
+    nOS_schedule ();
+    CHECK_EQUAL(3, batch_count);
+}
+
+/**
+ * The event bits of the posts of a pending task are ORed, the task runs once
+ */
+TEST(nanoRTOS, test_coalesce_or)
+{
+    UT_PRINT("test_coalesce_or");
+
+    CHECK_EQUAL(nOS_OK, nOS_task_enqueue_coalesced (8, test_batch_task, 0x01,
+                                                    nOS_COALESCE_OR));
+    CHECK_EQUAL(nOS_OK, nOS_task_enqueue_coalesced (8, test_batch_task, 0x04,
+                                                    nOS_COALESCE_OR));
+    CHECK_EQUAL(nOS_OK, nOS_task_enqueue_coalesced (8, test_batch_task, 0x80,
+                                                    nOS_COALESCE_OR));
+    // The same callback at another priority is another task
+    CHECK_EQUAL(nOS_OK, nOS_task_enqueue_coalesced (1, test_batch_task, 0x02,
+                                                    nOS_COALESCE_OR));
+    nOS_schedule ();
+    CHECK_EQUAL(2, batch_count);
+    CHECK_EQUAL(0x85, batch_events[0]);
+    CHECK_EQUAL(0x02, batch_events[1]);
+    CHECK_EQUAL(nOS_TASK_ERR, nOS_task_enqueue_coalesced (8, NULL, 1,
+                                                          nOS_COALESCE_OR));
+}
+#endif
+
 TEST(nanoRTOS, nanoRTOS_tester)
 {
     std::cout << std::endl << std::endl
@@ -163,3 +304,14 @@ void test_task8 (uint8_t event)
 {
     task_counters.task8++;
 }
+
+void test_order_task (uint8_t event)
+{
+    dispatch_order[dispatch_count++] = (nOS_prio_t) event + 1;
+}
+
+void test_batch_task (uint8_t event)
+{
+    batch_events[batch_count++] = event;
+}
+#endif
@@ -0,0 +1,118 @@
+/*
+ * nanoStats_tester.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ */
+
+#include <iostream>
+#include "string.h"
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+extern "C"
+{
+#include "nanoRTOS.h"
+#include "nanoStats.h"
+}
+
+#if nOS_STATS && defined(nOS_PORT_HOST_SIM) && !defined(nOS_TASK_TABLE)
+static uint32_t stats_task_run_cycles;
+
+static void stats_task (uint8_t event)
+{
+    // Simulate the callback execution time
+    port_sim_advance_cycles (stats_task_run_cycles);
+}
+
+TEST_GROUP(nanoStats)
+{
+    void setup ()
+    {
+        stats_task_run_cycles = 0;
+        port_sim_reset ();
+        nOS_start ();
+    }
+    void teardown ()
+    {
+        port_sim_reset ();
+    }
+};
+
+/**
+ * The wait and run times land in their log2 bins
+ */
+TEST(nanoStats, test_wait_and_run_histograms)
+{
+    UT_PRINT("test_wait_and_run_histograms");
+    nOS_prio_stats_t stats;
+
+    nOS_task_enqueue (3, stats_task, 0);
+    port_sim_advance_cycles (50);
+    stats_task_run_cycles = 30;
+    nOS_schedule ();
+
+    LONGS_EQUAL(nOS_OK, nOS_stats_get (3, &stats));
+    LONGS_EQUAL(1, stats.dispatched_);
+    LONGS_EQUAL(1, stats.wait_hist_[6]); // 32..63 cycles
+    LONGS_EQUAL(1, stats.run_hist_[5]);  // 16..31 cycles
+    LONGS_EQUAL(50, stats.wait_max_);
+    LONGS_EQUAL(30, stats.run_max_);
+}
+
+/**
+ * The high water mark follows the queue occupancy and overflows are counted
+ */
+TEST(nanoStats, test_high_water_mark_and_overflow)
+{
+    UT_PRINT("test_high_water_mark_and_overflow");
+    nOS_prio_stats_t stats;
+
+    nOS_task_enqueue (8, stats_task, 0);
+    nOS_task_enqueue (8, stats_task, 0);
+    LONGS_EQUAL(nOS_TASK_QUEUE_ERR, nOS_task_enqueue (8, stats_task, 0));
+    nOS_schedule ();
+    nOS_task_enqueue (8, stats_task, 0);
+    nOS_schedule ();
+
+    nOS_stats_get (8, &stats);
+    LONGS_EQUAL(2, stats.high_water_);
+    LONGS_EQUAL(nOS_PRIO8_TASK_QUEUE_LENGTH, stats.capacity_);
+    LONGS_EQUAL(1, stats.overflows_);
+    LONGS_EQUAL(3, stats.dispatched_);
+    LONGS_EQUAL(3, stats.wait_hist_[0]);
+
+    nOS_stats_reset ();
+    nOS_stats_get (8, &stats);
+    LONGS_EQUAL(0, stats.high_water_);
+    LONGS_EQUAL(0, stats.dispatched_);
+    LONGS_EQUAL(nOS_PRIO8_TASK_QUEUE_LENGTH, stats.capacity_);
+    LONGS_EQUAL(nOS_PRIORITY_ERR, nOS_stats_get (9, &stats));
+}
+
+/**
+ * Long waits saturate in the last bin
+ */
+TEST(nanoStats, test_long_wait_in_last_bin)
+{
+    UT_PRINT("test_long_wait_in_last_bin");
+    nOS_prio_stats_t stats;
+
+    nOS_task_enqueue (1, stats_task, 0);
+    port_sim_advance_cycles (0x80000000);
+    nOS_schedule ();
+
+    nOS_stats_get (1, &stats);
+    LONGS_EQUAL(1, stats.wait_hist_[nOS_STATS_HIST_BINS - 1]);
+}
+#endif
+
+TEST_GROUP(nanoStats_tester)
+{
+};
+
+TEST(nanoStats_tester, nanoStats_tester)
+{
+    std::cout << std::endl << std::endl
+            << "************************ STATS TESTER ************************";
+}
@@ -0,0 +1,317 @@
+/*
+ * nanoTimer_tester.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ */
+
+#include <iostream>
+#include "string.h"
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+extern "C"
+{
+#include "nanoRTOS.h"
+#include "nanoTimer.h"
+}
+
+// The tasks are posted by callback, see nanoRTOS_table_tester.cpp for the IDs
+#ifndef nOS_TASK_TABLE
+static uint32_t timer_task_calls;
+static uint8_t timer_task_event;
+
+static void timer_task (uint8_t event)
+{
+    timer_task_calls++;
+    timer_task_event = event;
+}
+
+static void timer_fill_task (uint8_t event)
+{
+}
+
+#define TIMER_SLOTS_ENTRY(length) nOS_TASK_QUEUE_SLOTS(length),
+static const uint16_t timer_slots[nOS_PRIO_COUNT] =
+{ nOS_TASK_QUEUE_LENGTHS(TIMER_SLOTS_ENTRY) };
+
+/**
+ * @brief Fills the queue of a priority, a post more than its slots at most
+ * @return 1 once a post was rejected, 0 if the overflow policy of the
+ * priority keeps taking tasks (then the full queue tests are skipped)
+ */
+static int timer_fill (nOS_prio_t prio)
+{
+    for (int i = 0; i <= timer_slots[prio - 1]; i++)
+    {
+        if (nOS_OK != nOS_task_enqueue (prio, timer_fill_task, 0))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static void run_ticks (nOS_tick_t ticks)
+{
+    while (ticks--)
+    {
+        nOS_timer_tick ();
+        nOS_schedule ();
+    }
+}
+
+TEST_GROUP(nanoTimer)
+{
+    void setup ()
+    {
+        timer_task_calls = 0;
+        timer_task_event = 0;
+        nOS_start ();
+    }
+    void teardown ()
+    {
+
+    }
+};
+
+/**
+ * A one shot timer posts its task once, exactly after the delay
+ */
+TEST(nanoTimer, test_one_shot_timer_expires_after_delay)
+{
+    UT_PRINT("test_one_shot_timer_expires_after_delay");
+
+    CHECK_TRUE(nOS_TIMER_INVALID != nOS_timer_start (3, timer_task, 7, 10, 0));
+    run_ticks (9);
+    LONGS_EQUAL(0, timer_task_calls);
+    run_ticks (1);
+    LONGS_EQUAL(1, timer_task_calls);
+    LONGS_EQUAL(7, timer_task_event);
+    run_ticks (100);
+    LONGS_EQUAL(1, timer_task_calls);
+}
+
+/**
+ * A periodic timer posts its task every period, also when the delay is longer
+ * than a wheel round
+ */
+TEST(nanoTimer, test_periodic_timer)
+{
+    UT_PRINT("test_periodic_timer");
+
+    CHECK_TRUE(nOS_TIMER_INVALID != nOS_timer_start (1, timer_task, 0,
+                                nOS_TIMER_WHEEL_SIZE * 3 + 1, 5));
+    run_ticks (nOS_TIMER_WHEEL_SIZE * 3);
+    LONGS_EQUAL(0, timer_task_calls);
+    run_ticks (1);
+    LONGS_EQUAL(1, timer_task_calls);
+    run_ticks (50);
+    LONGS_EQUAL(11, timer_task_calls);
+}
+
+/**
+ * A cancelled timer does not post and its handle can not be cancelled twice
+ */
+TEST(nanoTimer, test_cancel_timer)
+{
+    UT_PRINT("test_cancel_timer");
+    nOS_timer_t timer = nOS_timer_start (2, timer_task, 0, 5, 5);
+
+    run_ticks (5);
+    LONGS_EQUAL(1, timer_task_calls);
+    LONGS_EQUAL(nOS_OK, nOS_timer_cancel (timer));
+    LONGS_EQUAL(nOS_TIMER_ERR, nOS_timer_cancel (timer));
+    run_ticks (20);
+    LONGS_EQUAL(1, timer_task_calls);
+}
+
+/**
+ * The handle of an expired one shot timer does not cancel the timer that
+ * reuses its control block
+ */
+TEST(nanoTimer, test_stale_handle_does_not_cancel_new_timer)
+{
+    UT_PRINT("test_stale_handle_does_not_cancel_new_timer");
+    nOS_timer_t stale = nOS_timer_start (2, timer_task, 0, 1, 0);
+
+    run_ticks (1);
+    nOS_timer_start (2, timer_task, 0, 1, 0);
+    LONGS_EQUAL(nOS_TIMER_ERR, nOS_timer_cancel (stale));
+    run_ticks (1);
+    LONGS_EQUAL(2, timer_task_calls);
+}
+
+/**
+ * An expiry that finds the task queue full is counted, a one shot timer posts
+ * again on the next tick and a periodic timer on its next period
+ */
+TEST(nanoTimer, test_full_queue_post_failures)
+{
+    UT_PRINT("test_full_queue_post_failures");
+    nOS_prio_t prio = nOS_PRIO_COUNT;
+
+    if (!timer_fill (prio))
+    {
+        return;
+    }
+    nOS_timer_start (prio, timer_task, 5, 1, 0);
+    nOS_timer_tick ();
+    LONGS_EQUAL(1, nOS_timer_post_failures ());
+    nOS_schedule ();
+    LONGS_EQUAL(0, timer_task_calls);
+    run_ticks (1);
+    LONGS_EQUAL(1, timer_task_calls);
+    LONGS_EQUAL(5, timer_task_event);
+    run_ticks (5);
+    LONGS_EQUAL(1, timer_task_calls);
+
+    nOS_timer_start (prio, timer_task, 6, 1, 3);
+    CHECK_TRUE(timer_fill (prio));
+    nOS_timer_tick ();
+    LONGS_EQUAL(2, nOS_timer_post_failures ());
+    nOS_schedule ();
+    run_ticks (2);
+    LONGS_EQUAL(1, timer_task_calls);
+    run_ticks (1);
+    LONGS_EQUAL(2, timer_task_calls);
+    LONGS_EQUAL(6, timer_task_event);
+}
+
+/**
+ * Start fails when all the timers are running or the arguments are wrong
+ */
+TEST(nanoTimer, test_start_errors)
+{
+    UT_PRINT("test_start_errors");
+
+    CHECK_TRUE(nOS_TIMER_INVALID == nOS_timer_start (1, NULL, 0, 1, 0));
+    CHECK_TRUE(nOS_TIMER_INVALID == nOS_timer_start (0, timer_task, 0, 1, 0));
+    for (int i = 0; i < nOS_TIMER_COUNT; i++)
+    {
+        CHECK_TRUE(nOS_TIMER_INVALID != nOS_timer_start (1, timer_task, 0, i + 1, 0));
+    }
+    CHECK_TRUE(nOS_TIMER_INVALID == nOS_timer_start (1, timer_task, 0, 1, 0));
+    run_ticks (nOS_TIMER_COUNT);
+    LONGS_EQUAL(nOS_TIMER_COUNT, timer_task_calls);
+}
+
+#if nOS_TICKLESS_IDLE && defined(nOS_PORT_HOST_SIM)
+static void tickless_isr (void)
+{
+    nOS_task_enqueue (5, timer_task, 0xAA);
+}
+
+static uint32_t tickless_nested_wakeups;
+
+// Runs the higher priorities from within a task, with all the queues empty
+static void tickless_nesting_task (uint8_t event)
+{
+    nOS_schedule ();
+    tickless_nested_wakeups = port_sim_wakeups ();
+}
+
+TEST_GROUP(tickless)
+{
+    void setup ()
+    {
+        timer_task_calls = 0;
+        timer_task_event = 0;
+        nOS_start ();
+        port_sim_reset ();
+        port_sim_enable_sleep (1);
+    }
+    void teardown ()
+    {
+        port_sim_reset ();
+    }
+};
+
+/**
+ * A nOS_schedule from within a task does not sleep, the task is running
+ */
+TEST(tickless, test_no_sleep_in_nested_schedule)
+{
+    UT_PRINT("test_no_sleep_in_nested_schedule");
+
+    tickless_nested_wakeups = 0xFFFF;
+    nOS_timer_start (1, timer_task, 0, 1000, 0);
+    nOS_task_enqueue (2, tickless_nesting_task, 0);
+    nOS_schedule ();
+    LONGS_EQUAL(0, tickless_nested_wakeups);
+    LONGS_EQUAL(0, timer_task_calls);
+    // The outer schedule sleeps once the task returned
+    LONGS_EQUAL(1, port_sim_wakeups ());
+    LONGS_EQUAL(1000, nOS_timer_now ());
+}
+
+/**
+ * The kernel sleeps once per timer expiry instead of waking up every tick
+ */
+TEST(tickless, test_sleep_until_next_expiry)
+{
+    UT_PRINT("test_sleep_until_next_expiry");
+
+    nOS_timer_start (1, timer_task, 0, 1000, 1000);
+    for (int i = 0; i < 10; i++)
+    {
+        nOS_schedule ();
+    }
+    // The last sleep posted the tenth expiry, it runs on the next schedule
+    LONGS_EQUAL(9, timer_task_calls);
+    LONGS_EQUAL(10000, nOS_timer_now ());
+    LONGS_EQUAL(10, port_sim_wakeups ());
+    LONGS_EQUAL(10000, port_sim_slept_ticks ());
+    LONGS_EQUAL(0, port_sim_unlocked_sleeps ());
+}
+
+/**
+ * An interrupt wakes the kernel early, the time is corrected and the timer
+ * still expires on its tick
+ */
+TEST(tickless, test_interrupt_wakes_before_expiry)
+{
+    UT_PRINT("test_interrupt_wakes_before_expiry");
+
+    nOS_timer_start (1, timer_task, 1, 1000, 0);
+    port_sim_raise_irq (300, tickless_isr);
+    nOS_schedule ();
+    LONGS_EQUAL(300, nOS_timer_now ());
+    nOS_schedule ();
+    LONGS_EQUAL(1, timer_task_calls);
+    LONGS_EQUAL(0xAA, timer_task_event);
+    LONGS_EQUAL(1000, nOS_timer_now ());
+    nOS_schedule ();
+    LONGS_EQUAL(2, timer_task_calls);
+    LONGS_EQUAL(1, timer_task_event);
+    LONGS_EQUAL(2, port_sim_wakeups ());
+}
+
+/**
+ * Nothing is pending and no timer is running, the sleep hook is called once
+ * with nOS_TICK_FOREVER
+ */
+TEST(tickless, test_sleep_forever_without_timers)
+{
+    UT_PRINT("test_sleep_forever_without_timers");
+
+    port_sim_raise_irq (12345, tickless_isr);
+    nOS_schedule ();
+    LONGS_EQUAL(1, port_sim_wakeups ());
+    LONGS_EQUAL(12345, nOS_timer_now ());
+    nOS_schedule ();
+    LONGS_EQUAL(1, timer_task_calls);
+}
+#endif
+#endif
+
+TEST_GROUP(nanoTimer_tester)
+{
+};
+
+TEST(nanoTimer_tester, nanoTimer_tester)
+{
+    std::cout << std::endl << std::endl
+            << "************************ TIMER TESTER ************************";
+}
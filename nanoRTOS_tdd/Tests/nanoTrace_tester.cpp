@@ -0,0 +1,202 @@
+/*
+ * nanoTrace_tester.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ */
+
+#include <iostream>
+#include "string.h"
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+extern "C"
+{
+#include "nanoRTOS.h"
+#include "nanoTrace.h"
+#include "nanoPort.h"
+}
+
+#if nOS_TRACE && defined(nOS_PORT_HOST_SIM) && !defined(nOS_TASK_TABLE)
+static uint8_t trace_dump[nOS_TRACE_DUMP_SIZE];
+
+static void trace_task (uint8_t event)
+{
+    // Simulate the callback execution time
+    port_sim_advance_cycles (7);
+}
+
+#define TRACE_SLOTS_ENTRY(length) nOS_TASK_QUEUE_SLOTS(length),
+static const uint16_t trace_slots[nOS_PRIO_COUNT] =
+{ nOS_TASK_QUEUE_LENGTHS(TRACE_SLOTS_ENTRY) };
+
+/**
+ * @brief Fills the queue of a priority, a post more than its slots at most
+ * @return 1 once a post was rejected, 0 if the overflow policy of the
+ * priority keeps taking tasks (then the full queue tests are skipped)
+ */
+static int trace_fill (nOS_prio_t prio)
+{
+    for (int i = 0; i <= trace_slots[prio - 1]; i++)
+    {
+        if (nOS_OK != nOS_task_enqueue (prio, trace_task, 9))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static void trace_isr (void)
+{
+    nOS_task_enqueue (4, trace_task, 6);
+}
+
+static nOS_trace_header_t *trace_header (void)
+{
+    return (nOS_trace_header_t *) trace_dump;
+}
+
+static nOS_trace_record_t *trace_records (void)
+{
+    return (nOS_trace_record_t *) (trace_dump + sizeof(nOS_trace_header_t));
+}
+
+static void check_record (const nOS_trace_record_t *record, uint8_t type,
+                          uint16_t prio, uint8_t arg, uint32_t cycles)
+{
+    LONGS_EQUAL(type, record->type_);
+    LONGS_EQUAL(prio, record->prio_);
+    LONGS_EQUAL(arg, record->arg_);
+    LONGS_EQUAL(cycles, record->cycles_);
+}
+
+TEST_GROUP(nanoTrace)
+{
+    void setup ()
+    {
+        memset (trace_dump, 0, sizeof(trace_dump));
+        port_sim_reset ();
+        nOS_start ();
+    }
+    void teardown ()
+    {
+        port_sim_reset ();
+    }
+};
+
+/**
+ * A post and its dispatch leave an enqueue, a start, an end and an idle record
+ */
+TEST(nanoTrace, test_enqueue_and_dispatch_records)
+{
+    UT_PRINT("test_enqueue_and_dispatch_records");
+    nOS_trace_record_t *records = trace_records ();
+
+    port_sim_advance_cycles (10);
+    nOS_task_enqueue (3, trace_task, 5);
+    port_sim_advance_cycles (20);
+    nOS_schedule ();
+
+    LONGS_EQUAL(sizeof(nOS_trace_header_t) + 4 * sizeof(nOS_trace_record_t),
+                nOS_trace_dump (trace_dump, sizeof(trace_dump)));
+    LONGS_EQUAL(8, sizeof(nOS_trace_record_t));
+    LONGS_EQUAL(nOS_TRACE_MAGIC, trace_header ()->magic_);
+    LONGS_EQUAL(nOS_TRACE_VERSION, trace_header ()->version_);
+    LONGS_EQUAL(nOS_PRIO_COUNT, trace_header ()->prio_count_);
+    LONGS_EQUAL(4, trace_header ()->count_);
+    LONGS_EQUAL(0, trace_header ()->lost_);
+    check_record (&records[0], nOS_TRACE_ENQUEUE, 3, 5, 10);
+    check_record (&records[1], nOS_TRACE_START, 3, 5, 30);
+    check_record (&records[2], nOS_TRACE_END, 3, 5, 37);
+    check_record (&records[3], nOS_TRACE_IDLE, 0, 0, 37);
+}
+
+/**
+ * A batch is one record, a full queue leaves an overflow record
+ */
+TEST(nanoTrace, test_batch_and_overflow_records)
+{
+    UT_PRINT("test_batch_and_overflow_records");
+    const uint8_t events[] = { 1, 2, 3 };
+    nOS_trace_record_t *records = trace_records ();
+    uint32_t count;
+
+    nOS_task_enqueue_batch (1, trace_task, events, sizeof(events));
+    if (!trace_fill (8))
+    {
+        return;
+    }
+    nOS_trace_dump (trace_dump, sizeof(trace_dump));
+    count = trace_header ()->count_;
+    check_record (&records[0], nOS_TRACE_ENQUEUE_N, 1, 3, 0);
+    check_record (&records[1], nOS_TRACE_ENQUEUE, 8, 9, 0);
+    check_record (&records[count - 1], nOS_TRACE_OVERFLOW, 8, 9, 0);
+}
+
+/**
+ * The records made in an ISR are flagged
+ */
+TEST(nanoTrace, test_isr_records_flagged)
+{
+    UT_PRINT("test_isr_records_flagged");
+    nOS_trace_record_t *records = trace_records ();
+
+    port_sim_isr (trace_isr);
+    nOS_task_enqueue (4, trace_task, 7);
+    nOS_trace_dump (trace_dump, sizeof(trace_dump));
+    check_record (&records[0], nOS_TRACE_ENQUEUE | nOS_TRACE_ISR, 4, 6, 0);
+    // Preemptive, the task of the ISR ran at its exit
+    check_record (&records[trace_header ()->count_ - 1], nOS_TRACE_ENQUEUE, 4, 7,
+                  nOS_PREEMPTIVE ? 7 : 0);
+}
+
+/**
+ * The ring keeps the newest records and counts the overwritten ones, a small
+ * dump only takes the newest records that fit
+ */
+TEST(nanoTrace, test_ring_keeps_newest)
+{
+    UT_PRINT("test_ring_keeps_newest");
+    nOS_trace_record_t *records = trace_records ();
+    uint32_t total = 0;
+
+    while (total < nOS_TRACE_RECORDS + 10)
+    {
+        port_sim_advance_cycles (1);
+        nOS_task_enqueue (2, trace_task, (uint8_t) total);
+        nOS_schedule ();
+        total += 4;
+    }
+    nOS_trace_dump (trace_dump, sizeof(trace_dump));
+    LONGS_EQUAL(nOS_TRACE_RECORDS, trace_header ()->count_);
+    LONGS_EQUAL(total - nOS_TRACE_RECORDS, trace_header ()->lost_);
+    for (uint32_t i = 1; i < nOS_TRACE_RECORDS; i++)
+    {
+        CHECK(records[i].cycles_ >= records[i - 1].cycles_);
+    }
+    check_record (&records[nOS_TRACE_RECORDS - 1], nOS_TRACE_IDLE, 0, 0,
+                  nOS_port_cycles ());
+
+    memset (trace_dump, 0, sizeof(trace_dump));
+    LONGS_EQUAL(sizeof(nOS_trace_header_t) + 2 * sizeof(nOS_trace_record_t),
+                nOS_trace_dump (trace_dump, sizeof(nOS_trace_header_t)
+                        + 2 * sizeof(nOS_trace_record_t) + 3));
+    LONGS_EQUAL(2, trace_header ()->count_);
+    LONGS_EQUAL(total - 2, trace_header ()->lost_);
+    LONGS_EQUAL(nOS_TRACE_END, records[0].type_);
+    LONGS_EQUAL(nOS_TRACE_IDLE, records[1].type_);
+    LONGS_EQUAL(0, nOS_trace_dump (trace_dump, sizeof(nOS_trace_header_t) - 1));
+}
+#endif
+
+TEST_GROUP(nanoTrace_tester)
+{
+};
+
+TEST(nanoTrace_tester, nanoTrace_tester)
+{
+    std::cout << std::endl << std::endl
+            << "************************ TRACE TESTER ************************";
+}
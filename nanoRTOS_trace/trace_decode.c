@@ -0,0 +1,352 @@
+/*
+ * trace_decode.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ *
+ * Decodes a dump of nOS_trace_dump (nanoTrace.h) into a Chrome trace JSON,
+ * open it in chrome://tracing or https://ui.perfetto.dev.
+ * Every priority is a thread of the timeline, its callbacks are slices with
+ * the event and the wait since the enqueue, the enqueues and overflows are
+ * instant events. The idle entries are slices of the "idle" thread that last
+ * until the next record.
+ * The waits are matched in FIFO order per priority, they are approximate for
+ * the tasks that were pending when the ring wrapped and for the deadline
+ * tasks (nOS_task_enqueue_deadline).
+ * Usage: trace_decode [--cycles-per-us N] [-o trace.json] dump.bin
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The dump layout of nanoTrace.h, read byte by byte so the host needs neither
+// the kernel configuration nor the byte order of the target
+#define TRACE_MAGIC         0x54534F6Eu
+#define TRACE_VERSION       2
+#define TRACE_ISR           0x80
+#define TRACE_HEADER_SIZE   20
+#define TRACE_RECORD_SIZE   8
+
+enum
+{
+    TRACE_ENQUEUE,
+    TRACE_ENQUEUE_N,
+    TRACE_OVERFLOW,
+    TRACE_START,
+    TRACE_END,
+    TRACE_IDLE
+};
+
+typedef struct
+{
+    uint64_t time_;  // The unwrapped cycles
+    uint16_t prio_;
+    uint8_t type_;
+    uint8_t arg_;
+    uint8_t isr_;    // Recorded in an ISR
+} record_t;
+
+// The enqueue times of the pending tasks of a priority
+typedef struct
+{
+    uint64_t *times_;
+    uint32_t head_;
+    uint32_t tail_;
+} pending_t;
+
+static int big_endian;
+static double cycles_per_us;
+
+static uint32_t read_u32 (const uint8_t *in)
+{
+    if (big_endian)
+    {
+        return ((uint32_t) in[0] << 24) | ((uint32_t) in[1] << 16)
+                | ((uint32_t) in[2] << 8) | in[3];
+    }
+    return ((uint32_t) in[3] << 24) | ((uint32_t) in[2] << 16)
+            | ((uint32_t) in[1] << 8) | in[0];
+}
+
+static uint16_t read_u16 (const uint8_t *in)
+{
+    if (big_endian)
+    {
+        return (uint16_t) ((in[0] << 8) | in[1]);
+    }
+    return (uint16_t) ((in[1] << 8) | in[0]);
+}
+
+static double to_us (uint64_t time)
+{
+    return (double) time / cycles_per_us;
+}
+
+static uint8_t *read_file (const char *path, long *size)
+{
+    FILE *file = fopen (path, "rb");
+    uint8_t *data = NULL;
+
+    if (NULL == file)
+    {
+        return NULL;
+    }
+    if ((0 == fseek (file, 0, SEEK_END)) && ((*size = ftell (file)) >= 0)
+            && (0 == fseek (file, 0, SEEK_SET)))
+    {
+        data = malloc (*size ? *size : 1);
+        if ((NULL != data) && (fread (data, 1, *size, file) != (size_t) *size))
+        {
+            free (data);
+            data = NULL;
+        }
+    }
+    fclose (file);
+
+    return data;
+}
+
+static void print_thread (FILE *out, uint32_t tid, const char *name,
+                          uint32_t prio, uint32_t sort)
+{
+    if (name)
+    {
+        fprintf (out, "{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\","
+                 "\"args\":{\"name\":\"%s\"}},\n", tid, name);
+    }
+    else
+    {
+        fprintf (out, "{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\","
+                 "\"args\":{\"name\":\"prio %u\"}},\n", tid, prio);
+    }
+    fprintf (out, "{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_sort_index\","
+             "\"args\":{\"sort_index\":%u}},\n", tid, sort);
+}
+
+int main (int argc, char **argv)
+{
+    const char *in_path = NULL;
+    const char *out_path = NULL;
+    double cycles_override = 0;
+    FILE *out = stdout;
+    uint8_t *data;
+    long size;
+    uint32_t prio_count;
+    uint32_t count;
+    uint32_t lost;
+    uint32_t prev = 0;
+    uint64_t time = 0;
+    record_t *records;
+    pending_t *pending;
+    uint8_t *open;
+    uint32_t i;
+    uint32_t j;
+    int k;
+
+    for (k = 1; k < argc; k++)
+    {
+        if ((0 == strcmp (argv[k], "--cycles-per-us")) && (k + 1 < argc))
+        {
+            cycles_override = strtod (argv[++k], NULL);
+        }
+        else if ((0 == strcmp (argv[k], "-o")) && (k + 1 < argc))
+        {
+            out_path = argv[++k];
+        }
+        else
+        {
+            in_path = argv[k];
+        }
+    }
+    if (NULL == in_path)
+    {
+        fprintf (stderr, "usage: %s [--cycles-per-us N] [-o trace.json] dump.bin\n",
+                 argv[0]);
+        return 2;
+    }
+    data = read_file (in_path, &size);
+    if (NULL == data)
+    {
+        perror (in_path);
+        return 1;
+    }
+
+    if ((size < TRACE_HEADER_SIZE)
+            || ((TRACE_MAGIC != read_u32 (data))
+                    && (big_endian = 1, TRACE_MAGIC != read_u32 (data))))
+    {
+        fprintf (stderr, "%s: not a nanoRTOS trace dump\n", in_path);
+        return 1;
+    }
+    if ((data[4] < 1) || (data[4] > TRACE_VERSION)
+            || (TRACE_RECORD_SIZE != data[5]))
+    {
+        fprintf (stderr, "%s: unsupported trace version %u\n", in_path, data[4]);
+        return 1;
+    }
+    prio_count = read_u16 (data + 6);
+    cycles_per_us = cycles_override > 0 ? cycles_override : read_u32 (data + 8);
+    count = read_u32 (data + 12);
+    lost = read_u32 (data + 16);
+    if (cycles_per_us <= 0)
+    {
+        cycles_per_us = 1;
+    }
+    if ((uint64_t) size < TRACE_HEADER_SIZE + (uint64_t) count * TRACE_RECORD_SIZE)
+    {
+        fprintf (stderr, "%s: truncated, %u records expected\n", in_path, count);
+        return 1;
+    }
+
+    // Unwrap the 32 bit cycle counter, the records are oldest first
+    records = calloc (count ? count : 1, sizeof(record_t));
+    pending = calloc (prio_count + 1, sizeof(pending_t));
+    open = calloc (prio_count + 1, 1);
+    for (i = 0; i < count; i++)
+    {
+        const uint8_t *in = data + TRACE_HEADER_SIZE + i * TRACE_RECORD_SIZE;
+        uint32_t cycles = read_u32 (in);
+
+        time += i ? (uint32_t) (cycles - prev) : 0;
+        prev = cycles;
+        records[i].time_ = time;
+        records[i].prio_ = read_u16 (in + 4);
+        records[i].type_ = in[6] & ~TRACE_ISR;
+        records[i].isr_ = (in[6] & TRACE_ISR) ? 1 : 0;
+        records[i].arg_ = in[7];
+        if (records[i].prio_ > prio_count)
+        {
+            fprintf (stderr, "%s: record %u has priority %u\n", in_path, i,
+                     records[i].prio_);
+            return 1;
+        }
+        if (TRACE_ENQUEUE == records[i].type_)
+        {
+            pending[records[i].prio_].tail_++;
+        }
+        else if (TRACE_ENQUEUE_N == records[i].type_)
+        {
+            pending[records[i].prio_].tail_ += records[i].arg_;
+        }
+    }
+    // Room for every enqueue of the dump
+    for (j = 0; j <= prio_count; j++)
+    {
+        pending[j].times_ = malloc ((pending[j].tail_ + 1) * sizeof(uint64_t));
+        pending[j].tail_ = 0;
+    }
+
+    if (out_path && (NULL == (out = fopen (out_path, "w"))))
+    {
+        perror (out_path);
+        return 1;
+    }
+    fprintf (out, "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"records\":%u,"
+             "\"lost\":%u,\"cycles_per_us\":%g},\n\"traceEvents\":[\n",
+             count, lost, cycles_per_us);
+    fprintf (out, "{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\","
+             "\"args\":{\"name\":\"nanoRTOS\"}},\n");
+    print_thread (out, 0, "idle", 0, prio_count + 1);
+    for (j = 1; j <= prio_count; j++)
+    {
+        // The highest priority on top
+        print_thread (out, j, NULL, j, prio_count - j);
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        const record_t *record = &records[i];
+        pending_t *queue = &pending[record->prio_];
+        double ts = to_us (record->time_);
+
+        switch (record->type_)
+        {
+            case TRACE_ENQUEUE:
+            case TRACE_ENQUEUE_N:
+                for (j = (TRACE_ENQUEUE == record->type_) ? 1 : record->arg_; j; j--)
+                {
+                    queue->times_[queue->tail_++] = record->time_;
+                }
+                fprintf (out, "{\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,"
+                         "\"ts\":%.3f,\"name\":\"%s\",\"args\":{\"%s\":%u,"
+                         "\"isr\":%u}},\n", record->prio_, ts,
+                         (TRACE_ENQUEUE == record->type_) ? "enqueue" : "enqueue batch",
+                         (TRACE_ENQUEUE == record->type_) ? "event" : "count",
+                         record->arg_, record->isr_);
+                break;
+            case TRACE_OVERFLOW:
+                // Dropped the oldest task (nOS_OVERFLOW_DROP_OLDEST) when the
+                // post is queued at the same priority right away
+                if ((i + 1 < count) && (TRACE_ENQUEUE == records[i + 1].type_)
+                        && (record->prio_ == records[i + 1].prio_)
+                        && (queue->head_ < queue->tail_))
+                {
+                    queue->head_++;
+                }
+                fprintf (out, "{\"ph\":\"i\",\"s\":\"p\",\"pid\":1,\"tid\":%u,"
+                         "\"ts\":%.3f,\"name\":\"overflow prio %u\","
+                         "\"args\":{\"event\":%u}},\n", record->prio_, ts,
+                         record->prio_, record->arg_);
+                break;
+            case TRACE_START:
+                fprintf (out, "{\"ph\":\"B\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,"
+                         "\"name\":\"prio %u\",\"args\":{\"event\":%u",
+                         record->prio_, ts, record->prio_, record->arg_);
+                if (queue->head_ < queue->tail_)
+                {
+                    fprintf (out, ",\"wait_us\":%.3f",
+                             ts - to_us (queue->times_[queue->head_++]));
+                }
+                fprintf (out, "}},\n");
+                open[record->prio_]++;
+                break;
+            case TRACE_END:
+                // The start of the first callback may have been overwritten
+                if (open[record->prio_])
+                {
+                    fprintf (out, "{\"ph\":\"E\",\"pid\":1,\"tid\":%u,\"ts\":%.3f},\n",
+                             record->prio_, ts);
+                    open[record->prio_]--;
+                }
+                break;
+            case TRACE_IDLE:
+                fprintf (out, "{\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":%.3f,"
+                         "\"dur\":%.3f,\"name\":\"idle\"},\n", ts,
+                         (i + 1 < count) ? to_us (records[i + 1].time_) - ts : 0);
+                break;
+            default:
+                fprintf (stderr, "%s: record %u has type %u, skipped\n",
+                         in_path, i, record->type_);
+                break;
+        }
+    }
+    // Close the callbacks still running at the dump
+    for (j = 1; j <= prio_count; j++)
+    {
+        for (; open[j]; open[j]--)
+        {
+            fprintf (out, "{\"ph\":\"E\",\"pid\":1,\"tid\":%u,\"ts\":%.3f},\n", j,
+                     count ? to_us (records[count - 1].time_) : 0);
+        }
+    }
+    // The last entry without a trailing comma
+    fprintf (out, "{\"ph\":\"M\",\"pid\":1,\"name\":\"process_sort_index\","
+             "\"args\":{\"sort_index\":0}}\n]}\n");
+
+    if (out != stdout)
+    {
+        fclose (out);
+    }
+    for (j = 0; j <= prio_count; j++)
+    {
+        free (pending[j].times_);
+    }
+    free (pending);
+    free (open);
+    free (records);
+    free (data);
+
+    return 0;
+}
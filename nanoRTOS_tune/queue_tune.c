@@ -0,0 +1,299 @@
+/*
+ * queue_tune.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: Ehud Frank
+ *
+ * Sizes the task queues from the dumps of nOS_profile_dump (nanoProfile.h).
+ * The length of a priority is the highest peak of all the dumps plus a
+ * margin, at least --min. The header it writes defines
+ * nOS_TASK_QUEUE_LENGTHS, build with -DnOS_QUEUE_LENGTHS_HEADER to use it.
+ * A priority that overflowed in a run has an unknown need, its peak is only
+ * its capacity. It keeps its capacity plus the margin and is reported, grow
+ * its queue and profile again, the exit status is 3 then.
+ * Usage: queue_tune [--margin PCT] [--min N] [-o lengths.h] dump.bin...
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The dump layout of nanoProfile.h, read byte by byte so the host needs
+// neither the kernel configuration nor the byte order of the target
+#define PROFILE_MAGIC       0x51534F6Eu
+#define PROFILE_VERSION     1
+#define PROFILE_HEADER_SIZE 12
+#define PROFILE_ENTRY_SIZE  12
+#define PROFILE_POW2        2   // nOS_TASK_QUEUE_POW2
+#define LENGTH_MAX          65535
+
+// The merged profile of a priority
+typedef struct
+{
+    uint32_t capacity_;
+    uint32_t peak_;
+    uint64_t enqueued_;
+    uint64_t overflows_;
+    uint32_t length_; // The tuned length
+} prio_t;
+
+static int big_endian;
+
+static uint32_t read_u32 (const uint8_t *in)
+{
+    if (big_endian)
+    {
+        return ((uint32_t) in[0] << 24) | ((uint32_t) in[1] << 16)
+                | ((uint32_t) in[2] << 8) | in[3];
+    }
+    return ((uint32_t) in[3] << 24) | ((uint32_t) in[2] << 16)
+            | ((uint32_t) in[1] << 8) | in[0];
+}
+
+static uint16_t read_u16 (const uint8_t *in)
+{
+    if (big_endian)
+    {
+        return (uint16_t) ((in[0] << 8) | in[1]);
+    }
+    return (uint16_t) ((in[1] << 8) | in[0]);
+}
+
+static uint8_t *read_file (const char *path, long *size)
+{
+    FILE *file = fopen (path, "rb");
+    uint8_t *data = NULL;
+
+    if (NULL == file)
+    {
+        return NULL;
+    }
+    if ((0 == fseek (file, 0, SEEK_END)) && ((*size = ftell (file)) >= 0)
+            && (0 == fseek (file, 0, SEEK_SET)))
+    {
+        data = malloc (*size ? *size : 1);
+        if ((NULL != data) && (fread (data, 1, *size, file) != (size_t) *size))
+        {
+            free (data);
+            data = NULL;
+        }
+    }
+    fclose (file);
+
+    return data;
+}
+
+/**
+ * @brief Merges a dump into the profile, the priorities are allocated by the
+ * first dump
+ * @return 0 on success
+ */
+static int merge_dump (const char *path, prio_t **prios, uint32_t *prio_count,
+                       uint8_t *queue_impl)
+{
+    uint8_t *data;
+    long size;
+    uint32_t count;
+    uint32_t i;
+
+    data = read_file (path, &size);
+    if (NULL == data)
+    {
+        perror (path);
+        return 1;
+    }
+    big_endian = 0;
+    if ((size < PROFILE_HEADER_SIZE)
+            || ((PROFILE_MAGIC != read_u32 (data))
+                    && (big_endian = 1, PROFILE_MAGIC != read_u32 (data))))
+    {
+        fprintf (stderr, "%s: not a nanoRTOS queue profile dump\n", path);
+        free (data);
+        return 1;
+    }
+    if ((data[4] < 1) || (data[4] > PROFILE_VERSION)
+            || (PROFILE_ENTRY_SIZE != data[5]))
+    {
+        fprintf (stderr, "%s: unsupported profile version %u\n", path, data[4]);
+        free (data);
+        return 1;
+    }
+    count = read_u16 (data + 6);
+    if ((uint64_t) size < PROFILE_HEADER_SIZE + (uint64_t) count * PROFILE_ENTRY_SIZE)
+    {
+        fprintf (stderr, "%s: truncated, %u priorities expected\n", path, count);
+        free (data);
+        return 1;
+    }
+    if (NULL == *prios)
+    {
+        *prios = calloc (count ? count : 1, sizeof(prio_t));
+        *prio_count = count;
+        *queue_impl = data[8];
+    }
+    else if ((count != *prio_count) || (data[8] != *queue_impl))
+    {
+        fprintf (stderr, "%s: another kernel configuration than the first dump\n",
+                 path);
+        free (data);
+        return 1;
+    }
+    for (i = 0; i < count; i++)
+    {
+        const uint8_t *in = data + PROFILE_HEADER_SIZE + i * PROFILE_ENTRY_SIZE;
+        prio_t *prio = &(*prios)[i];
+        uint32_t peak = read_u16 (in + 2);
+
+        prio->capacity_ = read_u16 (in);
+        if (peak > prio->peak_)
+        {
+            prio->peak_ = peak;
+        }
+        prio->enqueued_ += read_u32 (in + 4);
+        prio->overflows_ += read_u32 (in + 8);
+    }
+    free (data);
+
+    return 0;
+}
+
+/**
+ * @brief Adds the margin to a number of tasks, rounded up
+ */
+static uint32_t add_margin (uint32_t tasks, uint32_t margin)
+{
+    uint64_t length = ((uint64_t) tasks * (100 + margin) + 99) / 100;
+
+    return (length > LENGTH_MAX) ? LENGTH_MAX : (uint32_t) length;
+}
+
+static void print_header (FILE *out, const prio_t *prios, uint32_t prio_count,
+                          uint8_t queue_impl, int dumps, uint32_t margin,
+                          uint32_t min)
+{
+    uint64_t total = 0;
+    uint64_t before = 0;
+    uint32_t i;
+
+    fprintf (out, "/*\n"
+             " * Generated by queue_tune (nanoRTOS_tune) from %d queue profile dump%s,\n"
+             " * a margin of %u%% over the peaks and at least %u task%s per queue.\n"
+             " * Build with -DnOS_QUEUE_LENGTHS_HEADER='\"<this file>\"' to use it.\n",
+             dumps, (dumps > 1) ? "s" : "", margin, min, (min > 1) ? "s" : "");
+    if (PROFILE_POW2 == queue_impl)
+    {
+        fprintf (out, " * nOS_TASK_QUEUE_POW2 rounds the lengths up to powers of 2.\n");
+    }
+    fprintf (out, " */\n\n"
+             "#ifndef NANOQUEUELENGTHS_H_\n"
+             "#define NANOQUEUELENGTHS_H_\n\n"
+             "#define nOS_TASK_QUEUE_LENGTHS(X)\\\n");
+    for (i = 0; i < prio_count; i++)
+    {
+        const prio_t *prio = &prios[i];
+
+        fprintf (out, "    X(%u) /* prio %u, peak %u of %u, %llu posts",
+                 prio->length_, i + 1, prio->peak_, prio->capacity_,
+                 (unsigned long long) prio->enqueued_);
+        if (prio->overflows_)
+        {
+            fprintf (out, ", %llu OVERFLOWS",
+                     (unsigned long long) prio->overflows_);
+        }
+        fprintf (out, " */%s\n", (i + 1 < prio_count) ? "\\" : "");
+        total += prio->length_;
+        before += prio->capacity_;
+    }
+    fprintf (out, "\n// %llu task slots in all, %llu in the profiled build\n\n"
+             "#endif /* NANOQUEUELENGTHS_H_ */\n",
+             (unsigned long long) total, (unsigned long long) before);
+}
+
+int main (int argc, char **argv)
+{
+    const char *out_path = NULL;
+    uint32_t margin = 25;
+    uint32_t min = 1;
+    prio_t *prios = NULL;
+    uint32_t prio_count = 0;
+    uint8_t queue_impl = 0;
+    FILE *out = stdout;
+    int dumps = 0;
+    int overflowed = 0;
+    uint32_t i;
+    int k;
+
+    for (k = 1; k < argc; k++)
+    {
+        if ((0 == strcmp (argv[k], "--margin")) && (k + 1 < argc))
+        {
+            margin = (uint32_t) strtoul (argv[++k], NULL, 0);
+        }
+        else if ((0 == strcmp (argv[k], "--min")) && (k + 1 < argc))
+        {
+            min = (uint32_t) strtoul (argv[++k], NULL, 0);
+        }
+        else if ((0 == strcmp (argv[k], "-o")) && (k + 1 < argc))
+        {
+            out_path = argv[++k];
+        }
+        else if (0 != merge_dump (argv[k], &prios, &prio_count, &queue_impl))
+        {
+            return 1;
+        }
+        else
+        {
+            dumps++;
+        }
+    }
+    if (0 == dumps)
+    {
+        fprintf (stderr, "usage: %s [--margin PCT] [--min N] [-o lengths.h] dump.bin...\n",
+                 argv[0]);
+        return 2;
+    }
+    if (min < 1)
+    {
+        // The kernel needs a queue at every priority
+        min = 1;
+    }
+
+    for (i = 0; i < prio_count; i++)
+    {
+        prio_t *prio = &prios[i];
+
+        if (prio->overflows_)
+        {
+            // The peak hit the capacity, the real need is unknown
+            prio->length_ = add_margin (prio->capacity_, margin);
+            fprintf (stderr, "warning: priority %u overflowed %llu times, "
+                     "its need is above %u, grow it and profile again\n",
+                     i + 1, (unsigned long long) prio->overflows_,
+                     prio->capacity_);
+            overflowed = 1;
+        }
+        else
+        {
+            prio->length_ = add_margin (prio->peak_, margin);
+        }
+        if (prio->length_ < min)
+        {
+            prio->length_ = min;
+        }
+    }
+
+    if (out_path && (NULL == (out = fopen (out_path, "w"))))
+    {
+        perror (out_path);
+        return 1;
+    }
+    print_header (out, prios, prio_count, queue_impl, dumps, margin, min);
+    if (out_path)
+    {
+        fclose (out);
+    }
+    free (prios);
+
+    return overflowed ? 3 : 0;
+}